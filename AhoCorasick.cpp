@@ -0,0 +1,228 @@
+// AhoCorasick.cpp:                                                2024
+// ---------------
+// Aho-Corasick keyword automaton on integer states: trie in CSR form,
+// fail and dictionary links, optional full transition table.
+//======================================================================
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "DFA.h"
+#include "FABuilder.h"
+#include "CompiledNFA.h"
+#include "CompiledDFA.h"
+#include "AhoCorasick.h"
+
+
+AhoCorasick::AhoCorasick(const vector<Tape> &words, Form form)
+: form(form), lengths(words.size()), nClasses(1) {
+
+  // 1. trie with linked lists of children, duplicates of a word are
+  //    chained in order
+  vector<StateId> firstChild{noState}, nextSibling{noState};
+  vector<unsigned char> label{0};
+  wordAt.assign(1, -1);
+  sameWord.assign(words.size(), -1);
+  for (size_t w = 0; w < words.size(); w++) {
+    StateId s = 0;
+    for (unsigned char b: words[w]) {
+      StateId c = firstChild[s];
+      while (c != noState && label[c] != b)
+        c = nextSibling[c];
+      if (c == noState) {
+        c = (StateId)label.size();
+        firstChild.push_back(noState);
+        nextSibling.push_back(firstChild[s]);
+        label.push_back(b);
+        wordAt.push_back(-1);
+        firstChild[s] = c;
+      } // if
+      s = c;
+    } // for
+    lengths[w] = (uint32_t)words[w].length();
+    if (wordAt[s] < 0)
+      wordAt[s] = (int32_t)w;
+    else {
+      int32_t d = wordAt[s];
+      while (sameWord[d] >= 0)
+        d = sameWord[d];
+      sameWord[d] = (int32_t)w;
+    } // if
+  } // for
+  const int n = (int)label.size();
+
+  // 2. goto function in CSR, states renumbered in BFS order (so the
+  //    hot states near the root are contiguous), children sorted by byte
+  rowStart.assign(n + 1, 0);
+  labels.reserve(n - 1);
+  children.reserve(n - 1);
+  vector<StateId> order{0};  // old ids in BFS order
+  order.reserve(n);
+  vector<pair<unsigned char, StateId>> row;
+  for (int i = 0; i < n; i++) {
+    row.clear();
+    for (StateId c = firstChild[order[i]]; c != noState; c = nextSibling[c])
+      row.emplace_back(label[c], c);
+    sort(row.begin(), row.end());
+    for (const auto &lc: row) {
+      labels.push_back(lc.first);
+      children.push_back((StateId)order.size());
+      order.push_back(lc.second);
+    } // for
+    rowStart[i + 1] = (uint32_t)labels.size();
+  } // for
+  vector<int32_t> oldWordAt;
+  oldWordAt.swap(wordAt);
+  wordAt.resize(n);
+  for (int i = 0; i < n; i++)
+    wordAt[i] = oldWordAt[order[i]];
+  vector<StateId>().swap(firstChild);
+  vector<StateId>().swap(nextSibling);
+
+  // 3. fail and dictionary links in BFS order, fail[u] is the goto of
+  //    the first state on the fail path of u's parent with one for b
+  fail.assign(n, 0);
+  dictLink.assign(n, noState);
+  for (StateId s = 0; s < n; s++)
+    for (uint32_t k = rowStart[s]; k < rowStart[s + 1]; k++) {
+      const StateId u = children[k];
+      const unsigned char b = labels[k];
+      if (s != 0) {
+        StateId f = fail[s], d;
+        while ((d = gotoOf(f, b)) == noState && f != 0)
+          f = fail[f];
+        fail[u] = d == noState ? 0 : d;
+      } // if
+      dictLink[u] = wordAt[fail[u]] >= 0 ? fail[u] : dictLink[fail[u]];
+    } // for
+
+  // 4. classes: one per byte of the words, class 0 for all other bytes
+  fill(begin(cls), end(cls), (uint16_t)0);
+  vector<unsigned char> byteOf{0};
+  for (unsigned char b: labels)
+    if (cls[b] == 0) {
+      cls[b] = (uint16_t)nClasses++;
+      byteOf.push_back(b);
+    } // if
+
+  // 5. full table in BFS order, so the row of fail[s] is complete before
+  //    the one of s
+  if (form == Form::full) {
+    table.assign((size_t)n * nClasses, 0);
+    for (StateId s = 0; s < n; s++)
+      for (int c = 1; c < nClasses; c++) {
+        const StateId d = gotoOf(s, byteOf[c]);
+        table[(size_t)s * nClasses + c] =
+          d != noState ? d : s == 0 ? 0 : table[(size_t)fail[s] * nClasses + c];
+      } // for
+  } // if
+} // AhoCorasick::AhoCorasick
+
+
+AhoCorasick::StateId AhoCorasick::gotoOf(StateId s, unsigned char b) const {
+  const unsigned char *first = labels.data() + rowStart[s],
+                      *last  = labels.data() + rowStart[s + 1];
+  const unsigned char *it = lower_bound(first, last, b);
+  return (it != last && *it == b) ? children[it - labels.data()] : noState;
+} // AhoCorasick::gotoOf
+
+size_t AhoCorasick::memoryInBytes() const {
+  return rowStart.size() * sizeof(uint32_t) + labels.size() +
+         (children.size() + fail.size() + dictLink.size()) * sizeof(StateId) +
+         (wordAt.size() + sameWord.size()) * sizeof(int32_t) +
+         lengths.size() * sizeof(uint32_t) + sizeof(cls) +
+         table.size() * sizeof(StateId);
+} // AhoCorasick::memoryInBytes
+
+
+vector<int> AhoCorasick::outputsOf(StateId s) const {
+  vector<int> words;
+  for (StateId t = wordAt[s] >= 0 ? s : dictLink[s]; t != noState; t = dictLink[t])
+    for (int32_t w = wordAt[t]; w >= 0; w = sameWord[w])
+      words.push_back(w);
+  return words;
+} // AhoCorasick::outputsOf
+
+vector<AhoCorasick::Match> AhoCorasick::findAll(TapeView text) const {
+  vector<Match> matches;
+  StateId s = 0;
+  for (size_t i = 0; i <= text.size(); i++) {
+    if (i > 0)
+      s = next(s, (unsigned char)text[i - 1]);
+    if (!hasOutput(s))
+      continue;
+    for (StateId t = wordAt[s] >= 0 ? s : dictLink[s]; t != noState; t = dictLink[t])
+      for (int32_t w = wordAt[t]; w >= 0; w = sameWord[w])
+        matches.push_back({i - lengths[w], i, w});
+  } // for
+  return matches;
+} // AhoCorasick::findAll
+
+bool AhoCorasick::containsAny(TapeView text) const {
+  StateId s = 0;
+  if (hasOutput(s))          // the empty word
+    return true;
+  for (unsigned char b: text)
+    if (hasOutput(s = next(s, b)))
+      return true;
+  return false;
+} // AhoCorasick::containsAny
+
+
+DFA *AhoCorasick::dfaOf() const {
+  vector<State> names(nrOfStates());
+  for (StateId s = 0; s < nrOfStates(); s++)
+    names[s] = to_string(s);
+  vector<unsigned char> bytes;
+  for (int b = 0; b < 256; b++)
+    if (cls[b] != 0) {
+      if (b <= (unsigned char)eps) // neither eot nor eps
+        throw domain_error("AhoCorasick: word with eot or eps");
+      bytes.push_back((unsigned char)b);
+    } // if
+  vector<FABuilder::IdTransition> transitions;
+  transitions.reserve((size_t)nrOfStates() * bytes.size());
+  for (StateId s = 0; s < nrOfStates(); s++)
+    for (unsigned char b: bytes)
+      transitions.push_back({s, (TapeSymbol)b, next(s, b)});
+  FABuilder fab;
+  fab.setStartState(names[0]);
+  for (StateId s = 0; s < nrOfStates(); s++)
+    if (hasOutput(s))
+      fab.addFinalState(names[s]);
+  fab.addTransitions(names, std::move(transitions));
+  return std::move(fab).buildDFA();
+} // AhoCorasick::dfaOf
+
+// via a (deterministic) CompiledNFA, one transition per destination
+//   and state, all bytes not in any word lead to the start state
+CompiledDFA AhoCorasick::compiledOf() const {
+  vector<CompiledNFA::Transition> transitions;
+  vector<CompiledNFA::StateId> finals;
+  for (StateId s = 0; s < nrOfStates(); s++) {
+    if (hasOutput(s))
+      finals.push_back(s);
+    const size_t first = transitions.size();
+    for (int b = 0; b < 256; b++) {
+      const StateId d = cls[b] == 0 ? 0 : next(s, (unsigned char)b);
+      size_t i = first;
+      while (i < transitions.size() && transitions[i].dest != d)
+        i++;
+      if (i == transitions.size())
+        transitions.push_back({s, CompiledNFA::SymbolSet(), d});
+      transitions[i].label.set(b);
+    } // for
+  } // for
+  return CompiledDFA(CompiledNFA(nrOfStates(), 0, finals, std::move(transitions)));
+} // AhoCorasick::compiledOf
+
+
+// end of AhoCorasick.cpp
+//======================================================================
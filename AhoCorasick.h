@@ -0,0 +1,112 @@
+// AhoCorasick.h:                                                  2024
+// -------------
+// AhoCorasick builds the keyword automaton of Aho and Corasick for a
+// list of words (e.g., reserved words or blocklists with 10^5 to 10^6
+// entries) on integer states, without any state names:
+// *  the trie (goto function) is built word by word, then stored in
+//    compressed sparse rows sorted by byte, fail links and dictionary
+//    links (next state on the fail path with a word) follow in one
+//    BFS, so construction is linear in the total length of the words,
+// *  the output set of a state are the words that end there, i.e., its
+//    own word(s) and those along its dictionary links,
+// *  Form::compact keeps the trie and the links only (about 21 bytes
+//    per state), next follows fail links until a goto exists,
+// *  Form::full adds the complete transition table on classes of the
+//    bytes of the words (16 bit class ids, as words may use all 256
+//    bytes next to class 0), so next is one lookup,
+// *  dfaOf and compiledOf deliver the full automaton as DFA (states
+//    named 0, 1, ...) or as CompiledDFA, states with outputs are final.
+//======================================================================
+
+#pragma once
+#ifndef AhoCorasick_h
+#define AhoCorasick_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+
+class DFA;
+class CompiledDFA;
+
+
+class AhoCorasick final
+        /*OC+*/ : private ObjectCounter<AhoCorasick> /*+OC*/ {
+
+  public:
+
+    typedef std::int32_t StateId;
+    static constexpr StateId noState = -1;
+
+    enum class Form { compact, full };
+
+    struct Match {
+      std::size_t start, end;         // [start, end) in the text
+      int         word;               // index in the word list
+    }; // Match
+
+  private:
+
+    Form form;
+    std::vector<std::uint32_t> rowStart;  // CSR of the trie ...
+    std::vector<unsigned char> labels;    // ... sorted bytes and ...
+    std::vector<StateId>       children;  // ... goto destinations
+    std::vector<StateId>       fail;      // longest proper suffix state
+    std::vector<StateId>       dictLink;  // next suffix state with a word
+    std::vector<std::int32_t>  wordAt;    // first word ending here or -1
+    std::vector<std::int32_t>  sameWord;  // next duplicate of a word or -1
+    std::vector<std::uint32_t> lengths;   // of the words
+
+    std::uint16_t        cls[256];        // byte -> class, 0: no word byte
+    int                  nClasses;
+    std::vector<StateId> table;           // Form::full only
+
+    StateId gotoOf(StateId s, unsigned char b) const; // noState if none
+
+  public:
+
+    explicit AhoCorasick(const std::vector<Tape> &words, Form form = Form::full);
+
+    AhoCorasick(const AhoCorasick  &ac) = default;
+    AhoCorasick(      AhoCorasick &&ac) = default;
+
+    ~AhoCorasick() = default;
+
+    Form        formOf()        const { return form; }
+    int         nrOfStates()    const { return (int)fail.size(); }
+    int         nrOfWords()     const { return (int)lengths.size(); }
+    int         nrOfClasses()   const { return nClasses; }
+    std::size_t memoryInBytes() const;
+
+    StateId startState() const { return 0; }
+
+    StateId next(StateId s, unsigned char b) const {
+      if (form == Form::full)
+        return table[(std::size_t)s * nClasses + cls[b]];
+      StateId d;
+      while ((d = gotoOf(s, b)) == noState && s != 0)
+        s = fail[s];
+      return d == noState ? 0 : d;
+    } // next
+
+    bool hasOutput(StateId s) const { return wordAt[s] >= 0 || dictLink[s] != noState; }
+    std::vector<int> outputsOf(StateId s) const; // longest words first
+
+    // all occurrences in the order of their ends, longest first
+    std::vector<Match> findAll(TapeView text) const;
+    bool containsAny(TapeView text) const;
+
+    DFA *dfaOf() const;  // on the bytes of the words, not for eot and eps
+    CompiledDFA compiledOf() const;       // on all 256 bytes, throws
+                                          //   length_error as CompiledNFA
+
+}; // AhoCorasick
+
+
+#endif
+
+// end of AhoCorasick.h
+//======================================================================
@@ -0,0 +1,546 @@
+// CompiledDFA.cpp:                                                2024
+// ---------------
+// CompiledDFA is the table-driven form of a DFA for fast acceptance.
+//======================================================================
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "DFA.h"
+#include "FABuilder.h"
+#include "Hashing.h"
+#include "CompiledNFA.h"
+#include "CompiledDFA.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+CompiledDFA::CompiledDFA(const DFA &dfa, bool names)
+: CompiledDFA(imageOf(dfa, names)) {
+} // CompiledDFA::CompiledDFA
+
+
+shared_ptr<const FAImage> CompiledDFA::imageOf(const DFA &dfa, bool names) {
+
+  const int nS = (int)dfa.S.size();
+  vector<State> stateNames(dfa.S.begin(), dfa.S.end()); // id -> name
+  auto idOfName = [&](const State &s) -> StateId {
+    auto it = lower_bound(stateNames.begin(), stateNames.end(), s);
+    return (it == stateNames.end() || *it != s) ?
+           undef : (StateId)(it - stateNames.begin());
+  }; // idOfName
+
+  // symbols with identical columns form one class, class 0 for the
+  //   column without any transition (incl. all symbols not in V)
+  int nC = 1;
+  map<vector<StateId>, int> classOfColumn;
+  classOfColumn[vector<StateId>(nS, undef)] = 0;
+  vector<unsigned char> classes(256, 0);
+  for (TapeSymbol tSy: dfa.V) {
+    vector<StateId> column(nS);
+    for (StateId s = 0; s < nS; s++)
+      column[s] = idOfName(dfa.delta[stateNames[s]][tSy]);
+    auto ir = classOfColumn.insert(make_pair(column, nC));
+    if (ir.second)
+      nC++;
+    classes[(unsigned char)tSy] = (unsigned char)ir.first->second;
+  } // for
+
+  vector<StateId> dests((size_t)nS * nC, undef);
+  for (const auto &cc: classOfColumn)
+    for (StateId s = 0; s < nS; s++)
+      dests[(size_t)s * nC + cc.second] = cc.first[s];
+  vector<bool> final(nS, false);
+  for (const State &f: dfa.F)
+    final[idOfName(f)] = true;
+
+  return imageOf(nS, nC, idOfName(dfa.s1), classes, dests, final,
+                 names ? &stateNames : nullptr);
+} // CompiledDFA::imageOf
+
+
+shared_ptr<const FAImage> CompiledDFA::imageOf(int nS, int nC, StateId start,
+                                               const vector<unsigned char> &classes,
+                                               const vector<StateId> &dests,
+                                               const vector<bool> &final,
+                                               const vector<State> *names) {
+
+  // 1. accelerated states: at most 3 escape bytes, i.e., bytes that do
+  //    not loop (class 0 included), or a loop scan for many loop bytes
+  //    (not encoded in the table, see accepts)
+  vector<unsigned char> acc((size_t)nS * 4, 0);
+  for (StateId s = 0; s < nS; s++) {
+    unsigned char *a = &acc[(size_t)s * 4];
+    int nLoops = 0;
+    for (int b = 0; b < 256; b++)
+      if (dests[(size_t)s * nC + classes[b]] == s)
+        nLoops++;
+      else if (a[0] < 3)
+        a[1 + a[0]++] = (unsigned char)b;
+      else
+        a[0] = noAccel;
+    if (a[0] == noAccel && nLoops >= minLoopBytes)
+      a[0] = loopScan;
+  } // for
+
+  // 2. fill the table with premultiplied row offsets, encoded for
+  //    accelerated destinations
+  vector<StateId> tbl((size_t)nS * nC, undef);
+  for (size_t i = 0; i < tbl.size(); i++)
+    if (dests[i] != undef)
+      tbl[i] = acc[(size_t)dests[i] * 4] >= loopScan ? dests[i] * nC :
+                                                       -dests[i] * nC - 2;
+
+  // 3. bitmap of final states
+  vector<uint64_t> finals((nS + 63) / 64, 0);
+  for (StateId s = 0; s < nS; s++)
+    if (final[s])
+      finals[s >> 6] |= (uint64_t)1 << (s & 63);
+
+  FAImage::Writer w(FAImage::Header::dfaKind, nS, nC, start);
+  w.addSection(FAImage::Header::classes, classes);
+  w.addSection(FAImage::Header::finals,  finals);
+  w.addSection(FAImage::Header::table,   tbl);
+  w.addSection(FAImage::Header::accel,   acc);
+
+  // 4. optional name table, names in the order of ids
+  if (names != nullptr) {
+    vector<uint32_t> idx;
+    string chars;
+    idx.reserve(nS + 1);
+    for (const State &s: *names) {
+      idx.push_back((uint32_t)chars.size());
+      chars += s;
+    } // for
+    idx.push_back((uint32_t)chars.size());
+    w.addSection(FAImage::Header::nameIdx, idx);
+    w.addSection(FAImage::Header::names, chars.data(), chars.size());
+  } // if
+
+  return w.image();
+} // CompiledDFA::imageOf
+
+
+CompiledDFA::CompiledDFA(const CompiledNFA &cNfa)
+: CompiledDFA(imageOf(cNfa)) {
+} // CompiledDFA::CompiledDFA
+
+
+// one DFA state per reachable epsilon-closed set of NFA states (as
+//   sorted list), the empty set becomes undef, so the DFA is not total
+shared_ptr<const FAImage> CompiledDFA::imageOf(const CompiledNFA &cNfa) {
+  typedef vector<StateId> Set;         // sorted, so cost is per member
+  struct SetHash {
+    size_t operator()(const Set &set) const {
+      return (size_t)fnv1a64(set.data(), set.size() * sizeof(StateId));
+    } // operator()
+  }; // SetHash
+
+  const int nC = cNfa.nrOfClasses();
+  vector<uint64_t> marked((cNfa.nrOfStates() + 63) / 64, 0); // of the set built
+  vector<StateId> stack;
+  auto addWithClosure = [&](Set &set, StateId s) {
+    if ((marked[s >> 6] >> (s & 63)) & 1)
+      return;
+    marked[s >> 6] |= (uint64_t)1 << (s & 63);
+    set.push_back(s);
+    stack.push_back(s);
+    while (!stack.empty()) {
+      const auto ed = cNfa.epsDestsOf(stack.back());
+      stack.pop_back();
+      for (const StateId *d = ed.first; d != ed.second; d++)
+        if (!((marked[*d >> 6] >> (*d & 63)) & 1)) {
+          marked[*d >> 6] |= (uint64_t)1 << (*d & 63);
+          set.push_back(*d);
+          stack.push_back(*d);
+        } // if
+    } // while
+  }; // addWithClosure
+  auto completed = [&marked](Set &set) -> Set && {
+    for (StateId s: set)
+      marked[s >> 6] &= ~((uint64_t)1 << (s & 63));
+    sort(set.begin(), set.end());
+    return std::move(set);
+  }; // completed
+
+  unordered_map<Set, StateId, SetHash> idOfSet;
+  vector<Set> sets;                    // id -> set, in BFS order
+  auto idOf = [&](Set &&set) {
+    auto ir = idOfSet.emplace(set, (StateId)sets.size());
+    if (ir.second)
+      sets.push_back(std::move(set));
+    return ir.first->second;
+  }; // idOf
+
+  Set s0;
+  addWithClosure(s0, cNfa.startState());
+  idOf(completed(s0));
+  vector<StateId> dests;
+  vector<bool>    final;
+  for (size_t i = 0; i < sets.size(); i++) { // sets grows during BFS
+    bool isFinal = false;
+    for (StateId s: sets[i])
+      isFinal = isFinal || cNfa.isFinal(s);
+    final.push_back(isFinal);
+    dests.push_back(undef);            // class 0 without transitions
+    for (int c = 1; c < nC; c++) {
+      Set next;
+      for (StateId s: sets[i]) {
+        const auto ds = cNfa.destsOf(s, c);
+        for (const StateId *d = ds.first; d != ds.second; d++)
+          addWithClosure(next, *d);
+      } // for
+      dests.push_back(next.empty() ? undef : idOf(completed(next)));
+    } // for
+  } // for
+
+  vector<unsigned char> classes(256);
+  for (int c = 0; c < 256; c++)
+    classes[c] = (unsigned char)cNfa.classOf((TapeSymbol)c);
+  return imageOf((int)sets.size(), nC, 0, classes, dests, final, nullptr);
+} // CompiledDFA::imageOf
+
+
+CompiledDFA::CompiledDFA(shared_ptr<const FAImage> img)
+: img(std::move(img)) {
+  const FAImage::Header &h = this->img->header();
+  if (h.kind != FAImage::Header::dfaKind)
+    throw invalid_argument("image does not contain a DFA");
+  nStates   = (int)h.nStates;
+  nClasses  = (int)h.nClasses;
+  start     = h.start;
+  cls       = this->img->section<unsigned char>(FAImage::Header::classes);
+  table     = this->img->section<StateId>      (FAImage::Header::table);
+  finalBits = this->img->section<uint64_t>     (FAImage::Header::finals);
+  accel     = this->img->section<unsigned char>(FAImage::Header::accel);
+  nameIdx   = this->img->section<uint32_t>     (FAImage::Header::nameIdx);
+  nameChars = this->img->section<char>         (FAImage::Header::names);
+  // O(1) plausibility checks only, contents are trusted (cf. checksum)
+  if (h.size[FAImage::Header::classes] != 256 ||
+      h.size[FAImage::Header::table] !=
+        (uint64_t)nStates * nClasses * sizeof(StateId) ||
+      h.size[FAImage::Header::accel] != (uint64_t)nStates * 4 ||
+      h.size[FAImage::Header::finals] !=
+        (uint64_t)(nStates + 63) / 64 * sizeof(uint64_t) ||
+      (nameIdx != nullptr &&
+       h.size[FAImage::Header::nameIdx] != (uint64_t)(nStates + 1) * sizeof(uint32_t)) ||
+      start < 0 || start >= nStates)
+    throw invalid_argument("image of DFA has inconsistent section sizes");
+  if (nameIdx != nullptr && nameChars == nullptr)
+    nameChars = "";          // all names empty, so no names section
+  // offset = s * nClasses = s * d * 2^shift with odd d, and d has an
+  //   inverse modulo 2^32 (Newton iteration, 5 steps for 32 bits)
+  shift = 0;
+  while (((uint32_t)nClasses >> shift & 1) == 0)
+    shift++;
+  const uint32_t d = (uint32_t)nClasses >> shift;
+  inverse = d;
+  for (int i = 0; i < 5; i++)
+    inverse *= 2 - d * inverse;
+} // CompiledDFA::CompiledDFA
+
+
+CompiledDFA CompiledDFA::load(const string &fileName, bool verifyChecksum) {
+  return CompiledDFA(FAImage::load(fileName, verifyChecksum));
+} // CompiledDFA::load
+
+void CompiledDFA::save(const string &fileName) const {
+  img->save(fileName);
+} // CompiledDFA::save
+
+
+State CompiledDFA::nameOf(StateId s) const {
+  if (!hasNames())
+    return to_string(s);
+  return State(nameChars + nameIdx[s], nameIdx[s + 1] - nameIdx[s]);
+} // CompiledDFA::nameOf
+
+CompiledDFA::StateId CompiledDFA::idOf(const State &s) const {
+  if (!hasNames()) {         // names are the ids themselves
+    char *end = nullptr;
+    long id = strtol(s.c_str(), &end, 10);
+    return (s.empty() || *end != '\0' || id < 0 || id >= nStates ||
+            to_string(id) != s) ? undef : (StateId)id;
+  } // if
+  StateId lo = 0, hi = nStates;  // names are sorted, so binary search
+  while (lo < hi) {
+    StateId mid = lo + (hi - lo) / 2;
+    if (string_view(nameChars + nameIdx[mid], nameIdx[mid + 1] - nameIdx[mid]) < s)
+      lo = mid + 1;
+    else
+      hi = mid;
+  } // while
+  return (lo < nStates && nameOf(lo) == s) ? lo : undef;
+} // CompiledDFA::idOf
+
+
+int CompiledDFA::escapesOf(StateId s, unsigned char bytes[3]) const {
+  const unsigned char *a = accel + (size_t)s * 4;
+  if (a[0] == noAccel || a[0] == loopScan)
+    return -1;
+  for (int i = 0; i < a[0]; i++)
+    bytes[i] = a[1 + i];
+  return a[0];
+} // CompiledDFA::escapesOf
+
+int CompiledDFA::nrOfAcceleratedStates() const {
+  int n = 0;
+  for (StateId s = 0; s < nStates; s++)
+    n += accel[(size_t)s * 4] != noAccel;
+  return n;
+} // CompiledDFA::nrOfAcceleratedStates
+
+
+// first of the n (1 .. 3) bytes in [p, end) or end
+static const unsigned char *skipTo(const unsigned char *p, const unsigned char *end,
+                                   const unsigned char *bytes, int n) {
+  if (n == 1) {
+    const void *q = memchr(p, bytes[0], end - p);
+    return q != nullptr ? static_cast<const unsigned char *>(q) : end;
+  } // if
+  const unsigned char b0 = bytes[0], b1 = bytes[1], b2 = bytes[n - 1];
+#ifdef __SSE2__
+  const __m128i v0 = _mm_set1_epi8((char)b0), v1 = _mm_set1_epi8((char)b1),
+                v2 = _mm_set1_epi8((char)b2);
+  for (; end - p >= 16; p += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)p);
+    const int m = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, v0),
+                                                              _mm_cmpeq_epi8(v, v1)),
+                                                 _mm_cmpeq_epi8(v, v2)));
+    if (m != 0)
+      return p + __builtin_ctz(m);
+  } // for
+#endif
+  for (; p != end; p++)
+    if (*p == b0 || *p == b1 || *p == b2)
+      return p;
+  return end;
+} // skipTo
+
+// first byte in [p, end) that does not loop in the row at o, the loads
+//   do not depend on each other, unlike the steps of the table walk
+static const unsigned char *skipLoops(const unsigned char *p, const unsigned char *end,
+                                      const int32_t *row, const unsigned char *cls,
+                                      int32_t self) {
+  while (p != end && row[cls[*p]] == self)
+    p++;
+  return p;
+} // skipLoops
+
+// the inner loop is the plain table walk, it leaves on negative entries
+//   only, i.e., for undef and for accelerated destinations; after a
+//   block of loopBlock bytes that starts and ends in a loop scan state,
+//   the walk tries skipLoops, the gap (in blocks) to the next try is
+//   doubled whenever it skips less than a block and reset otherwise
+bool CompiledDFA::accepts(TapeView tape) const {
+  const unsigned char *p   = (const unsigned char *)tape.data(),
+                      *end = p + tape.size();
+  StateId o = start * nClasses; // offset of row for start state
+  bool skip = accel[(size_t)start * 4] < loopScan;
+  for (;;) {
+    if (skip) {
+      const unsigned char *a = accel + (size_t)stateOf(o) * 4;
+      if (a[0] == 0)            // loops on all bytes
+        return isFinal(stateOf(o));
+      p = skipTo(p, end, a + 1, a[0]);
+    } // if
+    for (int gap = 1, countdown = 1;;) {
+      const unsigned char *stop = end - p > loopBlock ? p + loopBlock : end;
+      const StateId o0 = o;
+      for (; p != stop; p++) {
+        o = table[o + cls[*p]];
+        if (o < 0)
+          break;
+      } // for
+      if (o < 0 || p == end)
+        break;
+      if (--countdown == 0) {
+        const unsigned char *q = p;
+        if (o == o0 && accel[(size_t)stateOf(o) * 4] == loopScan)
+          p = skipLoops(p, end, table + o, cls, o);
+        gap = p - q >= loopBlock ? 1 : min(2 * gap, (int)maxLoopGap);
+        countdown = gap;
+      } // if
+    } // for
+    if (p == end)
+      return isFinal(stateOf(o));
+    if (o == undef)
+      return false;             // undefined, so no acceptance
+    o = -o - 2;                 // accelerated destination
+    p++;
+    skip = true;
+  } // for
+} // CompiledDFA::accepts
+
+size_t CompiledDFA::scan(TapeView tape) const {
+  if (isFinal(start))
+    return 0;
+  const unsigned char *begin = (const unsigned char *)tape.data(),
+                      *p = begin, *end = begin + tape.size();
+  StateId o = start * nClasses;
+  bool skip = accel[(size_t)start * 4] < loopScan;
+  for (;;) {
+    if (skip) {                 // current state is not final
+      const unsigned char *a = accel + (size_t)stateOf(o) * 4;
+      if (a[0] == 0)
+        return npos;
+      p = skipTo(p, end, a + 1, a[0]);
+    } // if
+    for (int gap = 1, countdown = 1;;) { // as in accepts
+      const unsigned char *stop = end - p > loopBlock ? p + loopBlock : end;
+      const StateId o0 = o;
+      for (; p != stop; p++) {
+        o = table[o + cls[*p]];
+        if (o < 0)
+          break;
+        if (isFinal(stateOf(o)))
+          return p - begin + 1;
+      } // for
+      if (o < 0 || p == end)
+        break;
+      if (--countdown == 0) {
+        const unsigned char *q = p;
+        if (o == o0 && accel[(size_t)stateOf(o) * 4] == loopScan)
+          p = skipLoops(p, end, table + o, cls, o);
+        gap = p - q >= loopBlock ? 1 : min(2 * gap, (int)maxLoopGap);
+        countdown = gap;
+      } // if
+    } // for
+    if (p == end || o == undef)
+      return npos;
+    o = -o - 2;
+    p++;
+    if (isFinal(stateOf(o)))
+      return p - begin;
+    skip = true;
+  } // for
+} // CompiledDFA::scan
+
+
+// Moore's refinement on the useful states, i.e., those that reach a
+//   final state, the others are merged into undef
+CompiledDFA CompiledDFA::minimalOf() const {
+  vector<vector<StateId>> pred(nStates);
+  for (StateId s = 0; s < nStates; s++)
+    for (int c = 0; c < nClasses; c++) {
+      const StateId d = destOf(s, c);
+      if (d != undef)
+        pred[d].push_back(s);
+    } // for
+  vector<bool> useful(nStates, false);
+  vector<StateId> queue;
+  for (StateId s = 0; s < nStates; s++)
+    if (isFinal(s)) {
+      useful[s] = true;
+      queue.push_back(s);
+    } // if
+  for (size_t i = 0; i < queue.size(); i++)
+    for (StateId p: pred[queue[i]])
+      if (!useful[p]) {
+        useful[p] = true;
+        queue.push_back(p);
+      } // if
+
+  vector<unsigned char> classes(cls, cls + 256);
+  if (!useful[start])        // empty language
+    return CompiledDFA(imageOf(1, nClasses, 0, classes,
+                               vector<StateId>(nClasses, undef), {false}, nullptr));
+
+  vector<int> block(nStates, -1); // -1 for useless states
+  int nBlocks = 0, blockOfKind[2] = {-1, -1}; // non-final, final
+  for (StateId s = 0; s < nStates; s++)
+    if (useful[s]) {
+      int &b = blockOfKind[isFinal(s)];
+      if (b < 0)
+        b = nBlocks++;
+      block[s] = b;
+    } // if
+  for (;;) {
+    map<vector<int>, int> blockOfSignature;
+    vector<int> newBlock(nStates, -1);
+    vector<int> sig(nClasses + 1);  // block, then the dest. blocks
+    for (StateId s = 0; s < nStates; s++) {
+      if (!useful[s])
+        continue;
+      sig[0] = block[s];
+      for (int c = 0; c < nClasses; c++) {
+        const StateId d = destOf(s, c);
+        sig[c + 1] = d == undef ? -1 : block[d];
+      } // for
+      newBlock[s] = blockOfSignature.emplace(sig, (int)blockOfSignature.size()).first->second;
+    } // for
+    block.swap(newBlock);
+    if ((int)blockOfSignature.size() == nBlocks)
+      break;
+    nBlocks = (int)blockOfSignature.size();
+  } // for
+
+  // quotient, blocks numbered in BFS order from the start block
+  vector<StateId> repOf(nBlocks, undef), idOf(nBlocks, undef);
+  for (StateId s = 0; s < nStates; s++)
+    if (useful[s] && repOf[block[s]] == undef)
+      repOf[block[s]] = s;
+  vector<int> order{block[start]};
+  idOf[block[start]] = 0;
+  vector<StateId> dests;
+  vector<bool> final;
+  for (size_t i = 0; i < order.size(); i++) {
+    const StateId r = repOf[order[i]];
+    final.push_back(isFinal(r));
+    for (int c = 0; c < nClasses; c++) {
+      const StateId d = destOf(r, c);
+      if (d == undef || !useful[d]) {
+        dests.push_back(undef);
+        continue;
+      } // if
+      if (idOf[block[d]] == undef) {
+        idOf[block[d]] = (StateId)order.size();
+        order.push_back(block[d]);
+      } // if
+      dests.push_back(idOf[block[d]]);
+    } // for
+  } // for
+  return CompiledDFA(imageOf((int)order.size(), nClasses, 0, classes, dests, final, nullptr));
+} // CompiledDFA::minimalOf
+
+
+// symbols mapped to class 0 (and states without any transition that are
+//   neither start nor final) cannot be reconstructed, they do not
+//   contribute to the language anyway; eot and eps are in-band markers
+//   of the map-based automata, so transitions for them are impossible
+DFA *CompiledDFA::dfaOf() const {
+  if (cls[(unsigned char)eot] != 0 || cls[(unsigned char)eps] != 0)
+    throw domain_error("transitions for eot or eps have no map-based form");
+  vector<State> name(nStates);
+  for (StateId s = 0; s < nStates; s++)
+    name[s] = nameOf(s);
+  FABuilder fab;
+  fab.setStartState(name[start]);
+  for (StateId s = 0; s < nStates; s++) {
+    if (isFinal(s))
+      fab.addFinalState(name[s]);
+    for (int c = 0; c < 256; c++) {
+      if (cls[c] == 0)
+        continue;
+      const StateId d = next(s, (TapeSymbol)c);
+      if (d != undef)
+        fab.addTransition(name[s], (TapeSymbol)c, name[d]);
+    } // for
+  } // for
+  return std::move(fab).buildDFA();
+} // CompiledDFA::dfaOf
+
+
+// end of CompiledDFA.cpp
+//======================================================================
@@ -0,0 +1,165 @@
+// CompiledDFA.h:                                                  2024
+// -------------
+// CompiledDFA is the table-driven form of a DFA for fast acceptance:
+// *  states are numbered 0, 1, ... in the (lexicographic) order of S,
+//    so the names of the states define the order of the rows,
+// *  tape symbols are mapped to classes of equivalent symbols, class 0
+//    is reserved for all symbols without any transition,
+// *  each entry of the table is the premultiplied offset of the
+//    destination row (dest * nrOfClasses()) or undef,
+// *  states that loop to themselves on all but 1 to 3 escape bytes
+//    (e.g., "inside a comment until *") are accelerated: entries for
+//    them are encoded as -offset - 2, so the hot loop leaves on its
+//    check for undef and skips to the next escape byte with memchr or
+//    SIMD compares, accepts and scan both use this,
+// *  bytes without a transition end a run, so they are escape bytes,
+//    too, and most states of DFAs built from maps (V is a few printable
+//    symbols) have many: states that loop on at least minLoopBytes bytes
+//    keep plain entries, but when a block of loopBlock bytes of the
+//    table walk starts and ends in such a state, the walk continues
+//    with a loop scan, i.e., independent loads of its own row while it
+//    points back to it, which saves the dependency of each step on the
+//    one before; checks that skip less than a block are backed off
+//    exponentially (up to maxLoopGap blocks), so short runs stay in the
+//    table walk at its full speed.
+// Besides DFAs, a CompiledDFA can be built from a CompiledNFA (subset
+// construction on integer ids), so it works on all 256 byte values.
+// All data lives in one (shared, immutable) FAImage, so a CompiledDFA
+// can be saved to and loaded (mmap'd) from a file without any parsing,
+// and copies of it are cheap.
+//======================================================================
+
+#pragma once
+#ifndef CompiledDFA_h
+#define CompiledDFA_h
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "FAImage.h"
+
+class DFA;
+class CompiledNFA;
+
+
+class CompiledDFA final
+        /*OC+*/ : private ObjectCounter<CompiledDFA> /*+OC*/ {
+
+  public:
+
+    typedef std::int32_t StateId;
+    static constexpr StateId undef = -1;         // no transition
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  private:
+
+    std::shared_ptr<const FAImage> img;       // owns all data below
+    int nStates, nClasses;
+    StateId start;                            // start state s1
+    const unsigned char *cls;                 // symbol -> class
+    const StateId       *table;               // aligned to cache lines
+    const std::uint64_t *finalBits;           // bitmap of final states
+    const unsigned char *accel;               // 4 bytes per state
+    const std::uint32_t *nameIdx;             // nullptr for images ...
+    const char          *nameChars;           // ... without names
+    static constexpr unsigned char loopScan = 254, noAccel = 255;
+    static constexpr int minLoopBytes = 16;   // for loopScan
+    static constexpr int loopBlock    = 16;   // bytes walked before a loop scan
+    static constexpr int maxLoopGap   = 64;   // blocks between checks after misses
+    unsigned      shift;                      // offset -> state id ...
+    std::uint32_t inverse;                    // ... without division
+
+    StateId stateOf(StateId offset) const {   // exact for multiples
+      return (StateId)(((std::uint32_t)offset >> shift) * inverse);
+    } // stateOf
+
+    explicit CompiledDFA(std::shared_ptr<const FAImage> img);
+    static std::shared_ptr<const FAImage> imageOf(const DFA &dfa, bool names);
+    static std::shared_ptr<const FAImage> imageOf(const CompiledNFA &cNfa);
+    // dests[s * nClasses + c] is the destination id or undef
+    static std::shared_ptr<const FAImage> imageOf(int nStates, int nClasses, StateId start,
+                                                  const std::vector<unsigned char> &classes,
+                                                  const std::vector<StateId> &dests,
+                                                  const std::vector<bool> &final,
+                                                  const std::vector<State> *names);
+
+  public:
+
+    // names == false omits the state name table from the image
+    explicit CompiledDFA(const DFA &dfa, bool names = true);
+
+    // subset construction, states are numbered in the order of their
+    //   discovery and have no names, the classes are those of cNfa
+    explicit CompiledDFA(const CompiledNFA &cNfa);
+
+    // maps an image file saved before, O(1) unless verifyChecksum
+    static CompiledDFA load(const std::string &fileName,
+                            bool verifyChecksum = false);
+    void save(const std::string &fileName) const;
+
+    CompiledDFA(const CompiledDFA  &cDfa) = default;
+    CompiledDFA(      CompiledDFA &&cDfa) = default;
+
+    ~CompiledDFA() override = default;
+
+    int nrOfStates () const { return nStates;  }
+    int nrOfClasses() const { return nClasses; }
+
+    StateId startState() const { return start; }
+
+    int classOf(TapeSymbol tSy) const {
+      return cls[(unsigned char)tSy];
+    } // classOf
+
+    StateId destOf(StateId s, int c) const {  // undef for no trans.
+      StateId o = table[s * nClasses + c];
+      return o >= 0 ? stateOf(o) : o == undef ? undef : stateOf(-o - 2);
+    } // destOf
+
+    StateId next(StateId s, TapeSymbol tSy) const {
+      return destOf(s, classOf(tSy));
+    } // next
+
+    bool isFinal(StateId s) const {
+      return (finalBits[s >> 6] >> (s & 63)) & 1;
+    } // isFinal
+
+    // escape bytes of accelerated states, nr. of them (0 .. 3) or -1
+    //   (for states with a loop scan, too)
+    int escapesOf(StateId s, unsigned char bytes[3]) const;
+    int nrOfAcceleratedStates() const;
+
+    bool hasNames() const { return nameIdx != nullptr; }
+    StateId idOf(const State &s) const;       // undef for unknown names
+    State nameOf(StateId s) const;            // id as name without names
+
+    size_t tableBytes() const { return (size_t)nStates * nClasses * sizeof(StateId); }
+    const FAImage &image() const { return *img; }
+
+    bool accepts(TapeView tape) const;        // all 256 byte values
+
+    // end of the shortest prefix of tape that leads to a final state,
+    //   npos if there is none, so for a DFA of .*P the end of the first
+    //   match of P
+    std::size_t scan(TapeView tape) const;
+
+    // without useless states (undef instead) and equivalent states,
+    //   states numbered in BFS order, without names
+    CompiledDFA minimalOf() const;
+
+    DFA *dfaOf() const;                       // back to the map-based form,
+                                              //   not for eot and eps
+
+}; // CompiledDFA
+
+
+#endif
+
+// end of CompiledDFA.h
+//======================================================================
@@ -0,0 +1,324 @@
+// CompiledNFA.cpp:                                                2024
+// ---------------
+// CompiledNFA is the array-based form of an NFA for fast acceptance.
+//======================================================================
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "DeltaStuff.h"
+#include "FA.h"
+#include "DFA.h"
+#include "NFA.h"
+#include "FABuilder.h"
+#include "CompiledNFA.h"
+
+
+CompiledNFA::CompiledNFA(const NFA &nfa, bool names)
+: CompiledNFA(imageOf(nfa, nfa.delta, names)) {
+} // CompiledNFA::CompiledNFA
+
+CompiledNFA::CompiledNFA(const DFA &dfa, bool names)
+: CompiledNFA(imageOf(dfa, nDeltaOf(dfa.delta), names)) {
+} // CompiledNFA::CompiledNFA
+
+
+CompiledNFA::CompiledNFA(int nStates, StateId start, const vector<StateId> &finals,
+                         vector<Transition> transitions)
+: CompiledNFA(imageOf(nStates, start, finals, std::move(transitions), nullptr)) {
+} // CompiledNFA::CompiledNFA
+
+
+shared_ptr<const FAImage> CompiledNFA::imageOf(const FA &fa,
+                                               const NDelta &delta, bool names) {
+  vector<State> stateNames(fa.S.begin(), fa.S.end()); // id -> name
+  auto idOfName = [&](const State &s) -> StateId {
+    auto it = lower_bound(stateNames.begin(), stateNames.end(), s);
+    return (it == stateNames.end() || *it != s) ?
+           undef : (StateId)(it - stateNames.begin());
+  }; // idOfName
+
+  vector<Transition> transitions;
+  for (const auto &row: delta) {
+    const StateId src = idOfName(row.first);
+    for (const auto &e: row.second) {
+      SymbolSet label;
+      if (e.first != eps)
+        label.set((unsigned char)e.first);
+      for (const State &d: e.second)
+        transitions.push_back({src, label, idOfName(d)});
+    } // for
+  } // for
+  vector<StateId> finals;
+  for (const State &f: fa.F)
+    finals.push_back(idOfName(f));
+
+  return imageOf((int)stateNames.size(), idOfName(fa.s1), finals,
+                 std::move(transitions), names ? &stateNames : nullptr);
+} // CompiledNFA::imageOf
+
+
+shared_ptr<const FAImage> CompiledNFA::imageOf(int nS, StateId start,
+                                               const vector<StateId> &finalIds,
+                                               vector<Transition> transitions,
+                                               const vector<State> *names) {
+
+  // 1. one transition per (src, dest) and symbol set, epsilons apart
+  vector<vector<StateId>> epsOf(nS);
+  sort(transitions.begin(), transitions.end(),
+       [](const Transition &t1, const Transition &t2) {
+         return t1.src != t2.src ? t1.src < t2.src : t1.dest < t2.dest;
+       });
+  vector<Transition> ts;
+  for (const Transition &t: transitions) {
+    if (t.label.none()) {
+      if (epsOf[t.src].empty() || epsOf[t.src].back() != t.dest)
+        epsOf[t.src].push_back(t.dest);
+    } else if (!ts.empty() && ts.back().src == t.src && ts.back().dest == t.dest)
+      ts.back().label |= t.label;
+    else
+      ts.push_back(t);
+  } // for
+  transitions.clear();
+
+  // 2. classes: symbols with identical columns, i.e., contained in the
+  //    same labels, by refinement over the distinct labels, then class 0
+  //    for the symbols without any transition
+  vector<int> part(256, 0);
+  SymbolSet used;
+  {
+    unordered_set<SymbolSet> labels;
+    for (const Transition &t: ts)
+      if (labels.insert(t.label).second) {
+        used |= t.label;
+        map<pair<int, bool>, int> refined;
+        for (int c = 0; c < 256; c++)
+          part[c] = refined.emplace(make_pair(part[c], (bool)t.label[c]),
+                                    (int)refined.size()).first->second;
+      } // if
+  }
+  int nC = 1;
+  vector<unsigned char> classes(256, 0);
+  vector<int> classOfPart(257, -1), repOf(1, -1); // representative symbols
+  for (int c = 0; c < 256; c++)
+    if (used[c]) {
+      int &cc = classOfPart[part[c]];
+      if (cc < 0) {
+        cc = nC++;
+        repOf.push_back(c);
+      } // if
+      classes[c] = (unsigned char)cc;
+    } // if
+  if (nC > 256)              // all 256 symbols in classes of their own
+    throw length_error("CompiledNFA: more than 255 classes of symbols");
+
+  // 3. CSR for symbol transitions, rows in order (state, class)
+  vector<uint32_t> rows;
+  vector<StateId>  ds;
+  rows.reserve((size_t)nS * nC + 1);
+  vector<vector<StateId>> bucket(nC);
+  size_t i = 0;
+  for (StateId s = 0; s < nS; s++) {
+    for (; i < ts.size() && ts[i].src == s; i++) // dests ascending
+      for (int c = 1; c < nC; c++)
+        if (ts[i].label[repOf[c]])
+          bucket[c].push_back(ts[i].dest);
+    for (int c = 0; c < nC; c++) {
+      rows.push_back((uint32_t)ds.size());
+      ds.insert(ds.end(), bucket[c].begin(), bucket[c].end());
+      bucket[c].clear();
+    } // for
+  } // for
+  rows.push_back((uint32_t)ds.size());
+
+  // 4. CSR for epsilon transitions
+  vector<uint32_t> epsRows;
+  vector<StateId>  epsDs;
+  epsRows.reserve(nS + 1);
+  for (StateId s = 0; s < nS; s++) {
+    epsRows.push_back((uint32_t)epsDs.size());
+    epsDs.insert(epsDs.end(), epsOf[s].begin(), epsOf[s].end());
+  } // for
+  epsRows.push_back((uint32_t)epsDs.size());
+
+  // 5. bitmap of final states
+  vector<uint64_t> finals((nS + 63) / 64, 0);
+  for (StateId s: finalIds)
+    finals[s >> 6] |= (uint64_t)1 << (s & 63);
+
+  FAImage::Writer w(FAImage::Header::nfaKind, nS, nC, start);
+  w.addSection(FAImage::Header::classes,  classes);
+  w.addSection(FAImage::Header::finals,   finals);
+  w.addSection(FAImage::Header::rowStart, rows);
+  w.addSection(FAImage::Header::dests,    ds);
+  w.addSection(FAImage::Header::epsStart, epsRows);
+  w.addSection(FAImage::Header::epsDests, epsDs);
+
+  // 6. optional name table, names in the order of ids
+  if (names != nullptr) {
+    vector<uint32_t> idx;
+    string chars;
+    idx.reserve(nS + 1);
+    for (const State &s: *names) {
+      idx.push_back((uint32_t)chars.size());
+      chars += s;
+    } // for
+    idx.push_back((uint32_t)chars.size());
+    w.addSection(FAImage::Header::nameIdx, idx);
+    w.addSection(FAImage::Header::names, chars.data(), chars.size());
+  } // if
+
+  return w.image();
+} // CompiledNFA::imageOf
+
+
+CompiledNFA::CompiledNFA(shared_ptr<const FAImage> img)
+: img(std::move(img)) {
+  const FAImage::Header &h = this->img->header();
+  if (h.kind != FAImage::Header::nfaKind)
+    throw invalid_argument("image does not contain an NFA");
+  nStates   = (int)h.nStates;
+  nClasses  = (int)h.nClasses;
+  start     = h.start;
+  cls       = this->img->section<unsigned char>(FAImage::Header::classes);
+  rowStart  = this->img->section<uint32_t>     (FAImage::Header::rowStart);
+  dests     = this->img->section<StateId>      (FAImage::Header::dests);
+  epsStart  = this->img->section<uint32_t>     (FAImage::Header::epsStart);
+  epsDests  = this->img->section<StateId>      (FAImage::Header::epsDests);
+  finalBits = this->img->section<uint64_t>     (FAImage::Header::finals);
+  nameIdx   = this->img->section<uint32_t>     (FAImage::Header::nameIdx);
+  nameChars = this->img->section<char>         (FAImage::Header::names);
+  // O(1) plausibility checks only, contents are trusted (cf. checksum)
+  if (h.size[FAImage::Header::classes] != 256 ||
+      h.size[FAImage::Header::rowStart] !=
+        ((uint64_t)nStates * nClasses + 1) * sizeof(uint32_t) ||
+      h.size[FAImage::Header::epsStart] != (uint64_t)(nStates + 1) * sizeof(uint32_t) ||
+      h.size[FAImage::Header::finals] !=
+        (uint64_t)(nStates + 63) / 64 * sizeof(uint64_t) ||
+      h.size[FAImage::Header::dests] !=
+        (uint64_t)rowStart[(size_t)nStates * nClasses] * sizeof(StateId) ||
+      h.size[FAImage::Header::epsDests] !=
+        (uint64_t)epsStart[nStates] * sizeof(StateId) ||
+      (nameIdx != nullptr &&
+       h.size[FAImage::Header::nameIdx] != (uint64_t)(nStates + 1) * sizeof(uint32_t)) ||
+      start < 0 || start >= nStates)
+    throw invalid_argument("image of NFA has inconsistent section sizes");
+  if (nameIdx != nullptr && nameChars == nullptr)
+    nameChars = "";          // all names empty, so no names section
+} // CompiledNFA::CompiledNFA
+
+
+CompiledNFA CompiledNFA::load(const string &fileName, bool verifyChecksum) {
+  return CompiledNFA(FAImage::load(fileName, verifyChecksum));
+} // CompiledNFA::load
+
+void CompiledNFA::save(const string &fileName) const {
+  img->save(fileName);
+} // CompiledNFA::save
+
+
+State CompiledNFA::nameOf(StateId s) const {
+  if (!hasNames())
+    return to_string(s);
+  return State(nameChars + nameIdx[s], nameIdx[s + 1] - nameIdx[s]);
+} // CompiledNFA::nameOf
+
+
+static inline int lowestBitOf(uint64_t bits) { // requires: bits != 0
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(bits);
+#else
+  int i = 0;
+  while (!((bits >> i) & 1))
+    i++;
+  return i;
+#endif
+} // lowestBitOf
+
+// adds s and all states reachable from s via epsilon transitions to set
+void CompiledNFA::addWithClosure(uint64_t *set, StateId s,
+                                 vector<StateId> &stack) const {
+  if ((set[s >> 6] >> (s & 63)) & 1)
+    return;
+  set[s >> 6] |= (uint64_t)1 << (s & 63);
+  stack.push_back(s);
+  while (!stack.empty()) {
+    StateId t = stack.back();
+    stack.pop_back();
+    for (uint32_t i = epsStart[t]; i < epsStart[t + 1]; i++) {
+      StateId d = epsDests[i];
+      if (!((set[d >> 6] >> (d & 63)) & 1)) {
+        set[d >> 6] |= (uint64_t)1 << (d & 63);
+        stack.push_back(d);
+      } // if
+    } // for
+  } // while
+} // CompiledNFA::addWithClosure
+
+
+bool CompiledNFA::accepts(TapeView tape) const {
+  const size_t nWords = (nStates + 63) / 64;
+  vector<uint64_t> cur(nWords, 0), nxt(nWords, 0);
+  vector<StateId> stack;
+  addWithClosure(cur.data(), start, stack);
+  for (const char *p = tape.data(), *end = p + tape.size(); p != end; p++) {
+    const int c = cls[(unsigned char)*p];
+    if (c == 0)
+      return false;          // no transition for this symbol at all
+    fill(nxt.begin(), nxt.end(), 0);
+    bool any = false;
+    for (size_t w = 0; w < nWords; w++)
+      for (uint64_t bits = cur[w]; bits != 0; bits &= bits - 1) {
+        const StateId s = (StateId)(w * 64 + lowestBitOf(bits));
+        const size_t row = (size_t)s * nClasses + c;
+        for (uint32_t i = rowStart[row]; i < rowStart[row + 1]; i++) {
+          addWithClosure(nxt.data(), dests[i], stack);
+          any = true;
+        } // for
+      } // for
+    if (!any)
+      return false;          // no more active states
+    cur.swap(nxt);
+  } // for
+  for (size_t w = 0; w < nWords; w++)
+    if (cur[w] & finalBits[w])
+      return true;
+  return false;
+} // CompiledNFA::accepts
+
+
+// as CompiledDFA::dfaOf, not for transitions on eot and eps
+NFA *CompiledNFA::nfaOf() const {
+  if (cls[(unsigned char)eot] != 0 || cls[(unsigned char)eps] != 0)
+    throw domain_error("transitions for eot or eps have no map-based form");
+  vector<State> name(nStates);
+  for (StateId s = 0; s < nStates; s++)
+    name[s] = nameOf(s);
+  FABuilder fab;
+  fab.setStartState(name[start]);
+  for (StateId s = 0; s < nStates; s++) {
+    if (isFinal(s))
+      fab.addFinalState(name[s]);
+    for (uint32_t i = epsStart[s]; i < epsStart[s + 1]; i++)
+      fab.addTransition(name[s], eps, name[epsDests[i]]);
+    for (int c = 1; c < 256; c++) {
+      if (cls[c] == 0)
+        continue;
+      const size_t row = (size_t)s * nClasses + cls[c];
+      for (uint32_t i = rowStart[row]; i < rowStart[row + 1]; i++)
+        fab.addTransition(name[s], (TapeSymbol)c, name[dests[i]]);
+    } // for
+  } // for
+  return std::move(fab).buildNFA();
+} // CompiledNFA::nfaOf
+
+
+// end of CompiledNFA.cpp
+//======================================================================
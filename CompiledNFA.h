@@ -0,0 +1,139 @@
+// CompiledNFA.h:                                                  2024
+// -------------
+// CompiledNFA is the array-based form of an NFA for fast acceptance:
+// *  states are numbered 0, 1, ... in the (lexicographic) order of S,
+// *  tape symbols are mapped to classes as in CompiledDFA,
+// *  the destinations for (state, class) and the epsilon destinations
+//    of each state are stored in compressed sparse rows (CSR),
+// *  acceptance simulates the NFA on bitsets of states.
+// Besides NFAs and DFAs, a CompiledNFA can be built directly from
+// transitions on integer ids labelled with symbol sets (e.g., by Regex),
+// so no state names are created at all; then all 256 byte values are
+// tape symbols, as epsilon transitions have empty labels (but at most
+// 255 classes of them, else the constructor throws length_error).
+// As CompiledDFA, all data lives in one shared immutable FAImage.
+//======================================================================
+
+#pragma once
+#ifndef CompiledNFA_h
+#define CompiledNFA_h
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "DeltaStuff.h"
+#include "FAImage.h"
+
+class FA;
+class DFA;
+class NFA;
+
+
+class CompiledNFA final
+        /*OC+*/ : private ObjectCounter<CompiledNFA> /*+OC*/ {
+
+  public:
+
+    typedef std::int32_t StateId;
+    static constexpr StateId undef = -1;
+
+    typedef std::bitset<256> SymbolSet;    // indexed by (unsigned char)
+
+    // transition on each symbol of label, epsilon transition for an
+    //   empty label
+    struct Transition {
+      StateId   src;
+      SymbolSet label;
+      StateId   dest;
+    }; // Transition
+
+  private:
+
+    std::shared_ptr<const FAImage> img;       // owns all data below
+    int nStates, nClasses;
+    StateId start;
+    const unsigned char *cls;                 // symbol -> class
+    const std::uint32_t *rowStart;            // CSR for (state, class) ...
+    const StateId       *dests;               // ... destinations
+    const std::uint32_t *epsStart;            // CSR for epsilon ...
+    const StateId       *epsDests;            // ... destinations
+    const std::uint64_t *finalBits;
+    const std::uint32_t *nameIdx;             // nullptr for images ...
+    const char          *nameChars;           // ... without names
+
+    explicit CompiledNFA(std::shared_ptr<const FAImage> img);
+    static std::shared_ptr<const FAImage> imageOf(const FA &fa,
+                                                  const NDelta &delta, bool names);
+    static std::shared_ptr<const FAImage> imageOf(int nStates, StateId start,
+                                                  const std::vector<StateId> &finals,
+                                                  std::vector<Transition> transitions,
+                                                  const std::vector<State> *names);
+
+    void addWithClosure(std::uint64_t *set, StateId s,
+                        std::vector<StateId> &stack) const;
+
+  public:
+
+    explicit CompiledNFA(const NFA &nfa, bool names = true);
+    explicit CompiledNFA(const DFA &dfa, bool names = true); // DFA as NFA
+
+    // states 0 .. nStates - 1, without names
+    CompiledNFA(int nStates, StateId start, const std::vector<StateId> &finals,
+                std::vector<Transition> transitions);
+
+    static CompiledNFA load(const std::string &fileName,
+                            bool verifyChecksum = false);
+    void save(const std::string &fileName) const;
+
+    CompiledNFA(const CompiledNFA  &cNfa) = default;
+    CompiledNFA(      CompiledNFA &&cNfa) = default;
+
+    ~CompiledNFA() = default;
+
+    int nrOfStates () const { return nStates;  }
+    int nrOfClasses() const { return nClasses; }
+
+    StateId startState() const { return start; }
+
+    int classOf(TapeSymbol tSy) const {
+      return cls[(unsigned char)tSy];
+    } // classOf
+
+    bool isFinal(StateId s) const {
+      return (finalBits[s >> 6] >> (s & 63)) & 1;
+    } // isFinal
+
+    // destinations as range [first, second) of ids
+    std::pair<const StateId *, const StateId *> destsOf(StateId s, int c) const {
+      const size_t row = (size_t)s * nClasses + c;
+      return {dests + rowStart[row], dests + rowStart[row + 1]};
+    } // destsOf
+
+    std::pair<const StateId *, const StateId *> epsDestsOf(StateId s) const {
+      return {epsDests + epsStart[s], epsDests + epsStart[s + 1]};
+    } // epsDestsOf
+
+    bool hasNames() const { return nameIdx != nullptr; }
+    State nameOf(StateId s) const;            // id as name without names
+
+    const FAImage &image() const { return *img; }
+
+    bool accepts(TapeView tape) const;        // all 256 byte values
+
+    NFA *nfaOf() const;                       // back to the map-based form,
+                                              //   not for eot and eps
+
+}; // CompiledNFA
+
+
+#endif
+
+// end of CompiledNFA.h
+//======================================================================
@@ -3,13 +3,18 @@
 // Objects of class DFA represent deterministic finite automata.
 //======================================================================
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <memory>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 using namespace std;
 
@@ -17,6 +22,8 @@ using namespace std;
 #include "StateStuff.h"
 #include "MbMatrix.h"
 #include "FABuilder.h"
+#include "FAProfile.h"
+#include "CompiledDFA.h"
 #include "DFA.h"
 
 
@@ -44,10 +51,11 @@ static void printNeTable(const StateSet &S, const NeTable &ne) {
 
 // --- implementation of class DFA ---
 
-DFA::DFA(const StateSet &S,  const TapeSymbolSet &V,
-         const State    &s1, const StateSet      &F,
-         const DDelta   &delta)
-: FA(S, V, s1, F), delta(delta) {
+DFA::DFA(StateSet S,  TapeSymbolSet V,
+         State    s1, StateSet      F,
+         DDelta   delta)
+: FA(std::move(S), std::move(V), std::move(s1), std::move(F)),
+  deltaPtr(make_shared<const DDelta>(std::move(delta))), delta(*deltaPtr) {
 } // DFA::DFA
 
 
@@ -74,6 +82,29 @@ bool DFA::accepts(const Tape &tape) const {
   return F.contains(s);     // accepted <==> s element of F
 } // DFA::accepts
 
+bool DFA::accepts(const Tape &tape, FAProfiler &profiler) const {
+  FAProfiler::Counters &cnt = profiler.localCounters(); // no contention
+  cnt.runStarted();
+  int        i   = 0;
+  TapeSymbol tSy = tape[i];
+  int        row = profiler.startRowOf(); // rows instead of state names
+  cnt.stateEntered(row);
+  while (tSy != eot) {
+    const int col = profiler.colOf(tSy);
+    if (col < 0)
+      return false;
+    const auto dr = profiler.destRowsOf(row, col);
+    if (dr.first == dr.second)
+      return false;
+    cnt.transitionFired(row, col);
+    row = *dr.first;
+    cnt.stateEntered(row);
+    i++;
+    tSy = tape[i];
+  } // while
+  return profiler.isFinalRow(row);
+} // DFA::accepts
+
 void DFA::onStateEntered(const State &s) const {
   // nothing to do
 } // DFA::onStateEntered
@@ -182,7 +213,7 @@ DFA *DFA::minimalOf() const {
       if (subset.contains(f))
         fab.addFinalState(subset.stateOf());
 
-  return fab.buildDFA();
+  return std::move(fab).buildDFA();
 }
 
 
@@ -211,10 +242,120 @@ DFA *DFA::renamedOf() const {
   for (const State &f: F)
     fab.addFinalState(newName[f]);
 
-  return fab.buildDFA();
+  return std::move(fab).buildDFA();
 
 } // DFA:renamedOf
 
 
+// Profile-guided renumbering: hot states first, unvisited ones in
+// topological order at the end, so names define the row order of a
+// CompiledDFA and the hot rows share as few cache lines as possible.
+
+DFA *DFA::renumberedOf(const FAProfile &profile) const {
+
+  // 1. order states by decreasing visits, ties in topological order
+
+  vector<State> tss = FA::topSortedStates();
+  stable_sort(tss.begin(), tss.end(),
+    [&profile](const State &a, const State &b) {
+      return profile.visitsOf(a) > profile.visitsOf(b);
+    });
+  size_t digits = to_string(tss.size() - 1).length();
+  map<State, State> newName; // map: old name -> new name ("0", "1", ...)
+  for (size_t i = 0; i < tss.size(); i++) {
+    string nn = to_string(i);
+    nn.insert(0, string(digits - nn.length(), '0')); // lexic. = numeric order
+    newName[tss[i]] = nn;
+  } // for
+
+  // 2. build new automaton, only names change, so the language is the same
+
+  FABuilder fab;
+  for (auto &t: delta.transitions())
+    if (newName.count(t.src) > 0) // unreachable states are dropped
+      fab.addTransition(newName[t.src], t.tSy, newName[t.dest]);
+  fab.setStartState(newName[s1]);
+  for (const State &f: F)
+    if (newName.count(f) > 0)
+      fab.addFinalState(newName[f]);
+
+  return std::move(fab).buildDFA();
+} // DFA::renumberedOf
+
+DFA *DFA::renumberedOf(const vector<Tape> &trainingTapes) const {
+  FAProfiler profiler(*this);
+  for (const Tape &tape: trainingTapes)
+    accepts(tape, profiler);
+  return renumberedOf(profiler.profile());
+} // DFA::renumberedOf
+
+
+vector<State> DFA::bfsOrderedStates() const {
+  vector<State> order{s1};
+  unordered_set<State> visited{s1};
+  for (size_t i = 0; i < order.size(); i++) { // order is the BFS queue
+    auto row = delta.find(order[i]);
+    if (row == delta.end())
+      continue;
+    for (const auto &e: row->second)           // in symbol order
+      if (visited.insert(e.second).second)
+        order.push_back(e.second);
+  } // for
+  return order;
+} // DFA::bfsOrderedStates
+
+DFA *DFA::canonicalOf() const {
+  vector<State> order = bfsOrderedStates();
+  int digits = (int)to_string(order.size() - 1).length();
+  unordered_map<State, State> newName;
+  for (size_t i = 0; i < order.size(); i++) {
+    string nn = to_string(i);
+    nn.insert(0, string(digits - nn.length(), '0'));
+    newName[order[i]] = nn;
+  } // for
+
+  FABuilder fab;
+  fab.setStartState(newName[s1]);
+  for (const State &s: order) {
+    auto row = delta.find(s);
+    if (row != delta.end())
+      for (const auto &e: row->second)
+        fab.addTransition(newName[s], e.first, newName[e.second]);
+    if (F.contains(s))
+      fab.addFinalState(newName[s]);
+  } // for
+  return std::move(fab).buildDFA();
+} // DFA::canonicalOf
+
+Fingerprint DFA::fingerprint() const {
+  vector<State> order = bfsOrderedStates();
+  unordered_map<State, uint64_t> nr;
+  nr.reserve(order.size());
+  for (size_t i = 0; i < order.size(); i++)
+    nr[order[i]] = i;
+
+  FingerprintBuilder fpb;
+  fpb.add((uint64_t)order.size());
+  for (const State &s: order) {
+    auto row = delta.find(s);
+    const size_t nTrans = (row == delta.end()) ? 0 : row->second.size();
+    fpb.add(((uint64_t)nTrans << 1) | (F.contains(s) ? 1 : 0));
+    if (nTrans > 0)
+      for (const auto &e: row->second)
+        fpb.add(((uint64_t)(unsigned char)e.first << 56) | nr[e.second]);
+  } // for
+  return fpb.result();
+} // DFA::fingerprint
+
+
+void DFA::save(const string &fileName, bool names) const {
+  CompiledDFA(*this, names).save(fileName);
+} // DFA::save
+
+DFA *DFA::load(const string &fileName) {
+  return CompiledDFA::load(fileName).dfaOf();
+} // DFA::load
+
+
 // end of DFA.cpp
 //======================================================================
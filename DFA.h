@@ -7,31 +7,44 @@
 #ifndef DFA_h
 #define DFA_h
 
+#include <vector>
+
 #include "ObjectCounter.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
 #include "FA.h"
+#include "Hashing.h"
 
 class FABuilder;           // forward for friend declaration only
+class FAProfiler;          // forward for profiling of accepts only
+class FAProfile;
 
 class DFA: public  FA, ObjectCounter<DFA> {
 
   friend class FABuilder;  // so FABuilder::build... methods can call prot. constr.
+  friend class LazyDFA;    // LazyDFA::dfaOf of {eps}, FABuilder rejects an empty delta
 
   typedef FA Base;
 
   protected: // allows derived classes, e.g., for Mealy and or Moore
 
     // constructor called by FABuilder::build... methods and derived classes
-    DFA(const StateSet &S,  const TapeSymbolSet &V,
-        const State    &s1, const StateSet      &F,
-        const DDelta   &delta);
+    DFA(StateSet S,  TapeSymbolSet V,
+        State    s1, StateSet      F,
+        DDelta   delta);
 
     StateSet deltaAt(const State &src, TapeSymbol tSy) const override;
 
+  private:
+
+    std::shared_ptr<const DDelta> deltaPtr; // shared by all copies
+
+    // reachable states in BFS order from s1, successors in symbol order
+    std::vector<State> bfsOrderedStates() const;
+
   public:
 
-    const DDelta delta;    // deterministic transition function
+    const DDelta &delta;   // deterministic transition function
 
     DFA(const DFA  &dfa) = default;
     DFA(      DFA &&dfa) = default;
@@ -39,12 +52,31 @@ class DFA: public  FA, ObjectCounter<DFA> {
     ~DFA() override = default;
 
     bool accepts(const Tape &tape) const override; // impl. of abstr. meth.
+    bool accepts(const Tape &tape, FAProfiler &profiler) const; // opt-in profiling
     virtual void onStateEntered(const State &s) const; // hook for derived classes
 
     DFA *minimalOf() const; // minimization: DFA => minimal DFA
 
     DFA *renamedOf() const; // equiv. automation with states named 0, 1, ...
 
+    // equiv. automaton with states named 0, 1, ... in order of decreasing
+    //   hotness, so the hot rows of a CompiledDFA are contiguous
+    DFA *renumberedOf(const FAProfile &profile) const;
+    DFA *renumberedOf(const std::vector<Tape> &trainingTapes) const;
+
+    // canonical form: reachable states only, named 0, 1, ... in BFS order
+    //   from s1 with successors in symbol order, so DFAs that are equal up
+    //   to renaming of states have identical canonical forms
+    DFA *canonicalOf() const;
+
+    // 128 bit hash of the canonical form in O(|S| + |delta|), equal for
+    //   DFAs that are equal up to renaming (and unreachable states)
+    Fingerprint fingerprint() const;
+
+    // binary image (cf. FAImage) of the compiled form, for fast loading
+    void save(const std::string &fileName, bool names = true) const;
+    static DFA *load(const std::string &fileName); // in compiled form: CompiledDFA::load
+
 }; // DFA
 
 #endif
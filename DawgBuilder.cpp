@@ -0,0 +1,244 @@
+// DawgBuilder.cpp:                                                2024
+// ---------------
+// Incremental construction of minimal acyclic DFAs (DAWGs) from sorted
+// or unsorted words with a register of equivalent states.
+//======================================================================
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "Hashing.h"
+#include "DFA.h"
+#include "FABuilder.h"
+#include "CompiledNFA.h"
+#include "CompiledDFA.h"
+#include "DawgBuilder.h"
+
+
+// equivalent states of a minimal acyclic DFA have equal finality and
+//   equal transitions, as their destinations are unique already
+size_t DawgBuilder::NodeHash::operator()(StateId s) const {
+  const Node &n = db->nodes[s];
+  uint64_t h = fnv1a64(&n.final, sizeof(n.final));
+  for (const auto &t: n.out) {
+    h = fnv1a64(&t.first,  sizeof(t.first),  h);
+    h = fnv1a64(&t.second, sizeof(t.second), h);
+  } // for
+  return (size_t)h;
+} // DawgBuilder::NodeHash::operator()
+
+bool DawgBuilder::NodeEqual::operator()(StateId s1, StateId s2) const {
+  const Node &n1 = db->nodes[s1], &n2 = db->nodes[s2];
+  return n1.final == n2.final && n1.out == n2.out;
+} // DawgBuilder::NodeEqual::operator()
+
+
+DawgBuilder::DawgBuilder()
+: nodes(1), reg(0, NodeHash{this}, NodeEqual{this}), path{0} {
+} // DawgBuilder::DawgBuilder
+
+
+DawgBuilder::StateId DawgBuilder::newState() {
+  if (freeIds.empty()) {
+    nodes.emplace_back();
+    return (StateId)nodes.size() - 1;
+  } // if
+  const StateId s = freeIds.back();
+  freeIds.pop_back();
+  return s;
+} // DawgBuilder::newState
+
+void DawgBuilder::deleteState(StateId s) {
+  for (const auto &t: nodes[s].out)
+    nodes[t.second].inDegree--;
+  nodes[s] = Node();
+  freeIds.push_back(s);
+} // DawgBuilder::deleteState
+
+DawgBuilder::StateId DawgBuilder::destOf(StateId s, unsigned char b) const {
+  const auto &out = nodes[s].out;
+  const auto it = lower_bound(out.begin(), out.end(), make_pair(b, noState));
+  return (it != out.end() && it->first == b) ? it->second : noState;
+} // DawgBuilder::destOf
+
+void DawgBuilder::setDest(StateId s, unsigned char b, StateId d) {
+  auto &out = nodes[s].out;
+  const auto it = lower_bound(out.begin(), out.end(), make_pair(b, noState));
+  if (it != out.end() && it->first == b) {
+    nodes[it->second].inDegree--;
+    it->second = d;
+  } else
+    out.emplace(it, b, d);
+  nodes[d].inDegree++;
+} // DawgBuilder::setDest
+
+DawgBuilder::StateId DawgBuilder::cloneOf(StateId s) {
+  const StateId c = newState(); // may move nodes
+  nodes[c].final = nodes[s].final;
+  nodes[c].out   = nodes[s].out;
+  for (const auto &t: nodes[c].out)
+    nodes[t.second].inDegree++;
+  return c;
+} // DawgBuilder::cloneOf
+
+
+// the states of the path below depth are final now (deepest first):
+//   each one is replaced by an equivalent registered one or registered
+void DawgBuilder::minimizePath(size_t depth) {
+  for (size_t i = path.size() - 1; i > depth; i--) {
+    const StateId s = path[i];
+    const auto it = reg.find(s);
+    if (it != reg.end()) {
+      setDest(path[i - 1], (unsigned char)last[i - 1], *it);
+      deleteState(s);
+    } else
+      reg.insert(s);
+  } // for
+  path.resize(min(path.size(), depth + 1));
+} // DawgBuilder::minimizePath
+
+DawgBuilder &DawgBuilder::add(TapeView word) {
+  const bool pathOpen = path.size() == last.size() + 1;
+  if (pathOpen && (nWords == 0 || word > last)) {
+    size_t cp = 0;           // length of the common prefix
+    while (cp < last.size() && cp < word.size() && last[cp] == word[cp])
+      cp++;
+    if (nWords == 0 || destOf(path[cp], (unsigned char)word[cp]) == noState) {
+      minimizePath(cp);
+      for (size_t i = cp; i < word.size(); i++) {
+        const StateId n = newState();
+        setDest(path.back(), (unsigned char)word[i], n);
+        path.push_back(n);
+      } // for
+      nodes[path.back()].final = true;
+      last = Tape(word);
+      nWords++;
+      return *this;
+    } // if
+  } // if
+  if (!(pathOpen && word == last))
+    addOutOfOrder(word);
+  return *this;
+} // DawgBuilder::add
+
+// the prefix path of word is made private: states before the first
+//   confluence state are unregistered, the others are cloned
+void DawgBuilder::addOutOfOrder(TapeView word) {
+  minimizePath(0);
+  if (contains(word))
+    return;
+  path.assign(1, 0);
+  size_t k = 0;              // length of the longest prefix in the DAWG
+  StateId d;
+  while (k < word.size() && (d = destOf(path.back(), (unsigned char)word[k])) != noState) {
+    path.push_back(d);
+    k++;
+  } // while
+  size_t first = 1;          // first confluence state or k + 1
+  while (first <= k && nodes[path[first]].inDegree <= 1)
+    first++;
+  for (size_t i = 1; i < first && i <= k; i++)
+    reg.erase(path[i]);      // modified below
+  for (size_t i = first; i <= k; i++) {
+    const StateId c = cloneOf(path[i]);
+    setDest(path[i - 1], (unsigned char)word[i - 1], c);
+    path[i] = c;
+  } // for
+  for (size_t i = k; i < word.size(); i++) {
+    const StateId n = newState();
+    setDest(path.back(), (unsigned char)word[i], n);
+    path.push_back(n);
+  } // for
+  nodes[path.back()].final = true;
+  last = Tape(word);
+  nWords++;
+} // DawgBuilder::addOutOfOrder
+
+
+bool DawgBuilder::contains(TapeView word) const {
+  StateId s = 0;
+  for (char ch: word)
+    if ((s = destOf(s, (unsigned char)ch)) == noState)
+      return false;
+  return nodes[s].final;
+} // DawgBuilder::contains
+
+size_t DawgBuilder::nrOfTransitions() const {
+  size_t n = 0;
+  for (const Node &node: nodes)
+    n += node.out.size();
+  return n;
+} // DawgBuilder::nrOfTransitions
+
+
+// states in BFS order from the start state, successors in byte order
+vector<DawgBuilder::StateId> DawgBuilder::bfsOrder(vector<StateId> &newId) const {
+  vector<StateId> order{0};
+  newId.assign(nodes.size(), noState);
+  newId[0] = 0;
+  for (size_t i = 0; i < order.size(); i++)
+    for (const auto &t: nodes[order[i]].out)
+      if (newId[t.second] == noState) {
+        newId[t.second] = (StateId)order.size();
+        order.push_back(t.second);
+      } // if
+  return order;
+} // DawgBuilder::bfsOrder
+
+DFA *DawgBuilder::dfaOf() {
+  minimizePath(0);
+  vector<StateId> newId;
+  const vector<StateId> order = bfsOrder(newId);
+  vector<State> names(order.size());
+  for (size_t i = 0; i < order.size(); i++)
+    names[i] = to_string(i);
+  vector<FABuilder::IdTransition> transitions;
+  FABuilder fab;
+  fab.setStartState(names[0]);
+  for (size_t i = 0; i < order.size(); i++) {
+    if (nodes[order[i]].final)
+      fab.addFinalState(names[i]);
+    for (const auto &t: nodes[order[i]].out) {
+      if (t.first <= (unsigned char)eps) // neither eot nor eps
+        throw domain_error("DawgBuilder: word with eot or eps");
+      transitions.push_back({(int)i, (TapeSymbol)t.first, newId[t.second]});
+    } // for
+  } // for
+  fab.addTransitions(names, std::move(transitions));
+  return std::move(fab).buildDFA();
+} // DawgBuilder::dfaOf
+
+// via a (deterministic) CompiledNFA, whose subset construction is a
+//   mere renumbering
+CompiledDFA DawgBuilder::compiledOf() {
+  minimizePath(0);
+  vector<StateId> newId;
+  const vector<StateId> order = bfsOrder(newId);
+  vector<CompiledNFA::Transition> transitions;
+  vector<CompiledNFA::StateId> finals;
+  for (size_t i = 0; i < order.size(); i++) {
+    if (nodes[order[i]].final)
+      finals.push_back((CompiledNFA::StateId)i);
+    for (const auto &t: nodes[order[i]].out) {
+      CompiledNFA::SymbolSet label;
+      label.set(t.first);
+      transitions.push_back({(CompiledNFA::StateId)i, label, newId[t.second]});
+    } // for
+  } // for
+  return CompiledDFA(CompiledNFA((int)order.size(), 0, finals, std::move(transitions)));
+} // DawgBuilder::compiledOf
+
+void DawgBuilder::save(const string &fileName) {
+  compiledOf().save(fileName);
+} // DawgBuilder::save
+
+
+// end of DawgBuilder.cpp
+//======================================================================
@@ -0,0 +1,109 @@
+// DawgBuilder.h:                                                  2024
+// -------------
+// DawgBuilder builds the minimal acyclic DFA (DAWG) of a set of words
+// incrementally (Daciuk, Mihov, Watson, Watson 2000), so no trie and no
+// NeTable is needed and memory stays proportional to the result:
+// *  all states but the ones on the path of the last word are minimal
+//    and kept in a register (hash set of equivalent states),
+// *  for sorted words, the path of the last word below its common
+//    prefix with the next word never changes again, so these states
+//    are replaced by equivalent registered ones or registered,
+// *  a word out of order closes the path, then the states of its prefix
+//    from the first confluence state (in-degree > 1) on are cloned, so
+//    the new path is private to the word and can be extended,
+// *  dfaOf, compiledOf and save deliver the DAWG as DFA (states named
+//    0, 1, ... in BFS order, FABuilder requires a transition), as
+//    CompiledDFA or as its binary image.
+//======================================================================
+
+#pragma once
+#ifndef DawgBuilder_h
+#define DawgBuilder_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+
+class DFA;
+class CompiledDFA;
+
+
+class DawgBuilder final
+        /*OC+*/ : private ObjectCounter<DawgBuilder> /*+OC*/ {
+
+  public:
+
+    typedef std::int32_t StateId;
+    static constexpr StateId noState = -1;
+
+  private:
+
+    struct Node {
+      bool         final    = false;
+      std::int32_t inDegree = 0;
+      std::vector<std::pair<unsigned char, StateId>> out; // sorted by byte
+    }; // Node
+
+    struct NodeHash {
+      const DawgBuilder *db;
+      std::size_t operator()(StateId s) const;
+    }; // NodeHash
+
+    struct NodeEqual {
+      const DawgBuilder *db;
+      bool operator()(StateId s1, StateId s2) const;
+    }; // NodeEqual
+
+    std::vector<Node>    nodes;           // 0 is the start state
+    std::vector<StateId> freeIds;
+    std::unordered_set<StateId, NodeHash, NodeEqual> reg; // all but path
+    std::vector<StateId> path;            // of the last word, not registered
+    Tape                 last;            // the last word
+    std::size_t          nWords = 0;
+
+    StateId newState();
+    void    deleteState(StateId s);
+    StateId destOf(StateId s, unsigned char b) const; // noState if none
+    void    setDest(StateId s, unsigned char b, StateId d);
+    StateId cloneOf(StateId s);
+
+    void minimizePath(std::size_t depth); // below depth
+    void addOutOfOrder(TapeView word);
+    std::vector<StateId> bfsOrder(std::vector<StateId> &newId) const;
+
+  public:
+
+    DawgBuilder();
+
+    DawgBuilder(const DawgBuilder  &db) = delete; // register refers to this
+    DawgBuilder(      DawgBuilder &&db) = delete;
+
+    ~DawgBuilder() = default;
+
+    // words in ascending order are fastest, duplicates are ignored
+    DawgBuilder &add(TapeView word);
+
+    bool contains(TapeView word) const;
+
+    std::size_t nrOfWords()       const { return nWords; }
+    int         nrOfStates()      const { return (int)(nodes.size() - freeIds.size()); }
+    std::size_t nrOfTransitions() const;
+
+    // all of them minimize the path of the last word first
+    DFA        *dfaOf();              // not for words with eot or eps
+    CompiledDFA compiledOf();
+    void        save(const std::string &fileName); // image of compiledOf
+
+}; // DawgBuilder
+
+
+#endif
+
+// end of DawgBuilder.h
+//======================================================================
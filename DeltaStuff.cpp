@@ -9,6 +9,7 @@
 
 #include <map>
 #include <stdexcept>
+#include <utility>
 
 using namespace std;
 
@@ -21,25 +22,56 @@ using namespace std;
 
 // --- function to transform DDelta to NDelta ---
 
+// both transformations walk the maps in order and insert with hints at
+//   the end, so they need neither lookups nor a transitions() vector
+
 NDelta nDeltaOf(const DDelta &dDelta) {
   NDelta nDelta;
-  for (const auto &t: dDelta.transitions())
-    nDelta[t.src][t.tSy] = StateSet(t.dest);
+  for (const auto &row: dDelta) {
+    auto &nRow = nDelta.emplace_hint(nDelta.end(), row.first,
+                                     MbVector<TapeSymbol, StateSet>())->second;
+    for (const auto &e: row.second)
+      nRow.emplace_hint(nRow.end(), e.first, StateSet(e.second));
+  } // for
   return nDelta;
 } // nDeltaOf
 
 
-// --- function to transform NDelta to DDelta ---
+// --- functions to transform NDelta to DDelta ---
+
+static void checkDeterministic(const State &src, TapeSymbol tSy,
+                               const StateSet &dest) {
+  if (dest.size() != 1) // (dest.size() == 0) or (dest.size() > 1)
+    throw domain_error(string("invalid transition (") +
+          src + ", " + stringOf(tSy) +
+          ") -> set of states with cardinality != 1");
+} // checkDeterministic
 
 DDelta dDeltaOf(const NDelta &nDelta) {
   DDelta dDelta;
-  for (const auto &t: nDelta.transitions())
-    if (t.dest.size() == 1)
-      dDelta[t.src][t.tSy] = t.dest.anyElement(); // the one and only
-    else // (t.dest.size() == 0) or (t.dest.size() > 1)
-      throw domain_error(string("invalid transition (") +
-            t.src + ", " + stringOf(t.tSy) +
-            ") -> set of states with cardinality != 1");
+  for (const auto &row: nDelta) {
+    auto &dRow = dDelta.emplace_hint(dDelta.end(), row.first,
+                                     MbVector<TapeSymbol, State>())->second;
+    for (const auto &e: row.second) {
+      checkDeterministic(row.first, e.first, e.second);
+      dRow.emplace_hint(dRow.end(), e.first, e.second.anyElement());
+    } // for
+  } // for
+  return dDelta;
+} // dDeltaOf
+
+DDelta dDeltaOf(NDelta &&nDelta) {
+  DDelta dDelta;
+  while (!nDelta.empty()) {
+    auto rowNode = nDelta.extract(nDelta.begin()); // moves key and row out
+    auto &dRow = dDelta.emplace_hint(dDelta.end(), std::move(rowNode.key()),
+                                     MbVector<TapeSymbol, State>())->second;
+    for (auto &e: rowNode.mapped()) {
+      checkDeterministic(dDelta.rbegin()->first, e.first, e.second);
+      dRow.emplace_hint(dRow.end(), e.first,
+                        std::move(e.second.extract(e.second.begin()).value()));
+    } // for
+  } // while
   return dDelta;
 } // dDeltaOf
 
@@ -82,6 +82,9 @@ NDelta nDeltaOf(const DDelta &dDelta);
 DDelta dDeltaOf(const NDelta &nDelta);
   // all destination sets in nDelta must have one element only, {s} -> s
 
+DDelta dDeltaOf(NDelta &&nDelta);
+  // same as above, but moves the states out of nDelta, which is cleared
+
 
 #endif
 
@@ -7,6 +7,8 @@
 //======================================================================
 
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <map>
@@ -14,6 +16,7 @@
 #include <set>
 #include <sstream>
 #include <typeinfo>
+#include <unordered_set>
 
 using namespace std;
 
@@ -23,6 +26,7 @@ using namespace std;
 #include "FA.h"
 #include "DFA.h"
 #include "NFA.h"
+#include "FAProfile.h"
 
 
 // macro used in writeToGraphVizFile and operator<<:
@@ -39,13 +43,14 @@ vector<State> FA::topSortedStates() const {
   TapeSymbolSet VwithEps = V;
   VwithEps.insert(eps);    // to respect epsilon transitions
   vector<State> tss;       // topologically sorted states
+  unordered_set<State> inTss; // for linear time on large automata
   tss.push_back(s1);       // start with start state s1
+  inTss.insert(s1);
   for (unsigned int i = 0; i < tss.size(); i++) {
     State src = tss[i];    // copy State as tss.push_back may reallocate!!!
     for (char tSy: VwithEps)
       for (const State &dest: deltaAt(src, tSy))
-        if (find(tss.begin(), tss.end(), dest) ==
-            tss.end())     // dest is not in tss yet, so:
+        if (inTss.insert(dest).second) // dest is not in tss yet, so:
           tss.push_back(dest);
   } // for
   return tss;
@@ -59,21 +64,43 @@ vector<State> FA::topSortedStates() const {
 static const string fontName = "Arial"; // used for nodes ...
 static const int    fontSize = 10;      // ... and edges
 
+// heat colour in GraphViz' HSV notation: blue for rare, red for hot,
+//   on a logarithmic scale, as hit counts are far from uniform
+static string heatColorOf(FAProfile::Count cnt, FAProfile::Count maxCnt) {
+  double t = (maxCnt == 0) ? 0.0 : log1p((double)cnt) / log1p((double)maxCnt);
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.3f %.3f %.3f", 0.66 * (1.0 - t), 0.2 + 0.6 * t, 1.0);
+  return buf;
+} // heatColorOf
+
 static void writeTransition(ostream &ofs,
-     const State &src, const State &dest, string tSysStr) {
+     const State &src, const State &dest, string tSysStr,
+     const FAProfile *profile = nullptr, FAProfile::Count firings = 0) {
   ofs << "  \"" << src  << "\" -> " <<
            "\"" << dest << "\"";
+  string cntStr = (profile != nullptr && firings > 0) ?
+                  " (" + to_string(firings) + ")" : "";
   if (tSysStr == stringOf(eps))
-    ofs << " [label = \"e\"" << // greek e for EPSILON
+    ofs << " [label = \"e" << cntStr << "\"" << // greek e for EPSILON
            " fontname = Symbol";
   else
-    ofs << " [label = \"" << tSysStr  << "\"" <<
+    ofs << " [label = \"" << tSysStr << cntStr << "\"" <<
            " fontname = " << fontName;
-  ofs << " fontsize = " << fontSize << "]; " << endl;
+  ofs << " fontsize = " << fontSize;
+  if (profile != nullptr) {
+    if (firings > 0)
+      ofs << " color = \"" << heatColorOf(firings, profile->maxFirings()) << "\"" <<
+             " penwidth = " << (1 + (int)(3 * log1p((double)firings) /
+                                          log1p((double)profile->maxFirings())));
+    else // never fired
+      ofs << " style = dashed color = gray60";
+  } // if
+  ofs << "]; " << endl;
 } // writeTransition
 
 void FA::genGraphVizFile(const string &fileName,
-                         const string &name) const {
+                         const string &name,
+                         const FAProfile *profile) const {
   ofstream ofs(fileName);
   if (!ofs.good())
     throw runtime_error("error on opening output file \"" +
@@ -115,6 +142,17 @@ void FA::genGraphVizFile(const string &fileName,
   // finally all the transitions
   ofs << "  START -> \"" << s1 << "\";" << endl;
   ofs << endl;
+  // optional heat colours for the states of a profile
+  if (profile != nullptr) {
+    for (const State &s: Sordered) {
+      FAProfile::Count visits = profile->visitsOf(s);
+      ofs << "  \"" << s << "\" [xlabel = \"" << visits << "\"";
+      if (visits > 0)
+        ofs << " fillcolor = \"" << heatColorOf(visits, profile->maxVisits()) << "\"";
+      ofs << "];" << endl;
+    } // for
+    ofs << endl;
+  } // if
 
 #ifdef COLLECT_TRANSITIONS_TO_ONE_ARROW
 
@@ -131,6 +169,7 @@ void FA::genGraphVizFile(const string &fileName,
           string tSysStr;
           bool hasEpsilonTransition = false;
           bool first = true;
+          FAProfile::Count firings = 0; // sum for all symbols of this arrow
           for (const auto &tSy: it->second) { // is a TapeSymbolSet
             if (tSy == eps)
               hasEpsilonTransition = true;
@@ -139,12 +178,15 @@ void FA::genGraphVizFile(const string &fileName,
                 tSysStr.append(", ");
               tSysStr.append(stringOf(tSy)); // not EPSILON
               first = false;
+              if (profile != nullptr)
+                firings += profile->firingsOf(src, tSy);
             } // else
           } // for
           if (hasEpsilonTransition)
-            writeTransition(ofs, src, dest, stringOf(eps));
+            writeTransition(ofs, src, dest, stringOf(eps), profile,
+                            profile ? profile->firingsOf(src, eps) : 0);
           if (tSysStr != "")
-            writeTransition(ofs, src, dest, tSysStr);
+            writeTransition(ofs, src, dest, tSysStr, profile, firings);
       } // if
     } // for
 
@@ -153,10 +195,8 @@ void FA::genGraphVizFile(const string &fileName,
   for (const State &src: Sordered)
     for (char tSy: V)
       for (const State &dest: deltaAt(src, tSy))
-        if (tSy == EPSILON)
-          writeTransition(ofs, src, dest, stringOf(EPSILON));
-        else
-          writeTransition(ofs, src, dest, stringOf(tSy));
+        writeTransition(ofs, src, dest, stringOf(tSy), profile,
+                        profile ? profile->firingsOf(src, tSy) : 0);
 
 #endif // COLLECT_TRANSITIONS_TO_ONE_ARROW
 
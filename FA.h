@@ -11,6 +11,7 @@
 #define FA_h
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -19,19 +20,32 @@
 #include "StateStuff.h"
 #include "DeltaStuff.h"
 
+class FAProfile; // forward for optional heat colouring in genGraphVizFile
+
 
 class FA {  // abstract base class for DFA and NFA
 
   friend std::ostream &operator<<(std::ostream &os, const FA &fa);
+  friend class FAProfiler; // resolves delta to row indices once
 
   protected:
 
-    // called by constructors for DFA and NFA only
-    FA(const StateSet &S,  const TapeSymbolSet &V,
-       const State    &s1, const StateSet      &F)
-    : S(S), V(V), s1(s1), F(F) {
+    struct Core {          // immutable data shared by all copies of an FA
+      StateSet      S;
+      TapeSymbolSet V;
+      State         s1;
+      StateSet      F;
+    }; // Core
+
+    // called by constructors for DFA and NFA only,
+    //   arguments by value, so callers can move their sets in
+    FA(StateSet S, TapeSymbolSet V, State s1, StateSet F)
+    : core(std::make_shared<const Core>(
+             Core{std::move(S), std::move(V), std::move(s1), std::move(F)})),
+      S(core->S), V(core->V), s1(core->s1), F(core->F) {
     } // FA
 
+    // copies share the immutable core, so they are O(1)
     FA(const FA  &fa) = default;
     FA(      FA &&fa) = default;
 
@@ -42,20 +56,26 @@ class FA {  // abstract base class for DFA and NFA
     // used by operator<< and writeToGraphVizFile only
     std::vector<State> topSortedStates() const; // topological sort
 
+  private:
+
+    std::shared_ptr<const Core> core; // declared before the references below
+
   public:
 
-    const StateSet      S;     // set of states       (cf. "nonterminals")
-    const TapeSymbolSet V;     // set of tape symbols (cf. "terminals")
-//  const XDelta        delta; // trans. func. defined in derived classes
-    const State         s1;    // start state, an element of S
-    const StateSet      F;     // set of final states, a subset of S
+    const StateSet      &S;     // set of states       (cf. "nonterminals")
+    const TapeSymbolSet &V;     // set of tape symbols (cf. "terminals")
+//  const XDelta        &delta; // trans. func. defined in derived classes
+    const State         &s1;    // start state, an element of S
+    const StateSet      &F;     // set of final states, a subset of S
 
     virtual ~FA() = default;
 
     virtual bool accepts(const Tape &tape) const = 0;
 
     void genGraphVizFile(const std::string &fileName,
-                         const std::string &name = "") const;
+                         const std::string &name = "",
+                         const FAProfile *profile = nullptr) const;
+      // with a profile: states and arrows coloured by their hit counts
 
 }; // FA
 
@@ -5,6 +5,7 @@
 // objects of classes DFA or NFA (both derived from FA)
 //======================================================================
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <iterator>
@@ -12,6 +13,9 @@
 #include <sstream>
 #include <stdexcept>
 #include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -22,14 +26,13 @@ using namespace std;
 #include "DFA.h"
 #include "NFA.h"
 #include "FABuilder.h"
+#include "MappedFile.h"
 
 #ifdef MEALY_DFA
 #include "MealyDFA.h"
 #endif
 
 void FABuilder::checkStates() const {
-    TapeSymbolSet VwithEps = this->V; // a copy to allow changes in ...
-    VwithEps.insert(eps); // ... trick to respect epsilon transitions
     if (delta.empty())
         throw logic_error("FABuilder: transition function delta is empty");
     // as delta.size() > 0 there are transitions, so
@@ -42,17 +45,17 @@ void FABuilder::checkStates() const {
     if (delta.find(s1) == delta.end())
         throw logic_error("FABuilder: start state is not in delta's domain");
     StateSet reachableStates(s1); // start state is reachable
-    size_t oldSize, newSize = 1;
-    do {
-        oldSize = newSize;
-        for (const State &s: reachableStates)
-            for (TapeSymbol tSy: VwithEps) {
-                const StateSet &destSet = delta[s][tSy];
-                if (defined(destSet))
-                    reachableStates.insert(destSet);
+    vector<const State *> stc = {&*reachableStates.begin()}; // states to check
+    while (!stc.empty()) {
+        const State &s = *stc.back();
+        stc.pop_back();
+        for (const auto &e: delta[s]) // all (tSy, destSet) of s, incl. eps
+            for (const State &dest: e.second) {
+                auto ir = reachableStates.insert(dest);
+                if (ir.second) // dest is a new reachable state
+                    stc.push_back(&*ir.first);
             } // for
-        newSize = reachableStates.size();
-    } while (newSize > oldSize);
+    } // while
     const StateSet unreachableStates = (S - reachableStates);
     if (unreachableStates.size() > 0)
         cout << "WARNING in FABuilder: the state(s) in set " <<
@@ -140,16 +143,122 @@ void FABuilder::initFromStream(istream &is) {
 } // FABuilder::initFromStream
 
 
+// FABuilder::initFromBuffer: high-throughput version of initFromStream
+//--------------------------
+// Tokens are string_views into buf, each state name is copied once only
+// into a hash table that maps it to an integer id, and the transitions
+// are collected as (id, symbol, id) triples for addTransitions.
+
+namespace {
+
+    inline bool isBlank(char ch) { // same as isspace for operator>>
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f';
+    }
+
+    class LineTokenizer final {
+        const char *pos, *end;
+    public:
+        LineTokenizer(const char *pos, const char *end) : pos(pos), end(end) {}
+        string_view next() { // empty string_view at end of line
+            while (pos < end && isBlank(*pos))
+                pos++;
+            const char *start = pos;
+            while (pos < end && !isBlank(*pos))
+                pos++;
+            return string_view(start, pos - start);
+        }
+    };
+
+} // namespace
+
+void FABuilder::initFromBuffer(string_view buf) {
+    unordered_map<string_view, int> idOf; // interned state names ...
+    vector<State> names;                  // ... and their strings
+    vector<IdTransition> transitions;
+    auto intern = [&](string_view name) {
+        auto ir = idOf.emplace(name, (int) names.size());
+        if (ir.second)
+            names.emplace_back(name);
+        return ir.first->second;
+    };
+
+    int lnr = 0;
+    const char *pos = buf.data(), *bufEnd = buf.data() + buf.size();
+    while (pos < bufEnd) {
+        const char *eol = static_cast<const char *>(memchr(pos, '\n', bufEnd - pos));
+        if (eol == nullptr)
+            eol = bufEnd;
+        lnr++;
+        LineTokenizer lt(pos, eol);
+        pos = eol + 1;
+        string_view sy = lt.next();
+        if (sy.empty() || sy.substr(0, 2) == "//") // skip empty or comment line
+            continue;
+        bool isStartState = (sy == "->");
+        bool isFinalState = (sy == "()");
+        if (sy == "->()") // ->() indicates start state being final
+            isStartState = isFinalState = true;
+        string_view state = sy;
+        if (isStartState && !isFinalState) {
+            state = lt.next();
+            if (state == "()") { // -> () also allowed for start & final state
+                isFinalState = true;
+                state = lt.next();
+            }
+        } else if (isFinalState)
+            state = lt.next();
+        if (state.empty() || lt.next() != "->")
+            throw runtime_error(initMessageOf(lnr, "-> missing"));
+        const int src = intern(state);
+        if (isStartState) {
+            if (s1 != "")
+                throw runtime_error(initMessageOf(lnr, "redef. of start state"));
+            setStartState(names[src]);
+        }
+        if (isFinalState)
+            addFinalState(names[src]);
+        for (sy = lt.next(); !sy.empty(); sy = lt.next()) { // terminal or |
+            if (sy == "|") {
+                sy = lt.next(); // terminal
+                if (sy.empty())
+                    throw runtime_error(initMessageOf(lnr,
+                                                      "no symbol for transition from " + names[src]));
+            }
+            TapeSymbol tSy = sy[0];
+            if ((sy[0] == eps) || (sy == "eps"))
+                tSy = eps;
+            else if (sy.length() > 1)
+                throw runtime_error(initMessageOf(lnr,
+                                                  "tape symbol " + string(sy) + " too long"));
+            string_view destState = lt.next();
+            if (destState.empty() || destState == "|")
+                throw runtime_error(initMessageOf(lnr,
+                                                  "dest. state missing with symbol " + stringOf(tSy)));
+            transitions.push_back({src, tSy, intern(destState)});
+        }
+    }
+    if (s1 == "")
+        throw runtime_error(initMessageOf(lnr,
+                                          "no start state defined"));
+    if (F.size() == 0)
+        throw runtime_error(initMessageOf(lnr,
+                                          "no final state(s) defined"));
+
+    addTransitions(names, std::move(transitions));
+} // FABuilder::initFromBuffer
+
+
 FABuilder::FABuilder(const string &fileName) {
-    ifstream ifs(fileName);
-    if (!ifs.good())
-        throw invalid_argument("file \"" + fileName + "\" not found");
-    initFromStream(ifs);
+    const MappedFile mf(fileName); // throws invalid_argument if not found
+    initFromBuffer(mf.contents());
 } // FABuilder::FABuilder
 
 FABuilder::FABuilder(const char *str) {
-    istringstream iss(string(str, strlen(str)));
-    initFromStream(iss);
+    initFromBuffer(string_view(str, strlen(str)));
+} // FABuilder::FABuilder
+
+FABuilder::FABuilder(istream &is) {
+    initFromStream(is);
 } // FABuilder::FABuilder
 
 
@@ -205,6 +314,49 @@ FABuilder &FABuilder::addTransition(
     return *this;
 } // FABuilder::addTransition
 
+FABuilder &FABuilder::addTransitions(
+    const vector<State> &names, vector<IdTransition> transitions) {
+    // ranks of ids in name order allow sorted insertion with end hints
+    vector<int> byName(names.size()), rank(names.size());
+    for (size_t i = 0; i < names.size(); i++)
+        byName[i] = (int) i;
+    sort(byName.begin(), byName.end(),
+         [&names](int a, int b) { return names[a] < names[b]; });
+    for (size_t r = 0; r < byName.size(); r++)
+        rank[byName[r]] = (int) r;
+    vector<bool> inTransition(names.size(), false);
+    for (const IdTransition &t: transitions)
+        inTransition[t.src] = inTransition[t.dest] = true;
+    for (int id: byName)
+        if (inTransition[id])
+            S.emplace_hint(S.end(), names[id]);
+    sort(transitions.begin(), transitions.end(),
+         [&rank](const IdTransition &a, const IdTransition &b) {
+             if (a.src != b.src)
+                 return rank[a.src] < rank[b.src];
+             if (a.tSy != b.tSy)
+                 return a.tSy < b.tSy;
+             return rank[a.dest] < rank[b.dest];
+         });
+    bool hasSymbol[256] = {};
+    auto rowIt = delta.end();
+    int rowSrc = -1;
+    for (const IdTransition &t: transitions) {
+        if (t.src != rowSrc) {
+            rowIt = delta.emplace_hint(delta.end(), names[t.src], MbVector<TapeSymbol, StateSet>());
+            rowSrc = t.src;
+        }
+        StateSet &dests = rowIt->second[t.tSy]; // symbols are sorted, too
+        dests.emplace_hint(dests.end(), names[t.dest]);
+        if (t.tSy != eps) // epsilon is no tape symbol
+            hasSymbol[(unsigned char) t.tSy] = true;
+    }
+    for (int ch = 0; ch < 256; ch++)
+        if (hasSymbol[ch])
+            V.insert((TapeSymbol) ch);
+    return *this;
+} // FABuilder::addTransitions
+
 FABuilder &FABuilder::setMooreLambda(const map<State, char> &mooreLambda) {
     for (const auto &s: S) {
         if (mooreLambda.find(s) == mooreLambda.end())
@@ -237,15 +389,16 @@ FABuilder &FABuilder::setMealyLambda(const std::initializer_list<std::pair<std::
 
 
 bool FABuilder::representsDFA() const {
-    for (const auto &t: delta.transitions())
-        if ((t.tSy == eps) || // epsilon transition
-            (t.dest.size() > 1)) // transition with several dest. states
-            return false;
+    for (const auto &row: delta) // no transitions() vector for large deltas
+        for (const auto &e: row.second)
+            if ((e.first == eps) || // epsilon transition
+                (e.second.size() > 1)) // transition with several dest. states
+                return false;
     return true;
 } // FABuilder::representsDFA
 
 
-FA *FABuilder::buildFA() const {
+FA *FABuilder::buildFA() const & {
     checkStates();
     if (representsDFA())
         return new DFA(S, V, s1, F, dDeltaOf(delta));
@@ -253,19 +406,19 @@ FA *FABuilder::buildFA() const {
         return new NFA(S, V, s1, F, delta);
 } // FABuilder::buildFA
 
-DFA *FABuilder::buildDFA() const {
+DFA *FABuilder::buildDFA() const & {
     if (!representsDFA())
         throw domain_error("cannot build DFA, builder's delta represents a NFA");
     checkStates();
     return new DFA(S, V, s1, F, dDeltaOf(delta));
 } // FABuilder::buildDFA
 
-NFA *FABuilder::buildNFA() const {
+NFA *FABuilder::buildNFA() const & {
     checkStates();
     return new NFA(S, V, s1, F, delta);
 } // FABuilder::buildNFA
 
-MooreDFA *FABuilder::buildMooreDFA() const {
+MooreDFA *FABuilder::buildMooreDFA() const & {
     if (mooreLambda.empty())
         throw domain_error("cannot build MooreDFA, no lambda function set");
     if (!representsDFA())
@@ -274,7 +427,7 @@ MooreDFA *FABuilder::buildMooreDFA() const {
     return new MooreDFA(S, V, s1, F, dDeltaOf(delta), mooreLambda);
 } // FABuilder::buildMooreDFA
 
-MealyDFA *FABuilder::buildMealyDFA() const {
+MealyDFA *FABuilder::buildMealyDFA() const & {
     if (mealyLambda.empty())
         throw domain_error("cannot build MealyDFA, no lambda function set");
     if (!representsDFA())
@@ -283,12 +436,64 @@ MealyDFA *FABuilder::buildMealyDFA() const {
     return new MealyDFA(S, V, s1, F, dDeltaOf(delta), mealyLambda);
 } // FABuilder::buildMealyDFA
 
+
+FA *FABuilder::buildFA() && {
+    if (representsDFA())
+        return std::move(*this).buildDFA();
+    else
+        return std::move(*this).buildNFA();
+} // FABuilder::buildFA
+
+DFA *FABuilder::buildDFA() && {
+    if (!representsDFA())
+        throw domain_error("cannot build DFA, builder's delta represents a NFA");
+    checkStates();
+    DFA *dfa = new DFA(std::move(S), std::move(V), std::move(s1), std::move(F),
+                       dDeltaOf(std::move(delta)));
+    clear();
+    return dfa;
+} // FABuilder::buildDFA
+
+NFA *FABuilder::buildNFA() && {
+    checkStates();
+    NFA *nfa = new NFA(std::move(S), std::move(V), std::move(s1), std::move(F),
+                       std::move(delta));
+    clear();
+    return nfa;
+} // FABuilder::buildNFA
+
+MooreDFA *FABuilder::buildMooreDFA() && {
+    if (mooreLambda.empty())
+        throw domain_error("cannot build MooreDFA, no lambda function set");
+    if (!representsDFA())
+        throw domain_error("cannot build DFA, builder's delta represents a NFA");
+    checkStates();
+    MooreDFA *mooreDfa = new MooreDFA(std::move(S), std::move(V), std::move(s1), std::move(F),
+                                      dDeltaOf(std::move(delta)), std::move(mooreLambda));
+    clear();
+    return mooreDfa;
+} // FABuilder::buildMooreDFA
+
+MealyDFA *FABuilder::buildMealyDFA() && {
+    if (mealyLambda.empty())
+        throw domain_error("cannot build MealyDFA, no lambda function set");
+    if (!representsDFA())
+        throw domain_error("cannot build DFA, builder's delta represents a NFA");
+    checkStates();
+    MealyDFA *mealyDfa = new MealyDFA(std::move(S), std::move(V), std::move(s1), std::move(F),
+                                      dDeltaOf(std::move(delta)), std::move(mealyLambda));
+    clear();
+    return mealyDfa;
+} // FABuilder::buildMealyDFA
+
 void FABuilder::clear() {
     S.clear();
     V.clear();
     delta.clear();
     s1 = State();
     F.clear();
+    mooreLambda.clear();
+    mealyLambda.clear();
 } // FABuilder::clear
 
 
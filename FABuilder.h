@@ -12,6 +12,8 @@
 #include <initializer_list>
 #include <iosfwd>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "ObjectCounter.h"
 #include "TapeStuff.h"
@@ -47,10 +49,14 @@ class FABuilder final : private ObjectCounter<FABuilder> {
     // () E -> ...        leading () flags final state(s)
     // also allowed: -> () S -> ... for start state being final, too
 
+    void initFromBuffer(std::string_view buf); // same syntax and errors,
+    // but string_view tokens, interned state names and bulk insertion
+
 public:
     FABuilder() = default; // empty builder, needs programmatical init.
-    explicit FABuilder(const std::string &fileName); // init. from text file
+    explicit FABuilder(const std::string &fileName); // init. from text file (mmap'd)
     explicit FABuilder(const char *str); // init. from C string (e.g., in the source)
+    explicit FABuilder(std::istream &is); // init. from stream, line by line
 
     FABuilder &operator==(const FABuilder &fab) = delete;
 
@@ -77,6 +83,17 @@ public:
     FABuilder &addTransition(
         const State &src, TapeSymbol tSy, std::initializer_list<State> il);
 
+    struct IdTransition { // transition between states given by ids
+        int src;
+        TapeSymbol tSy;
+        int dest;
+    };
+
+    FABuilder &addTransitions(
+        const std::vector<State> &names, std::vector<IdTransition> transitions);
+    // bulk insertion, names[id] is the name of state id: each name is
+    // inserted once, rows and dest. sets in order with end hints
+
     FABuilder &setMooreLambda(const map<State, char> &mooreLambda);
 
     FABuilder &setMealyLambda(std::initializer_list<std::pair<std::pair<State, TapeSymbol>, char>> il);
@@ -84,11 +101,20 @@ public:
 
     bool representsDFA() const;
 
-    FA *buildFA() const; // build DFA when possible, otherwise build NFA
-    DFA *buildDFA() const; // requires: representsDFA() == true
-    NFA *buildNFA() const; // always works
-    MooreDFA *buildMooreDFA() const; // requires: mooreLambda is set
-    MealyDFA *buildMealyDFA() const; // requires: mooreLambda is set
+    FA *buildFA() const &; // build DFA when possible, otherwise build NFA
+    DFA *buildDFA() const &; // requires: representsDFA() == true
+    NFA *buildNFA() const &; // always works
+    MooreDFA *buildMooreDFA() const &; // requires: mooreLambda is set
+    MealyDFA *buildMealyDFA() const &; // requires: mooreLambda is set
+
+    // same build methods for rvalue builders, e.g. std::move(fab).buildDFA():
+    //   they move S, V, F and delta into the automaton without any copies
+    //   and leave the builder cleared
+    FA *buildFA() &&;
+    DFA *buildDFA() &&;
+    NFA *buildNFA() &&;
+    MooreDFA *buildMooreDFA() &&;
+    MealyDFA *buildMealyDFA() &&;
 
     // finally, a clear method that allows reuse or the builder:
     void clear();
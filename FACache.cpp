@@ -0,0 +1,226 @@
+// FACache.cpp:                                                    2024
+// -----------
+// FACache is a persistent, content-addressed cache for the results of
+// expensive automaton transformations.
+//======================================================================
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+#include "Hashing.h"
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "FA.h"
+#include "DFA.h"
+#include "NFA.h"
+#include "CompiledDFA.h"
+#include "FACache.h"
+
+namespace fs = std::filesystem;
+
+
+ostream &operator<<(ostream &os, const FACacheStats &stats) {
+  os << stats.hits << " hits, " << stats.misses << " misses ("
+     << fixed << setprecision(1) << 100.0 * stats.hitRate()
+     << defaultfloat << "% hits), " << stats.stores << " stores, "
+     << stats.evictions << " evictions (" << stats.evictedBytes
+     << " bytes), " << stats.errors << " errors";
+  return os;
+} // operator<<
+
+
+// --- implementation of class FACache ---
+
+FACache::FACache(const string &dir, uint64_t maxBytes)
+: dir(dir), maxBytes(maxBytes) {
+  error_code ec;
+  fs::create_directories(dir, ec);
+  if (!fs::is_directory(dir, ec))
+    throw invalid_argument("cache directory \"" + dir + "\" not available");
+} // FACache::FACache
+
+
+static void hashString(uint64_t &h, const string &s) {
+  uint64_t len = s.size();    // length prefix, so concatenations differ
+  h = fnv1a64(&len, sizeof(len), h);
+  h = fnv1a64(s.data(), s.size(), h);
+} // hashString
+
+static void hashStateSet(uint64_t &h, const StateSet &sSet) {
+  uint64_t n = sSet.size();
+  h = fnv1a64(&n, sizeof(n), h);
+  for (const State &s: sSet)  // sorted, so the order is canonical
+    hashString(h, s);
+} // hashStateSet
+
+uint64_t FACache::keyOf(const FA &fa, const string &transformation) {
+  uint64_t h = fnvOffsetBasis;
+  hashString(h, transformation);
+  const NFA *nfa = dynamic_cast<const NFA *>(&fa);
+  const DFA *dfa = dynamic_cast<const DFA *>(&fa);
+  hashString(h, nfa != nullptr ? "NFA" : "DFA");
+  hashStateSet(h, fa.S);
+  hashString(h, string(fa.V.begin(), fa.V.end()));
+  hashString(h, fa.s1);
+  hashStateSet(h, fa.F);
+  if (nfa != nullptr)
+    for (const auto &row: nfa->delta)
+      for (const auto &e: row.second) {
+        hashString(h, row.first);
+        h = fnv1a64(&e.first, sizeof(e.first), h);
+        hashStateSet(h, e.second);
+      } // for
+  else if (dfa != nullptr)
+    for (const auto &row: dfa->delta)
+      for (const auto &e: row.second) {
+        hashString(h, row.first);
+        h = fnv1a64(&e.first, sizeof(e.first), h);
+        hashString(h, e.second);
+      } // for
+  return h;
+} // FACache::keyOf
+
+
+uint64_t FACache::keyOf(const Fingerprint &fp, const string &transformation) {
+  uint64_t h = fnvOffsetBasis;
+  hashString(h, transformation);
+  hashString(h, "canonical DFA");
+  h = fnv1a64(&fp.hi, sizeof(fp.hi), h);
+  h = fnv1a64(&fp.lo, sizeof(fp.lo), h);
+  return h;
+} // FACache::keyOf
+
+
+string FACache::fileNameOf(uint64_t key) const {
+  ostringstream oss;
+  oss << hex << setw(16) << setfill('0') << key << ".fai";
+  return (fs::path(dir) / oss.str()).string();
+} // FACache::fileNameOf
+
+
+bool FACache::contains(uint64_t key) const {
+  error_code ec;
+  return fs::exists(fileNameOf(key), ec);
+} // FACache::contains
+
+
+DFA *FACache::dfaFor(uint64_t key, const function<DFA *()> &compute) {
+  const string fileName = fileNameOf(key);
+  error_code ec;
+
+  // 1. hit: load the image and mark it as recently used
+  if (fs::exists(fileName, ec)) {
+    try {
+      DFA *dfa = CompiledDFA::load(fileName, true).dfaOf();
+      fs::last_write_time(fileName, fs::file_time_type::clock::now(), ec);
+      st.hits++;
+      return dfa;
+    } catch (const exception &) { // corrupt entry, recompute it
+      st.errors++;
+      fs::remove(fileName, ec);
+    } // catch
+  } // if
+
+  // 2. miss: compute and store via temp. file, so readers never see
+  //    partially written files
+  st.misses++;
+  DFA *dfa = compute();
+  const string tmpFileName = fileName + ".tmp" + to_string(random_device()());
+  try {
+    dfa->save(tmpFileName);
+    fs::rename(tmpFileName, fileName);
+    st.stores++;
+    evict();
+  } catch (const exception &) {   // result is still valid
+    st.errors++;
+    fs::remove(tmpFileName, ec);
+  } // catch
+  return dfa;
+} // FACache::dfaFor
+
+
+DFA *FACache::dfaOf(const NFA &nfa) {
+  return dfaFor(keyOf(nfa, "dfaOf"),
+                [&nfa]() { return nfa.dfaOf(); });
+} // FACache::dfaOf
+
+// the minimal DFAs of DFAs equal up to renaming are equal up to
+//   renaming, so the (names of the) first one are used for all of them
+DFA *FACache::minimalOf(const DFA &dfa) {
+  return dfaFor(keyOf(dfa.fingerprint(), "minimalOf"),
+                [&dfa]() { return dfa.minimalOf(); });
+} // FACache::minimalOf
+
+DFA *FACache::minimalDfaOf(const NFA &nfa) {
+  return dfaFor(keyOf(nfa, "dfaOf+minimalOf"),
+                [&nfa]() {
+                  unique_ptr<DFA> dfa(nfa.dfaOf());
+                  return dfa->minimalOf();
+                });
+} // FACache::minimalDfaOf
+
+
+struct CacheEntry {
+  fs::path            path;
+  uint64_t            size;
+  fs::file_time_type  time;
+}; // CacheEntry
+
+static vector<CacheEntry> entriesOf(const string &dir) {
+  vector<CacheEntry> entries;
+  error_code ec;
+  for (const auto &de: fs::directory_iterator(dir, ec)) {
+    if (!de.is_regular_file(ec) || de.path().extension() != ".fai")
+      continue;
+    entries.push_back({de.path(), (uint64_t)de.file_size(ec),
+                       de.last_write_time(ec)});
+  } // for
+  return entries;
+} // entriesOf
+
+uint64_t FACache::sizeInBytes() const {
+  uint64_t total = 0;
+  for (const CacheEntry &e: entriesOf(dir))
+    total += e.size;
+  return total;
+} // FACache::sizeInBytes
+
+void FACache::evict() {
+  vector<CacheEntry> entries = entriesOf(dir);
+  uint64_t total = 0;
+  for (const CacheEntry &e: entries)
+    total += e.size;
+  if (total <= maxBytes)
+    return;
+  sort(entries.begin(), entries.end(),
+       [](const CacheEntry &a, const CacheEntry &b) { return a.time < b.time; });
+  error_code ec;
+  for (const CacheEntry &e: entries) {
+    if (total <= maxBytes)
+      break;
+    if (fs::remove(e.path, ec)) {
+      total -= e.size;
+      st.evictions++;
+      st.evictedBytes += e.size;
+    } // if
+  } // for
+} // FACache::evict
+
+void FACache::clear() {
+  error_code ec;
+  for (const CacheEntry &e: entriesOf(dir))
+    fs::remove(e.path, ec);
+} // FACache::clear
+
+
+// end of FACache.cpp
+//======================================================================
@@ -0,0 +1,100 @@
+// FACache.h:                                                      2024
+// ---------
+// FACache is a persistent, content-addressed cache for the results of
+// expensive (but deterministic) transformations, e.g., NFA::dfaOf
+// followed by DFA::minimalOf:
+// *  the key is a hash of the complete input automaton (S, V, s1, F and
+//    delta) and the name of the transformation,
+// *  results are stored as binary images (cf. FAImage) in a directory,
+//    one file per key, so they are reused across runs and processes,
+// *  the least recently used files are evicted when the total size of
+//    the directory exceeds a limit.
+// Instances are not thread-safe, but several processes may share one
+// directory: files are written to a temporary file and then renamed.
+//======================================================================
+
+#pragma once
+#ifndef FACache_h
+#define FACache_h
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+
+#include "ObjectCounter.h"
+#include "Hashing.h"
+
+class FA;
+class DFA;
+class NFA;
+
+
+struct FACacheStats {
+  std::uint64_t hits         = 0;
+  std::uint64_t misses       = 0;
+  std::uint64_t stores       = 0;
+  std::uint64_t evictions    = 0; // nr. of evicted files
+  std::uint64_t evictedBytes = 0;
+  std::uint64_t errors       = 0; // corrupt or unreadable entries
+
+  double hitRate() const {
+    return (hits + misses == 0) ? 0.0 : (double)hits / (hits + misses);
+  } // hitRate
+}; // FACacheStats
+
+std::ostream &operator<<(std::ostream &os, const FACacheStats &stats);
+
+
+class FACache final
+        /*OC+*/ : private ObjectCounter<FACache> /*+OC*/ {
+
+    std::string   dir;
+    std::uint64_t maxBytes;
+    FACacheStats  st;
+
+    std::string fileNameOf(std::uint64_t key) const;
+    void evict(); // least recently used files until size <= maxBytes
+
+  public:
+
+    static constexpr std::uint64_t defaultMaxBytes = 256ULL << 20;
+
+    // creates directory dir if necessary
+    explicit FACache(const std::string &dir,
+                     std::uint64_t maxBytes = defaultMaxBytes);
+
+    FACache(const FACache  &c) = delete;
+    FACache(      FACache &&c) = delete;
+
+    ~FACache() = default;
+
+    // hash of the input automaton and the name of the transformation
+    static std::uint64_t keyOf(const FA &fa, const std::string &transformation);
+    // same for the canonical form of a DFA (cf. DFA::fingerprint), so
+    //   DFAs equal up to renaming of states share one entry
+    static std::uint64_t keyOf(const Fingerprint &fp, const std::string &transformation);
+
+    // result for key from cache (hit) or from compute() (miss, stored),
+    //   caller owns the result as for DFA::minimalOf etc.
+    DFA *dfaFor(std::uint64_t key, const std::function<DFA *()> &compute);
+
+    // cached versions of the common transformations
+    DFA *dfaOf(const NFA &nfa);                 // nfa.dfaOf()
+    DFA *minimalOf(const DFA &dfa);             // dfa.minimalOf(), canonical key
+    DFA *minimalDfaOf(const NFA &nfa);          // nfa.dfaOf()->minimalOf()
+
+    bool contains(std::uint64_t key) const;
+    std::uint64_t sizeInBytes() const;          // of all cached files
+    void clear();                               // removes all cached files
+
+    const FACacheStats &stats() const { return st; }
+    void resetStats() { st = FACacheStats(); }
+
+}; // FACache
+
+
+#endif
+
+// end of FACache.h
+//======================================================================
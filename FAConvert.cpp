@@ -0,0 +1,111 @@
+// FAConvert.cpp:                                                  2024
+// -------------
+// Command line converter from the text format of FABuilder to binary
+// images (cf. FAImage) of compiled automata, and inspection of images.
+//======================================================================
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+#include "Timer.h"
+#include "FA.h"
+#include "DFA.h"
+#include "NFA.h"
+#include "FABuilder.h"
+#include "FAImage.h"
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+
+
+static void usage() {
+  cerr << "usage: FAConvert [--dfa | --min] [--no-names] textFile imageFile" << endl
+       << "         converts FA in text format into binary image, as DFA when" << endl
+       << "         deterministic, else as NFA; --dfa: NFA => DFA, --min: minimal DFA" << endl
+       << "       FAConvert --info [--verify] imageFile" << endl
+       << "         prints the header of an image, --verify checks the checksum" << endl;
+} // usage
+
+
+static void printInfo(const string &imageFileName, bool verify) {
+  shared_ptr<const FAImage> img = FAImage::load(imageFileName, verify);
+  const FAImage::Header &h = img->header();
+  static const char *sectionName[FAImage::Header::nrOfSections] = {
+    "classes", "finals", "table", "rowStart", "dests",
+    "epsStart", "epsDests", "nameIdx", "names" };
+  cout << imageFileName << ": "
+       << (h.kind == FAImage::Header::dfaKind ? "DFA" : "NFA")
+       << " image, version " << h.version << endl
+       << "  states:   " << h.nStates  << endl
+       << "  classes:  " << h.nClasses << endl
+       << "  start:    " << h.start    << endl
+       << "  size:     " << h.fileSize << " bytes" << endl
+       << "  checksum: " << hex << h.checksum << dec
+       << (verify ? " (verified)" : "") << endl;
+  for (int s = 0; s < FAImage::Header::nrOfSections; s++)
+    if (h.size[s] > 0)
+      cout << "  section " << sectionName[s] << ": offset " << h.offset[s]
+           << ", " << h.size[s] << " bytes" << endl;
+} // printInfo
+
+
+static void convert(const string &textFileName, const string &imageFileName,
+                    bool toDfa, bool minimize, bool names) {
+  startTimer();
+  unique_ptr<FA> fa(FABuilder(textFileName).buildFA());
+  if (toDfa || minimize) {
+    if (NFA *nfa = dynamic_cast<NFA *>(fa.get()))
+      fa.reset(nfa->dfaOf());
+    if (minimize)
+      fa.reset(static_cast<DFA *>(fa.get())->minimalOf());
+  } // if
+  if (const DFA *dfa = dynamic_cast<const DFA *>(fa.get()))
+    CompiledDFA(*dfa, names).save(imageFileName);
+  else
+    CompiledNFA(*static_cast<const NFA *>(fa.get()), names).save(imageFileName);
+  stopTimer();
+  cout << textFileName << " => " << imageFileName << ": "
+       << fa->S.size() << " states, " << elapsedTime() << " s" << endl;
+} // convert
+
+
+int main(int argc, char *argv[]) {
+  bool info = false, verify = false, toDfa = false, minimize = false, names = true;
+  string files[2];
+  int nFiles = 0;
+  for (int i = 1; i < argc; i++) {
+    if      (strcmp(argv[i], "--info")     == 0) info     = true;
+    else if (strcmp(argv[i], "--verify")   == 0) verify   = true;
+    else if (strcmp(argv[i], "--dfa")      == 0) toDfa    = true;
+    else if (strcmp(argv[i], "--min")      == 0) minimize = true;
+    else if (strcmp(argv[i], "--no-names") == 0) names    = false;
+    else if (argv[i][0] != '-' && nFiles < 2)    files[nFiles++] = argv[i];
+    else {
+      usage();
+      return 2;
+    } // else
+  } // for
+  if ((info && nFiles != 1) || (!info && nFiles != 2)) {
+    usage();
+    return 2;
+  } // if
+
+  try {
+    if (info)
+      printInfo(files[0], verify);
+    else
+      convert(files[0], files[1], toDfa, minimize, names);
+  } catch (const exception &e) {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  } // catch
+  return 0;
+} // main
+
+
+// end of FAConvert.cpp
+//======================================================================
@@ -0,0 +1,295 @@
+// FAEquivalence.cpp:                                              2024
+// -----------------
+// Equivalence and inclusion checks for automata without minimization.
+//======================================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "DFA.h"
+#include "NFA.h"
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+#include "FAEquivalence.h"
+
+
+// --- DFAs: union-find over the product (Hopcroft and Karp) ---
+
+namespace {
+
+  // union-find with path halving and union by size
+  class UnionFind final {
+      vector<int> parent, size;
+    public:
+      explicit UnionFind(int n): parent(n), size(n, 1) {
+        for (int i = 0; i < n; i++)
+          parent[i] = i;
+      } // UnionFind
+      int find(int x) {
+        while (parent[x] != x)
+          x = parent[x] = parent[parent[x]];
+        return x;
+      } // find
+      bool unite(int x, int y) { // false if already in one set
+        x = find(x);
+        y = find(y);
+        if (x == y)
+          return false;
+        if (size[x] < size[y])
+          swap(x, y);
+        parent[y] = x;
+        size[x] += size[y];
+        return true;
+      } // unite
+  }; // UnionFind
+
+  // one representative symbol for each pair of classes (in a, in b)
+  template<typename A, typename B>
+  vector<TapeSymbol> jointSymbolsOf(const A &a, const B &b, bool onlyOfA) {
+    vector<TapeSymbol> syms;
+    vector<bool> seen(256 * 256, false);
+    for (int c = 0; c < 256; c++) { // all byte values, incl. eot
+      const int ca = a.classOf((TapeSymbol)c), cb = b.classOf((TapeSymbol)c);
+      if ((ca == 0 && (onlyOfA || cb == 0)) || seen[ca * 256 + cb])
+        continue;
+      seen[ca * 256 + cb] = true;
+      syms.push_back((TapeSymbol)c);
+    } // for
+    return syms;
+  } // jointSymbolsOf
+
+  // DFA with implicit sink state nrOfStates() for undefined transitions
+  struct TotalDFA {
+    const CompiledDFA &d;
+    const int sink;
+    explicit TotalDFA(const CompiledDFA &d): d(d), sink(d.nrOfStates()) {}
+    int next(int s, TapeSymbol tSy) const {
+      if (s == sink)
+        return sink;
+      const int n = d.next(s, tSy);
+      return n == CompiledDFA::undef ? sink : n;
+    } // next
+    bool isFinal(int s) const { return s != sink && d.isFinal(s); }
+  }; // TotalDFA
+
+  // plain BFS over the reachable pairs, first pair with different
+  //   finality yields a shortest counterexample
+  Tape shortestCounterexampleOf(const TotalDFA &a, const TotalDFA &b,
+                                const vector<TapeSymbol> &syms) {
+    struct Node { int p, q, parent; TapeSymbol tSy; };
+    vector<Node> nodes;
+    unordered_map<uint64_t, int> visited;
+    auto keyOf = [&](int p, int q) {
+      return (uint64_t)p * (uint64_t)(b.sink + 1) + (uint64_t)q;
+    }; // keyOf
+    nodes.push_back({a.d.startState(), b.d.startState(), -1, eot});
+    visited[keyOf(nodes[0].p, nodes[0].q)] = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+      const Node n = nodes[i];
+      if (a.isFinal(n.p) != b.isFinal(n.q)) {
+        Tape tape;
+        for (int j = (int)i; nodes[j].parent >= 0; j = nodes[j].parent)
+          tape += nodes[j].tSy;
+        reverse(tape.begin(), tape.end());
+        return tape;
+      } // if
+      for (TapeSymbol tSy: syms) {
+        const int p = a.next(n.p, tSy), q = b.next(n.q, tSy);
+        if (visited.emplace(keyOf(p, q), (int)nodes.size()).second)
+          nodes.push_back({p, q, (int)i, tSy});
+      } // for
+    } // for
+    return Tape(); // not reached for non-equivalent DFAs
+  } // shortestCounterexampleOf
+
+} // namespace
+
+
+bool equivalent(const CompiledDFA &a, const CompiledDFA &b, Tape *counterexample) {
+  const TotalDFA ta(a), tb(b);
+  const vector<TapeSymbol> syms = jointSymbolsOf(a, b, false);
+  const int offB = ta.sink + 1; // ids of b's states in union-find
+
+  UnionFind uf(offB + tb.sink + 1);
+  vector<pair<int, int>> todo;   // pairs to be checked
+  uf.unite(a.startState(), offB + b.startState());
+  todo.emplace_back(a.startState(), b.startState());
+  bool eq = true;
+  while (!todo.empty()) {
+    const auto [p, q] = todo.back();
+    todo.pop_back();
+    if (ta.isFinal(p) != tb.isFinal(q)) {
+      eq = false;
+      break;
+    } // if
+    for (TapeSymbol tSy: syms) {
+      const int pn = ta.next(p, tSy), qn = tb.next(q, tSy);
+      if (uf.unite(pn, offB + qn))
+        todo.emplace_back(pn, qn);
+    } // for
+  } // while
+
+  if (!eq && counterexample != nullptr)
+    *counterexample = shortestCounterexampleOf(ta, tb, syms);
+  return eq;
+} // equivalent
+
+bool equivalent(const DFA &a, const DFA &b, Tape *counterexample) {
+  if (a.fingerprint() == b.fingerprint())
+    return true;             // equal up to renaming of states
+  return equivalent(CompiledDFA(a, false), CompiledDFA(b, false), counterexample);
+} // equivalent
+
+
+// --- NFAs: inclusion via antichains ---
+
+namespace {
+
+  typedef CompiledNFA::StateId StateId;
+
+  // computes epsilon closures into sorted vectors, reusing its marks
+  class Closure final {
+      const CompiledNFA &n;
+      vector<unsigned> mark;
+      unsigned stamp = 0;
+      vector<StateId> stack;
+    public:
+      explicit Closure(const CompiledNFA &n): n(n), mark(n.nrOfStates(), 0) {}
+      void start() { // new, empty result
+        if (++stamp == 0) {
+          fill(mark.begin(), mark.end(), 0);
+          stamp = 1;
+        } // if
+      } // start
+      void add(StateId s, vector<StateId> &result) { // s and its closure
+        if (mark[s] == stamp)
+          return;
+        mark[s] = stamp;
+        result.push_back(s);
+        stack.push_back(s);
+        while (!stack.empty()) {
+          const StateId t = stack.back();
+          stack.pop_back();
+          const auto ed = n.epsDestsOf(t);
+          for (const StateId *d = ed.first; d != ed.second; d++)
+            if (mark[*d] != stamp) {
+              mark[*d] = stamp;
+              result.push_back(*d);
+              stack.push_back(*d);
+            } // if
+        } // while
+      } // add
+  }; // Closure
+
+} // namespace
+
+
+bool includedIn(const CompiledNFA &a, const CompiledNFA &b, Tape *counterexample) {
+  const vector<TapeSymbol> syms = jointSymbolsOf(a, b, true);
+  Closure closureA(a), closureB(b);
+
+  struct Node { StateId p; int parent; TapeSymbol tSy; bool dead; };
+  vector<Node> nodes;
+  vector<vector<StateId>> sets;           // state set of b for each node
+  vector<vector<int>> antichain(a.nrOfStates()); // p -> nodes with minimal sets
+
+  auto rejectedByB = [&](const vector<StateId> &q) {
+    for (StateId s: q)
+      if (b.isFinal(s))
+        return false;
+    return true;
+  }; // rejectedByB
+
+  int bad = -1;                           // node of counterexample
+  // adds (p, q) unless a pair (p, q') with q' <= q is known
+  auto add = [&](StateId p, const vector<StateId> &q, int parent, TapeSymbol tSy) {
+    vector<int> &chain = antichain[p];
+    for (int i: chain)
+      if (includes(q.begin(), q.end(), sets[i].begin(), sets[i].end()))
+        return;                           // subsumed by smaller set
+    chain.erase(remove_if(chain.begin(), chain.end(), [&](int i) {
+                  if (includes(sets[i].begin(), sets[i].end(), q.begin(), q.end()))
+                    return nodes[i].dead = true;
+                  return false;
+                }), chain.end());
+    chain.push_back((int)nodes.size());
+    nodes.push_back({p, parent, tSy, false});
+    sets.push_back(q);
+    if (bad < 0 && a.isFinal(p) && rejectedByB(q))
+      bad = (int)nodes.size() - 1;
+  }; // add
+
+  vector<StateId> q0, pStarts;
+  closureB.start();
+  closureB.add(b.startState(), q0);
+  sort(q0.begin(), q0.end());
+  closureA.start();
+  closureA.add(a.startState(), pStarts);
+  for (StateId p: pStarts)
+    add(p, q0, -1, eot);
+
+  vector<StateId> qn, pn;
+  for (size_t i = 0; i < nodes.size() && bad < 0; i++) { // BFS
+    if (nodes[i].dead)
+      continue;
+    const StateId p = nodes[i].p;
+    for (TapeSymbol tSy: syms) {
+      const auto da = a.destsOf(p, a.classOf(tSy));
+      if (da.first == da.second)
+        continue;
+      qn.clear();
+      closureB.start();
+      if (b.classOf(tSy) != 0)
+        for (StateId q: sets[i]) {
+          const auto db = b.destsOf(q, b.classOf(tSy));
+          for (const StateId *d = db.first; d != db.second; d++)
+            closureB.add(*d, qn);
+        } // for
+      sort(qn.begin(), qn.end());
+      pn.clear();
+      closureA.start();
+      for (const StateId *d = da.first; d != da.second; d++)
+        closureA.add(*d, pn);
+      for (StateId pd: pn)
+        add(pd, qn, (int)i, tSy);
+    } // for
+  } // for
+
+  if (bad >= 0 && counterexample != nullptr) {
+    Tape tape;
+    for (int j = bad; nodes[j].parent >= 0; j = nodes[j].parent)
+      tape += nodes[j].tSy;
+    reverse(tape.begin(), tape.end());
+    *counterexample = tape;
+  } // if
+  return bad < 0;
+} // includedIn
+
+bool includedIn(const NFA &a, const NFA &b, Tape *counterexample) {
+  return includedIn(CompiledNFA(a, false), CompiledNFA(b, false), counterexample);
+} // includedIn
+
+bool includedIn(const DFA &a, const NFA &b, Tape *counterexample) {
+  return includedIn(CompiledNFA(a, false), CompiledNFA(b, false), counterexample);
+} // includedIn
+
+bool includedIn(const NFA &a, const DFA &b, Tape *counterexample) {
+  return includedIn(CompiledNFA(a, false), CompiledNFA(b, false), counterexample);
+} // includedIn
+
+bool equivalent(const NFA &a, const NFA &b, Tape *counterexample) {
+  const CompiledNFA ca(a, false), cb(b, false);
+  return includedIn(ca, cb, counterexample) &&
+         includedIn(cb, ca, counterexample);
+} // equivalent
+
+
+// end of FAEquivalence.cpp
+//======================================================================
@@ -0,0 +1,44 @@
+// FAEquivalence.h:                                                2024
+// ---------------
+// Equivalence and inclusion checks for automata without minimization:
+// *  DFAs: union-find over the product state space (Hopcroft and Karp),
+//    explored lazily from the pair of start states, near linear,
+// *  NFAs: inclusion L(a) <= L(b) on pairs (state of a, state set of b),
+//    pruned by antichains, so b is determinized on demand only.
+// Partial transition functions are handled via implicit sink states.
+// On failure, a counterexample tape (in exactly one of the languages)
+// is returned: for DFAs a shortest one.
+//======================================================================
+
+#pragma once
+#ifndef FAEquivalence_h
+#define FAEquivalence_h
+
+#include "TapeStuff.h"
+
+class DFA;
+class NFA;
+class CompiledDFA;
+class CompiledNFA;
+
+
+// L(a) == L(b)? fingerprints are used for a quick pre-check
+bool equivalent(const DFA &a, const DFA &b, Tape *counterexample = nullptr);
+bool equivalent(const CompiledDFA &a, const CompiledDFA &b,
+                Tape *counterexample = nullptr);
+
+// L(a) <= L(b)? counterexample is in L(a) but not in L(b)
+bool includedIn(const NFA &a, const NFA &b, Tape *counterexample = nullptr);
+bool includedIn(const DFA &a, const NFA &b, Tape *counterexample = nullptr);
+bool includedIn(const NFA &a, const DFA &b, Tape *counterexample = nullptr);
+bool includedIn(const CompiledNFA &a, const CompiledNFA &b,
+                Tape *counterexample = nullptr);
+
+// L(a) == L(b)? via inclusion in both directions
+bool equivalent(const NFA &a, const NFA &b, Tape *counterexample = nullptr);
+
+
+#endif
+
+// end of FAEquivalence.h
+//======================================================================
@@ -0,0 +1,131 @@
+// FAImage.cpp:                                                    2024
+// -----------
+// FAImage is the versioned binary format for compiled automata.
+//======================================================================
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+using namespace std;
+
+#include "Hashing.h"
+#include "MappedFile.h"
+#include "FAImage.h"
+
+
+// --- implementation of class FAImage::Writer ---
+
+FAImage::Writer::Writer(Header::Kind kind, uint32_t nStates,
+                        uint32_t nClasses, int32_t start) {
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, Header::magicValue, sizeof(hdr.magic));
+  hdr.version   = Header::currentVersion;
+  hdr.byteOrder = Header::byteOrderMark;
+  hdr.kind      = kind;
+  hdr.nStates   = nStates;
+  hdr.nClasses  = nClasses;
+  hdr.start     = start;
+} // FAImage::Writer::Writer
+
+
+void FAImage::Writer::addSection(Header::Section s,
+                                 const void *data, size_t size) {
+  if (size == 0)
+    return;                  // absent sections have offset = size = 0
+  while ((Header::headerSize + bytes.size()) % Header::alignment != 0)
+    bytes.push_back(0);      // padding to next cache line
+  hdr.offset[s] = Header::headerSize + bytes.size();
+  hdr.size  [s] = size;
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  bytes.insert(bytes.end(), p, p + size);
+} // FAImage::Writer::addSection
+
+
+shared_ptr<const FAImage> FAImage::Writer::image() const {
+  shared_ptr<FAImage> img(new FAImage());
+  img->len    = Header::headerSize + bytes.size();
+  img->buffer = static_cast<unsigned char *>(
+                  ::operator new(img->len, align_val_t(Header::alignment)));
+  Header h = hdr;
+  h.fileSize = img->len;
+  h.checksum = fnv1a64(bytes.data(), bytes.size());
+  memset(img->buffer, 0, Header::headerSize);
+  memcpy(img->buffer, &h, sizeof(h));
+  if (!bytes.empty())
+    memcpy(img->buffer + Header::headerSize, bytes.data(), bytes.size());
+  img->base = img->buffer;
+  return img;
+} // FAImage::Writer::image
+
+
+// --- implementation of class FAImage ---
+
+static void checkImage(bool condition, const string &fileName,
+                       const string &msg) {
+  if (!condition)
+    throw runtime_error("invalid automaton image \"" + fileName + "\": " + msg);
+} // checkImage
+
+shared_ptr<const FAImage> FAImage::load(const string &fileName,
+                                        bool verifyChecksum) {
+  shared_ptr<FAImage> img(new FAImage());
+  img->mf   = make_unique<MappedFile>(fileName); // throws if not found
+  img->base = reinterpret_cast<const unsigned char *>(img->mf->data());
+  img->len  = img->mf->size();
+  if (reinterpret_cast<uintptr_t>(img->base) % Header::alignment != 0) {
+    // read into a plain buffer (no mmap), so copy to an aligned one
+    img->buffer = static_cast<unsigned char *>(
+                    ::operator new(img->len, align_val_t(Header::alignment)));
+    memcpy(img->buffer, img->base, img->len);
+    img->base = img->buffer;
+    img->mf.reset();
+  } // if
+
+  checkImage(img->len >= Header::headerSize, fileName, "too short");
+  const Header &h = img->header();
+  checkImage(memcmp(h.magic, Header::magicValue, sizeof(h.magic)) == 0,
+             fileName, "wrong magic number");
+  checkImage(h.byteOrder == Header::byteOrderMark, fileName, "wrong byte order");
+  checkImage(h.version == Header::currentVersion, fileName,
+             "unsupported version " + to_string(h.version));
+  checkImage(h.kind == Header::dfaKind || h.kind == Header::nfaKind,
+             fileName, "unknown kind of automaton");
+  checkImage(h.fileSize == img->len, fileName, "wrong file size");
+  for (int s = 0; s < Header::nrOfSections; s++)
+    checkImage(h.size[s] == 0 ||
+               (h.offset[s] >= Header::headerSize &&
+                h.offset[s] % Header::alignment == 0 &&
+                h.offset[s] + h.size[s] <= h.fileSize),
+               fileName, "section " + to_string(s) + " out of bounds");
+  if (verifyChecksum)
+    checkImage(img->checksumOK(), fileName, "checksum mismatch");
+  return img;
+} // FAImage::load
+
+
+FAImage::~FAImage() {
+  if (buffer != nullptr)
+    ::operator delete(buffer, align_val_t(Header::alignment));
+} // FAImage::~FAImage
+
+
+uint64_t FAImage::computedChecksum() const {
+  return fnv1a64(base + Header::headerSize, len - Header::headerSize);
+} // FAImage::computedChecksum
+
+
+void FAImage::save(const string &fileName) const {
+  ofstream ofs(fileName, ios::binary);
+  if (!ofs.good())
+    throw runtime_error("error on opening output file \"" + fileName + "\"");
+  ofs.write(reinterpret_cast<const char *>(base), (streamsize)len);
+  if (!ofs.good())
+    throw runtime_error("error on writing output file \"" + fileName + "\"");
+} // FAImage::save
+
+
+// end of FAImage.cpp
+//======================================================================
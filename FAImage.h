@@ -0,0 +1,152 @@
+// FAImage.h:                                                      2024
+// ---------
+// FAImage is the versioned binary format for compiled automata
+// (CompiledDFA and CompiledNFA): one header followed by sections, all
+// sections aligned to cache lines, so an image file can be mmap'd and
+// used in place without any parsing.
+//
+// Layout (native byte order, checked via byteOrder on load):
+//   header   magic, version, kind, sizes, start, checksum and the
+//            offset and size of each section (0 for absent sections)
+//   classes  unsigned char[256]            symbol -> class
+//   finals   uint64_t[(nStates + 63) / 64]  bitmap of final states
+//   DFA:
+//   table    int32_t[nStates * nClasses]   premult. row offset, -1 or
+//                                          -offset - 2 (escape bytes)
+//   accel    unsigned char[nStates * 4]    nr. of escape bytes (0 .. 3,
+//                                          254: loop scan, 255: none)
+//                                          and escape bytes
+//   NFA:
+//   rowStart uint32_t[nStates*nClasses+1]  CSR index into dests ...
+//   dests    int32_t[]                     ... for (state, class)
+//   epsStart uint32_t[nStates + 1]         CSR index into epsDests ...
+//   epsDests int32_t[]                     ... for epsilon transitions
+//   optional state name table:
+//   nameIdx  uint32_t[nStates + 1]         start of each name in ...
+//   names    char[]                        ... the concatenated names
+// The checksum is FNV-1a over all bytes after the header.
+//======================================================================
+
+#pragma once
+#ifndef FAImage_h
+#define FAImage_h
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ObjectCounter.h"
+
+class MappedFile;
+
+
+struct FAImageHeader {
+
+  enum Kind    { dfaKind = 1, nfaKind = 2 };
+  enum Section { classes, finals, table, rowStart, dests,
+                 epsStart, epsDests, nameIdx, names, accel, nrOfSections };
+
+  static constexpr char          magicValue[8]  = {'F', 'A', 'I', 'M', 'A', 'G', 'E', '\0'};
+  static constexpr std::uint32_t currentVersion = 4;
+  static constexpr std::uint32_t byteOrderMark  = 0x01020304;
+  static constexpr std::size_t   headerSize     = 256; // incl. padding
+  static constexpr std::size_t   alignment      = 64;  // of sections
+
+  char          magic[8];
+  std::uint32_t version;
+  std::uint32_t byteOrder;
+  std::uint32_t kind;
+  std::uint32_t nStates;
+  std::uint32_t nClasses;
+  std::int32_t  start;
+  std::uint64_t fileSize;
+  std::uint64_t checksum;
+  std::uint64_t offset[nrOfSections];
+  std::uint64_t size  [nrOfSections];
+
+}; // FAImageHeader
+
+static_assert(sizeof(FAImageHeader) <= FAImageHeader::headerSize,
+              "FAImageHeader does not fit into its padded size");
+
+
+class FAImage final
+        /*OC+*/ : private ObjectCounter<FAImage> /*+OC*/ {
+
+  public:
+
+    typedef FAImageHeader Header;
+
+    // assembles an image in memory, section by section
+    class Writer final {
+
+        Header hdr;
+        std::vector<unsigned char> bytes; // without header
+
+      public:
+
+        Writer(Header::Kind kind, std::uint32_t nStates,
+               std::uint32_t nClasses, std::int32_t start);
+
+        void addSection(Header::Section s, const void *data, std::size_t size);
+
+        template<typename T>
+        void addSection(Header::Section s, const std::vector<T> &v) {
+          addSection(s, v.data(), v.size() * sizeof(T));
+        } // addSection
+
+        std::shared_ptr<const FAImage> image() const;
+
+    }; // Writer
+
+  private:
+
+    unsigned char *buffer = nullptr;  // aligned in-memory image or ...
+    std::unique_ptr<MappedFile> mf;   // ... mmap'd image file (page
+                                      //   aligned, else copied to buffer)
+    const unsigned char *base = nullptr;
+    std::size_t          len  = 0;
+
+    FAImage() = default;
+
+  public:
+
+    // maps the file, checks header and section bounds only (O(1)),
+    //   verifyChecksum additionally reads the whole image (O(size))
+    static std::shared_ptr<const FAImage> load(const std::string &fileName,
+                                               bool verifyChecksum = false);
+
+    FAImage(const FAImage  &img) = delete;
+    FAImage(      FAImage &&img) = delete;
+
+    ~FAImage();
+
+    const Header &header() const {
+      return *reinterpret_cast<const Header *>(base);
+    } // header
+
+    bool hasSection(Header::Section s) const { return header().size[s] > 0; }
+
+    template<typename T>
+    const T *section(Header::Section s) const {
+      return hasSection(s) ?
+             reinterpret_cast<const T *>(base + header().offset[s]) : nullptr;
+    } // section
+
+    const unsigned char *data() const { return base; }
+    std::size_t          size() const { return len;  }
+
+    std::uint64_t computedChecksum() const;
+    bool checksumOK() const { return computedChecksum() == header().checksum; }
+
+    void save(const std::string &fileName) const;
+
+}; // FAImage
+
+
+#endif
+
+// end of FAImage.h
+//======================================================================
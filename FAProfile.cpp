@@ -0,0 +1,194 @@
+// FAProfile.cpp:                                                  2024
+// -------------
+// Opt-in profiling for the acceptance methods of DFA and NFA:
+// FAProfiler counts visits per state and firings per (state, symbol)
+//   transition in thread-local counter arrays, FAProfile holds a merged
+//   snapshot of these counters.
+//======================================================================
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "FA.h"
+#include "FAProfile.h"
+
+
+// --- implementation of class FAProfile ---
+
+int FAProfile::colOf(TapeSymbol tSy) const {
+  auto it = find(symbols.begin(), symbols.end(), tSy);
+  return it == symbols.end() ? -1 : (int)(it - symbols.begin());
+} // FAProfile::colOf
+
+
+FAProfile::Count FAProfile::visitsOf(const State &s) const {
+  auto it = rowOf.find(s);
+  return it == rowOf.end() ? 0 : visits[it->second];
+} // FAProfile::visitsOf
+
+FAProfile::Count FAProfile::firingsOf(const State &src, TapeSymbol tSy) const {
+  auto it  = rowOf.find(src);
+  int  col = colOf(tSy);
+  if (it == rowOf.end() || col < 0)
+    return 0;
+  return firings[it->second * symbols.size() + col];
+} // FAProfile::firingsOf
+
+
+FAProfile::Count FAProfile::maxVisits() const {
+  return visits.empty() ? 0 : *max_element(visits.begin(), visits.end());
+} // FAProfile::maxVisits
+
+FAProfile::Count FAProfile::maxFirings() const {
+  return firings.empty() ? 0 : *max_element(firings.begin(), firings.end());
+} // FAProfile::maxFirings
+
+
+StateSet FAProfile::unvisitedStates() const {
+  StateSet uvs;
+  for (size_t i = 0; i < states.size(); i++)
+    if (visits[i] == 0)
+      uvs.insert(states[i]);
+  return uvs;
+} // FAProfile::unvisitedStates
+
+
+void FAProfile::writeTable(ostream &os) const {
+  int w = 6;                 // at least the width of "state "
+  for (const State &s: states)
+    w = max<int>(w, (int)s.length() + 1);
+  os << "profile of " << runs << " run(s):" << endl;
+  os << left << setw(w) << "state" << right << setw(12) << "visits" << " |";
+  for (TapeSymbol tSy: symbols)
+    os << setw(10) << stringOf(tSy);
+  os << endl;
+  os << string(w + 14 + 10 * symbols.size(), '-') << endl;
+  for (size_t i = 0; i < states.size(); i++) {
+    os << left << setw(w) << states[i] << right << setw(12) << visits[i] << " |";
+    for (size_t j = 0; j < symbols.size(); j++)
+      os << setw(10) << firings[i * symbols.size() + j];
+    os << endl;
+  } // for
+} // FAProfile::writeTable
+
+
+ostream &operator<<(ostream &os, const FAProfile &p) {
+  p.writeTable(os);
+  return os;
+} // operator<<
+
+
+// --- implementation of class FAProfiler ---
+
+static atomic<unsigned long> nextProfilerId(1);
+
+FAProfiler::Counters::Counters(size_t nRows, size_t nCols)
+: nCols(nCols),
+  visits (new atomic<Count>[nRows]),
+  firings(new atomic<Count>[nRows * nCols]),
+  runs(0) {
+  for (size_t i = 0; i < nRows; i++)
+    visits[i].store(0, memory_order_relaxed);
+  for (size_t i = 0; i < nRows * nCols; i++)
+    firings[i].store(0, memory_order_relaxed);
+} // FAProfiler::Counters::Counters
+
+
+FAProfiler::FAProfiler(const FA &fa)
+: id(nextProfilerId++),
+  states(fa.S.begin(), fa.S.end()),
+  symbols(fa.V.begin(), fa.V.end()) {
+  symbols.push_back(eps); // NFAs may fire epsilon transitions, too
+  for (size_t i = 0; i < states.size(); i++)
+    index[states[i]] = (int)i;
+  fill(begin(colIdx), end(colIdx), -1);
+  for (size_t j = 0; j < symbols.size(); j++)
+    colIdx[(unsigned char)symbols[j]] = (int)j;
+  startRow = indexOf(fa.s1);
+  finalRows.assign(states.size(), false);
+  for (const State &f: fa.F)
+    if (indexOf(f) >= 0)
+      finalRows[indexOf(f)] = true;
+  destStart.push_back(0);
+  for (const State &s: states)
+    for (TapeSymbol tSy: symbols) {
+      for (const State &d: fa.deltaAt(s, tSy))
+        destRows.push_back(indexOf(d));
+      destStart.push_back((int)destRows.size());
+    } // for
+} // FAProfiler::FAProfiler
+
+
+int FAProfiler::indexOf(const State &s) const {
+  auto it = index.find(s);
+  return it == index.end() ? -1 : it->second;
+} // FAProfiler::indexOf
+
+
+FAProfiler::Counters &FAProfiler::localCounters() {
+  // per thread: a one-element cache in front of a map profiler id -> counters,
+  //   ids are never reused, so entries of destroyed profilers never match
+  thread_local unsigned long lastId = 0;
+  thread_local Counters     *last   = nullptr;
+  thread_local unordered_map<unsigned long, weak_ptr<Counters>> counters;
+  if (lastId == id)
+    return *last;
+  shared_ptr<Counters> c = counters[id].lock();
+  if (!c) {
+    c = make_shared<Counters>(states.size(), symbols.size());
+    {
+      lock_guard<mutex> lock(mtx);
+      allCounters.push_back(c);
+    }
+    for (auto it = counters.begin(); it != counters.end(); )
+      if (it->second.expired())
+        it = counters.erase(it); // profiler has gone
+      else
+        it++;
+    counters[id] = c;
+  } // if
+  lastId = id;
+  last   = c.get();
+  return *last;
+} // FAProfiler::localCounters
+
+
+FAProfile FAProfiler::profile() const {
+  FAProfile p;
+  p.states  = states;
+  p.symbols = symbols;
+  p.visits .assign(states.size(), 0);
+  p.firings.assign(states.size() * symbols.size(), 0);
+  for (size_t i = 0; i < states.size(); i++)
+    p.rowOf[states[i]] = (int)i;
+  lock_guard<mutex> lock(mtx);
+  for (const auto &c: allCounters) {
+    p.runs += c->runs.load(memory_order_relaxed);
+    for (size_t i = 0; i < p.visits.size(); i++)
+      p.visits[i] += c->visits[i].load(memory_order_relaxed);
+    for (size_t i = 0; i < p.firings.size(); i++)
+      p.firings[i] += c->firings[i].load(memory_order_relaxed);
+  } // for
+  return p;
+} // FAProfiler::profile
+
+
+void FAProfiler::reset() {
+  lock_guard<mutex> lock(mtx);
+  for (const auto &c: allCounters) {
+    c->runs.store(0, memory_order_relaxed);
+    for (size_t i = 0; i < states.size(); i++)
+      c->visits[i].store(0, memory_order_relaxed);
+    for (size_t i = 0; i < states.size() * symbols.size(); i++)
+      c->firings[i].store(0, memory_order_relaxed);
+  } // for
+} // FAProfiler::reset
+
+
+// end of FAProfile.cpp
+//======================================================================
@@ -0,0 +1,162 @@
+// FAProfile.h:                                                    2024
+// -----------
+// Opt-in profiling for the acceptance methods of DFA and NFA:
+// FAProfiler counts visits per state and firings per (state, symbol)
+//   transition; each thread counts in its own counter arrays, so the
+//   accepts loop never contends, the arrays are merged on demand only.
+// FAProfile holds such a merged snapshot, it can be written as table
+//   and is used by FA::genGraphVizFile to draw a heat-coloured graph.
+//======================================================================
+
+#pragma once
+#ifndef FAProfile_h
+#define FAProfile_h
+
+#include <atomic>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "StateStuff.h"
+
+class FA;
+
+
+// --- class FAProfile: merged snapshot of the counters ---
+
+class FAProfile final
+        /*OC+*/ : private ObjectCounter<FAProfile> /*+OC*/ {
+
+  friend class FAProfiler; // the one and only producer of FAProfiles
+
+  public:
+
+    typedef unsigned long long Count;
+
+  private:
+
+    std::vector<State>      states;  // rows,    in order of FA::S
+    std::vector<TapeSymbol> symbols; // columns, in order of FA::V (+ eps)
+    std::vector<Count>      visits;  // visits[row]
+    std::vector<Count>      firings; // firings[row * symbols.size() + col]
+    std::map<State, int>    rowOf;
+    Count                   runs = 0;
+
+    int colOf(TapeSymbol tSy) const;
+
+  public:
+
+    Count nrOfRuns() const { return runs; }
+
+    Count visitsOf (const State &s) const;
+    Count firingsOf(const State &src, TapeSymbol tSy) const;
+
+    Count maxVisits () const;
+    Count maxFirings() const;
+
+    StateSet unvisitedStates() const; // candidates for dead rules
+
+    // one row per state, one column per tape symbol
+    void writeTable(std::ostream &os) const;
+
+}; // FAProfile
+
+std::ostream &operator<<(std::ostream &os, const FAProfile &p);
+
+
+// --- class FAProfiler: collects the counts of accepts runs ---
+
+class FAProfiler final
+        /*OC+*/ : private ObjectCounter<FAProfiler> /*+OC*/ {
+
+  public:
+
+    typedef FAProfile::Count Count;
+
+    // counter arrays of one thread, written by this thread only
+    class Counters final {
+
+      friend class FAProfiler;
+
+        const size_t nCols;
+        std::unique_ptr<std::atomic<Count>[]> visits, firings;
+        std::atomic<Count> runs;
+
+        static void inc(std::atomic<Count> &c) { // single writer, so ...
+          c.store(c.load(std::memory_order_relaxed) + 1, // ... no lock
+                  std::memory_order_relaxed);
+        } // inc
+
+      public:
+
+        Counters(size_t nRows, size_t nCols);
+
+        void runStarted() { inc(runs); }
+
+        void stateEntered(int s) { inc(visits[s]); }
+
+        void transitionFired(int src, int col) {
+          if (col >= 0)
+            inc(firings[src * nCols + col]);
+        } // transitionFired
+
+    }; // Counters
+
+  private:
+
+    const unsigned long id;                 // unique, never reused
+    std::vector<State>         states;
+    std::vector<TapeSymbol>    symbols;
+    std::unordered_map<State, int> index;   // state -> row
+    int                        colIdx[256]; // symbol -> col, -1 if none
+    int                        startRow;
+    std::vector<bool>          finalRows;
+    std::vector<int>           destStart;   // CSR per (row, col) ...
+    std::vector<int>           destRows;    // ... of the dest rows
+
+    mutable std::mutex mtx; // protects allCounters only
+    std::vector<std::shared_ptr<Counters>> allCounters;
+
+  public:
+
+    explicit FAProfiler(const FA &fa);
+
+    FAProfiler(const FAProfiler  &p) = delete;
+    FAProfiler(      FAProfiler &&p) = delete;
+
+    ~FAProfiler() override = default;
+
+    int indexOf(const State &s) const;   // -1 for undefined states
+
+    int colOf(TapeSymbol tSy) const {
+      return colIdx[(unsigned char)tSy];
+    } // colOf
+
+    // delta on rows and cols, resolved once, so profiled runs do
+    //   no lookups of state names at all
+    int  startRowOf()        const { return startRow; }
+    bool isFinalRow(int row) const { return finalRows[row]; }
+    std::pair<const int *, const int *> destRowsOf(int row, int col) const {
+      const size_t e = (size_t)row * symbols.size() + col;
+      return {destRows.data() + destStart[e], destRows.data() + destStart[e + 1]};
+    } // destRowsOf
+
+    Counters &localCounters(); // counter arrays of the calling thread
+
+    FAProfile profile() const; // merges the counters of all threads
+
+    void reset();
+
+}; // FAProfiler
+
+
+#endif
+
+// end of FAProfile.h
+//======================================================================
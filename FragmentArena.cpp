@@ -0,0 +1,271 @@
+// FragmentArena.cpp:                                              2024
+// -----------------
+// FragmentArena holds NFA fragments on integer state ids and combines
+// them with the operators of Kleene algebra in the style of Thompson.
+//======================================================================
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "NFA.h"
+#include "FABuilder.h"
+#include "CompiledNFA.h"
+#include "FragmentArena.h"
+
+
+FragmentArena::StateId FragmentArena::newState() {
+  head.push_back(-1);
+  return (StateId)head.size() - 1;
+} // FragmentArena::newState
+
+void FragmentArena::addEdge(StateId src, const SymbolSet &label, StateId dest) {
+  edges.push_back({dest, head[src], label});
+  head[src] = (int)edges.size() - 1;
+} // FragmentArena::addEdge
+
+FragmentArena::Fragment FragmentArena::fragmentOf(StateId start, StateId end) {
+  frags.push_back({start, end, false});
+  return Fragment{(int)frags.size() - 1};
+} // FragmentArena::fragmentOf
+
+FragmentArena::Frag FragmentArena::take(Fragment f) {
+  if (f.id < 0 || f.id >= (int)frags.size())
+    throw invalid_argument("fragment of another arena");
+  if (frags[f.id].used)
+    throw logic_error("fragment used twice");
+  frags[f.id].used = true;
+  return frags[f.id];
+} // FragmentArena::take
+
+// the states of an unused fragment are exactly those reachable from its
+//   start, as fragments are connected by combinators only
+FragmentArena::Fragment FragmentArena::copyOf(Frag f) {
+  unordered_map<StateId, StateId> copy;
+  vector<StateId> stack{f.start};
+  copy.emplace(f.start, newState());
+  while (!stack.empty()) {
+    const StateId s = stack.back();
+    stack.pop_back();
+    for (int e = head[s]; e >= 0; e = edges[e].next) {
+      const StateId d = edges[e].dest;
+      auto ir = copy.emplace(d, -1);
+      if (ir.second) {
+        ir.first->second = newState();
+        stack.push_back(d);
+      } // if
+      addEdge(copy[s], edges[e].label, ir.first->second);
+    } // for
+  } // while
+  if (copy.find(f.end) == copy.end()) // end not reachable
+    copy.emplace(f.end, newState());
+  return fragmentOf(copy[f.start], copy[f.end]);
+} // FragmentArena::copyOf
+
+
+void FragmentArena::reserve(size_t nStates, size_t nTransitions) {
+  head.reserve(nStates);
+  edges.reserve(nTransitions);
+} // FragmentArena::reserve
+
+
+// --- atoms ---
+
+FragmentArena::Fragment FragmentArena::empty() {
+  const StateId s = newState();
+  return fragmentOf(s, s);
+} // FragmentArena::empty
+
+FragmentArena::Fragment FragmentArena::symbol(TapeSymbol tSy) {
+  SymbolSet syms;
+  syms.set((unsigned char)tSy);
+  return symbols(syms);
+} // FragmentArena::symbol
+
+FragmentArena::Fragment FragmentArena::symbols(const SymbolSet &syms) {
+  const StateId s = newState(), e = newState();
+  if (syms.any())
+    addEdge(s, syms, e);
+  return fragmentOf(s, e);
+} // FragmentArena::symbols
+
+FragmentArena::Fragment FragmentArena::literal(const string &str) {
+  const StateId s = newState();
+  StateId e = s;
+  for (char ch: str) {
+    SymbolSet syms;
+    syms.set((unsigned char)ch);
+    const StateId d = newState();
+    addEdge(e, syms, d);
+    e = d;
+  } // for
+  return fragmentOf(s, e);
+} // FragmentArena::literal
+
+
+// --- combinators ---
+
+FragmentArena::Fragment FragmentArena::concat(Fragment a, Fragment b) {
+  const Frag fa = take(a), fb = take(b);
+  addEdge(fa.end, SymbolSet(), fb.start);
+  return fragmentOf(fa.start, fb.end);
+} // FragmentArena::concat
+
+FragmentArena::Fragment FragmentArena::alternate(Fragment a, Fragment b) {
+  return alternate(vector<Fragment>{a, b});
+} // FragmentArena::alternate
+
+FragmentArena::Fragment FragmentArena::alternate(const vector<Fragment> &fs) {
+  const StateId s = newState(), e = newState();
+  for (Fragment f: fs) {
+    const Frag ff = take(f);
+    addEdge(s, SymbolSet(), ff.start);
+    addEdge(ff.end, SymbolSet(), e);
+  } // for
+  return fragmentOf(s, e);
+} // FragmentArena::alternate
+
+FragmentArena::Fragment FragmentArena::star(Fragment a) {
+  const Frag fa = take(a);
+  const StateId s = newState(), e = newState();
+  addEdge(s, SymbolSet(), fa.start);
+  addEdge(fa.end, SymbolSet(), s);
+  addEdge(s, SymbolSet(), e);
+  return fragmentOf(s, e);
+} // FragmentArena::star
+
+FragmentArena::Fragment FragmentArena::plus(Fragment a) {
+  const Frag fa = take(a);
+  const StateId e = newState();
+  addEdge(fa.end, SymbolSet(), fa.start);
+  addEdge(fa.end, SymbolSet(), e);
+  return fragmentOf(fa.start, e);
+} // FragmentArena::plus
+
+FragmentArena::Fragment FragmentArena::optional(Fragment a) {
+  const Frag fa = take(a);
+  const StateId s = newState();
+  addEdge(s, SymbolSet(), fa.start);
+  addEdge(s, SymbolSet(), fa.end);
+  return fragmentOf(s, fa.end);
+} // FragmentArena::optional
+
+// a{n,m} = a^n (a (a ...)?)? with m - n nested options, a{n,} = a^(n-1) a+
+FragmentArena::Fragment FragmentArena::repeat(Fragment a, int n, int m) {
+  if (n < 0 || (m >= 0 && m < n))
+    throw invalid_argument("invalid repetition {" + to_string(n) + "," +
+                           to_string(m) + "}");
+  if (a.id < 0 || a.id >= (int)frags.size())
+    throw invalid_argument("fragment of another arena");
+  if (frags[a.id].used)
+    throw logic_error("fragment used twice");
+  if (m == 0) {
+    take(a);
+    return empty();
+  } // if
+  const int nCopies = m < 0 ? max(n, 1) : m;
+  vector<Fragment> copies;
+  copies.reserve(nCopies);
+  for (int i = 1; i < nCopies; i++)
+    copies.push_back(copyOf(frags[a.id]));
+  copies.push_back(a);
+
+  if (m < 0) {
+    Fragment r = n == 0 ? star(copies.back()) : plus(copies.back());
+    for (int i = n - 2; i >= 0; i--)
+      r = concat(copies[i], r);
+    return r;
+  } // if
+  Fragment r{-1};
+  int nFixed = n;            // copies[n .. m - 1] form the nested options
+  if (m > n) {
+    r = optional(copies[m - 1]);
+    for (int i = m - 2; i >= n; i--)
+      r = optional(concat(copies[i], r));
+  } else
+    r = copies[--nFixed];
+  for (int i = nFixed - 1; i >= 0; i--)
+    r = concat(copies[i], r);
+  return r;
+} // FragmentArena::repeat
+
+
+// --- automata ---
+
+vector<FragmentArena::StateId> FragmentArena::statesOf(const Frag &f,
+                                                       vector<StateId> &newId) const {
+  newId.assign(head.size(), -1);
+  vector<StateId> states{f.start};
+  newId[f.start] = 0;
+  for (size_t i = 0; i < states.size(); i++)
+    for (int e = head[states[i]]; e >= 0; e = edges[e].next) {
+      const StateId d = edges[e].dest;
+      if (newId[d] < 0) {
+        newId[d] = (StateId)states.size();
+        states.push_back(d);
+      } // if
+    } // for
+  if (newId[f.end] < 0) {      // empty language, end is final anyway
+    newId[f.end] = (StateId)states.size();
+    states.push_back(f.end);
+  } // if
+  return states;
+} // FragmentArena::statesOf
+
+NFA *FragmentArena::nfaOf(Fragment f) {
+  const Frag ff = take(f);
+  vector<StateId> newId;
+  const vector<StateId> states = statesOf(ff, newId);
+  for (const StateId s: states)   // eot and eps are in-band for NFAs
+    for (int e = head[s]; e >= 0; e = edges[e].next)
+      if (edges[e].label[(unsigned char)eot] || edges[e].label[(unsigned char)eps])
+        throw domain_error("transitions for eot or eps have no map-based form");
+  vector<State> names(states.size());
+  for (size_t i = 0; i < states.size(); i++)
+    names[i] = to_string(i);
+  vector<FABuilder::IdTransition> transitions;
+  for (const StateId s: states)
+    for (int e = head[s]; e >= 0; e = edges[e].next) {
+      const Edge &edge = edges[e];
+      if (edge.label.none())
+        transitions.push_back({newId[s], eps, newId[edge.dest]});
+      else
+        for (int c = 0; c < 256; c++)
+          if (edge.label[c])
+            transitions.push_back({newId[s], (TapeSymbol)c, newId[edge.dest]});
+    } // for
+  FABuilder fab;
+  fab.setStartState(names[0])
+     .addFinalState(names[newId[ff.end]])
+     .addTransitions(names, std::move(transitions));
+  return std::move(fab).buildNFA();
+} // FragmentArena::nfaOf
+
+CompiledNFA FragmentArena::compiledOf(Fragment f) {
+  const Frag ff = take(f);
+  vector<StateId> newId;
+  const vector<StateId> states = statesOf(ff, newId);
+  vector<CompiledNFA::Transition> transitions;
+  for (const StateId s: states)
+    for (int e = head[s]; e >= 0; e = edges[e].next)
+      transitions.push_back({newId[s], edges[e].label, newId[edges[e].dest]});
+  return CompiledNFA((int)states.size(), 0, {newId[ff.end]}, std::move(transitions));
+} // FragmentArena::compiledOf
+
+
+void FragmentArena::clear() {
+  head.clear();
+  edges.clear();
+  frags.clear();
+} // FragmentArena::clear
+
+
+// end of FragmentArena.cpp
+//======================================================================
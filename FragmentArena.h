@@ -0,0 +1,115 @@
+// FragmentArena.h:                                                2024
+// ---------------
+// FragmentArena holds NFA fragments on integer state ids and combines
+// them with the operators of Kleene algebra in the style of Thompson:
+// *  a fragment has one start and one end state, the end state has no
+//    outgoing transitions, transitions are labelled with symbol sets
+//    (an empty label is an epsilon transition),
+// *  concat, alternate, star, plus and optional splice fragments with
+//    a few epsilon transitions in O(1), repeat copies its operand,
+// *  combinators consume their operands, so each fragment can be used
+//    once only (logic_error otherwise),
+// *  nfaOf and compiledOf build the automaton for a fragment in one
+//    pass over its reachable states, states are named 0, 1, ... in BFS
+//    order (nfaOf) or have no names at all (compiledOf), nfaOf throws
+//    as FABuilder does for fragments without any transition.
+// All 256 byte values are symbols, epsilon is an empty label, so
+// compiledOf works for binary data, nfaOf throws a domain_error for
+// eot and eps, which are in-band markers of the map-based NFA.
+//======================================================================
+
+#pragma once
+#ifndef FragmentArena_h
+#define FragmentArena_h
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "CompiledNFA.h"
+
+class NFA;
+
+
+class FragmentArena final
+        /*OC+*/ : private ObjectCounter<FragmentArena> /*+OC*/ {
+
+  public:
+
+    typedef CompiledNFA::SymbolSet SymbolSet;
+    typedef CompiledNFA::StateId   StateId;
+
+    struct Fragment {                   // handle, valid in its arena only
+      int id;
+    }; // Fragment
+
+  private:
+
+    struct Edge {
+      StateId   dest;
+      int       next;                   // next edge of src, -1 at end
+      SymbolSet label;
+    }; // Edge
+
+    struct Frag {
+      StateId start, end;
+      bool    used;
+    }; // Frag
+
+    std::vector<int>  head;             // state -> first edge, -1 if none
+    std::vector<Edge> edges;
+    std::vector<Frag> frags;
+
+    StateId  newState();
+    void     addEdge(StateId src, const SymbolSet &label, StateId dest);
+    Fragment fragmentOf(StateId start, StateId end);
+    Frag     take(Fragment f);          // marks f as used
+    Fragment copyOf(Frag f);            // of an unused fragment
+
+    // reachable states in BFS order with their new ids
+    std::vector<StateId> statesOf(const Frag &f, std::vector<StateId> &newId) const;
+
+  public:
+
+    FragmentArena() = default;
+
+    FragmentArena(const FragmentArena  &fa) = delete;
+    FragmentArena(      FragmentArena &&fa) = default;
+
+    ~FragmentArena() = default;
+
+    void reserve(std::size_t nStates, std::size_t nTransitions);
+
+    int         nrOfStates()      const { return (int)head.size(); }
+    std::size_t nrOfTransitions() const { return edges.size(); }
+
+    // atoms
+    Fragment empty();                   // the empty tape only
+    Fragment symbol(TapeSymbol tSy);
+    Fragment symbols(const SymbolSet &syms); // no tape for an empty set
+    Fragment literal(const std::string &s);
+
+    // combinators, all consume their operands
+    Fragment concat   (Fragment a, Fragment b);
+    Fragment alternate(Fragment a, Fragment b);
+    Fragment alternate(const std::vector<Fragment> &fs); // two new states only
+    Fragment star     (Fragment a);
+    Fragment plus     (Fragment a);
+    Fragment optional (Fragment a);
+    Fragment repeat   (Fragment a, int n, int m); // n to m times, m < 0: at least n
+
+    // automata, both consume f
+    NFA        *nfaOf     (Fragment f);
+    CompiledNFA compiledOf(Fragment f);
+
+    void clear();
+
+}; // FragmentArena
+
+
+#endif
+
+// end of FragmentArena.h
+//======================================================================
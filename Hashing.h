@@ -0,0 +1,117 @@
+// Hashing.h:                                                      2024
+// ---------
+// Simple non-cryptographic hash functions for checksums and keys:
+// *  FNV-1a (64 bit) for byte sequences, see: www.isthe.com/chongo/tech/comp/fnv,
+// *  128 bit Fingerprints, built from a sequence of 64 bit words via two
+//    independent lanes (FNV-1a and a MurmurHash3-like mix), each one
+//    finalized with the MurmurHash3 fmix64 avalanche step.
+//======================================================================
+
+#pragma once
+#ifndef Hashing_h
+#define Hashing_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <string_view>
+
+
+constexpr std::uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+constexpr std::uint64_t fnvPrime       = 1099511628211ULL;
+
+inline std::uint64_t fnv1a64(const void *data, std::size_t len,
+                             std::uint64_t h = fnvOffsetBasis) {
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < len; i++) {
+    h ^= p[i];
+    h *= fnvPrime;
+  } // for
+  return h;
+} // fnv1a64
+
+inline std::uint64_t fnv1a64(std::string_view sv,
+                             std::uint64_t h = fnvOffsetBasis) {
+  return fnv1a64(sv.data(), sv.size(), h);
+} // fnv1a64
+
+
+
+struct Fingerprint {
+  std::uint64_t hi = 0, lo = 0;
+
+  bool operator==(const Fingerprint &fp) const { return hi == fp.hi && lo == fp.lo; }
+  bool operator!=(const Fingerprint &fp) const { return !(*this == fp); }
+  bool operator< (const Fingerprint &fp) const {
+    return hi < fp.hi || (hi == fp.hi && lo < fp.lo);
+  } // operator<
+}; // Fingerprint
+
+inline std::ostream &operator<<(std::ostream &os, const Fingerprint &fp) {
+  std::ios_base::fmtflags flags = os.flags();
+  char fill = os.fill('0');
+  os << std::hex << std::setw(16) << fp.hi << std::setw(16) << fp.lo;
+  os.fill(fill);
+  os.flags(flags);
+  return os;
+} // operator<<
+
+namespace std {
+  template<>
+  struct hash<Fingerprint> { // for unordered_set/map<Fingerprint, ...>
+    size_t operator()(const Fingerprint &fp) const noexcept {
+      return (size_t)(fp.hi ^ fp.lo);
+    } // operator()
+  }; // hash<Fingerprint>
+} // std
+
+
+class FingerprintBuilder final {
+
+    std::uint64_t h1 = fnvOffsetBasis,        // FNV-1a lane
+                  h2 = 0x9e3779b97f4a7c15ULL; // Murmur-like lane
+    std::uint64_t n  = 0;                     // nr. of words
+
+    static std::uint64_t rotl(std::uint64_t x, int r) {
+      return (x << r) | (x >> (64 - r));
+    } // rotl
+
+    static std::uint64_t fmix64(std::uint64_t k) {
+      k ^= k >> 33; k *= 0xff51afd7ed558ccdULL;
+      k ^= k >> 33; k *= 0xc4ceb9fe1a85ec53ULL;
+      k ^= k >> 33;
+      return k;
+    } // fmix64
+
+  public:
+
+    FingerprintBuilder &add(std::uint64_t w) {
+      h1 = fnv1a64(&w, sizeof(w), h1);
+      std::uint64_t k = w * 0x87c37b91114253d5ULL;
+      k = rotl(k, 31) * 0x4cf5ad432745937fULL;
+      h2 = rotl(h2 ^ k, 27) * 5 + 0x52dce729;
+      n++;
+      return *this;
+    } // add
+
+    FingerprintBuilder &add(std::string_view sv) { // length prefixed
+      add((std::uint64_t)sv.size());
+      return add(fnv1a64(sv));
+    } // add
+
+    Fingerprint result() const {
+      Fingerprint fp;
+      fp.hi = fmix64(h1 ^ n);
+      fp.lo = fmix64(h2 + fp.hi);
+      return fp;
+    } // result
+
+}; // FingerprintBuilder
+
+
+#endif
+
+// end of Hashing.h
+//======================================================================
@@ -0,0 +1,342 @@
+// LazyDFA.cpp:                                                    2024
+// -----------
+// LazyDFA is the interface of deterministic automata whose states are
+// explored on demand only, and the combinators on them.
+//======================================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+#include "Hashing.h"
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "DFA.h"
+#include "NFA.h"
+#include "FABuilder.h"
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+#include "LazyDFA.h"
+
+
+// --- implementation of class LazyDFA ---
+
+bool LazyDFA::accepts(TapeView tape) {
+  StateId s = start();
+  for (const char *p = tape.data(), *end = p + tape.size(); p != end && s != dead; p++)
+    s = next(s, *p);
+  return s != dead && isFinal(s);
+} // LazyDFA::accepts
+
+
+bool LazyDFA::isEmpty(Tape *witness) {
+  const StateId s0 = start();
+  if (s0 == dead)
+    return true;
+  unordered_map<StateId, pair<StateId, TapeSymbol>> parent; // for witness
+  vector<StateId> queue{s0};
+  parent.emplace(s0, make_pair(dead, eot));
+  for (size_t i = 0; i < queue.size(); i++) {
+    const StateId s = queue[i];
+    if (isFinal(s)) {        // early exit
+      if (witness != nullptr) {
+        Tape tape;
+        for (StateId t = s; parent[t].first != dead; t = parent[t].first)
+          tape += parent[t].second;
+        reverse(tape.begin(), tape.end());
+        *witness = tape;
+      } // if
+      return false;
+    } // if
+    for (TapeSymbol tSy: sigma) {
+      const StateId d = next(s, tSy);
+      if (d != dead && parent.emplace(d, make_pair(s, tSy)).second)
+        queue.push_back(d);
+    } // for
+  } // for
+  return true;
+} // LazyDFA::isEmpty
+
+
+DFA *LazyDFA::dfaOf() {
+  FABuilder fab;
+  const StateId s0 = start();
+  if (s0 == dead)
+    throw logic_error("LazyDFA: start state is dead, empty language");
+  fab.setStartState(to_string(s0));
+  unordered_map<StateId, bool> visited{{s0, true}};
+  vector<StateId> queue{s0};
+  bool anyTransition = false;
+  for (size_t i = 0; i < queue.size(); i++) {
+    const StateId s = queue[i];
+    if (isFinal(s))
+      fab.addFinalState(to_string(s));
+    for (TapeSymbol tSy: sigma) {
+      const StateId d = next(s, tSy);
+      if (d == dead)
+        continue;
+      fab.addTransition(to_string(s), tSy, to_string(d));
+      anyTransition = true;
+      if (visited.emplace(d, true).second)
+        queue.push_back(d);
+    } // for
+  } // for
+  if (!anyTransition && isFinal(s0)) { // {eps}: no delta, so not via FABuilder
+    const State s1 = to_string(s0);
+    return new DFA(StateSet(s1), TapeSymbolSet(), s1, StateSet(s1), DDelta());
+  } // if
+  return std::move(fab).buildDFA();
+} // LazyDFA::dfaOf
+
+
+// --- operands and combinators ---
+
+namespace {
+
+  string alphabetOf(const TapeSymbolSet &V) {
+    string sigma;
+    for (TapeSymbol tSy: V)
+      if (tSy != eps && tSy != eot)
+        sigma += tSy;
+    return sigma;              // sorted as V is sorted
+  } // alphabetOf
+
+  string alphabetUnionOf(const string &a, const string &b) {
+    string u;
+    set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(u));
+    return u;
+  } // alphabetUnionOf
+
+  inline uint64_t keyOf(int hi, int lo) {
+    return ((uint64_t)(uint32_t)hi << 32) | (uint32_t)lo;
+  } // keyOf
+
+
+  class DFAOperand final: public LazyDFA {
+      CompiledDFA cd;
+    public:
+      explicit DFAOperand(const DFA &dfa)
+      : LazyDFA(alphabetOf(dfa.V)), cd(dfa, false) {}
+      StateId start() override { return cd.startState(); }
+      StateId next(StateId s, TapeSymbol tSy) override {
+        if (s == dead)
+          return dead;
+        const StateId d = cd.next(s, tSy);
+        return d == CompiledDFA::undef ? dead : d;
+      } // next
+      bool isFinal(StateId s) override { return s != dead && cd.isFinal(s); }
+      int nrOfExploredStates() const override { return cd.nrOfStates(); }
+  }; // DFAOperand
+
+
+  struct StateIdsHash {
+    size_t operator()(const vector<CompiledNFA::StateId> &v) const {
+      return (size_t)fnv1a64(v.data(), v.size() * sizeof(v[0]));
+    } // operator()
+  }; // StateIdsHash
+
+  class NFAOperand final: public LazyDFA {
+      typedef CompiledNFA::StateId NState;
+      CompiledNFA cn;
+      vector<vector<NState>> sets;           // id -> eps-closed state set
+      vector<bool> finals;                   // id -> contains final?
+      unordered_map<vector<NState>, StateId, StateIdsHash> idOf;
+      unordered_map<uint64_t, StateId> trans; // (id, tSy) -> id
+      vector<unsigned> mark;                 // for closures
+      unsigned stamp = 0;
+
+      void addWithClosure(NState s, vector<NState> &set) {
+        if (mark[s] == stamp)
+          return;
+        mark[s] = stamp;
+        set.push_back(s);
+        for (size_t i = set.size() - 1; i < set.size(); i++) {
+          const auto ed = cn.epsDestsOf(set[i]);
+          for (const NState *d = ed.first; d != ed.second; d++)
+            if (mark[*d] != stamp) {
+              mark[*d] = stamp;
+              set.push_back(*d);
+            } // if
+        } // for
+      } // addWithClosure
+
+      StateId intern(vector<NState> &&set) {
+        if (set.empty())
+          return dead;
+        sort(set.begin(), set.end());
+        auto it = idOf.find(set);
+        if (it != idOf.end())
+          return it->second;
+        bool f = false;
+        for (NState s: set)
+          f = f || cn.isFinal(s);
+        const StateId id = (StateId)sets.size();
+        idOf.emplace(set, id);
+        sets.push_back(std::move(set));
+        finals.push_back(f);
+        return id;
+      } // intern
+
+      void newStamp() {
+        if (++stamp == 0) {
+          fill(mark.begin(), mark.end(), 0);
+          stamp = 1;
+        } // if
+      } // newStamp
+
+    public:
+      explicit NFAOperand(const NFA &nfa)
+      : LazyDFA(alphabetOf(nfa.V)), cn(nfa, false), mark(cn.nrOfStates(), 0) {
+        vector<NState> s0;
+        newStamp();
+        addWithClosure(cn.startState(), s0);
+        intern(std::move(s0));                 // so start has id 0
+      } // NFAOperand
+      StateId start() override { return 0; }
+      StateId next(StateId s, TapeSymbol tSy) override {
+        if (s == dead)
+          return dead;
+        const int c = cn.classOf(tSy);
+        if (c == 0)
+          return dead;
+        const uint64_t key = keyOf(s, (unsigned char)tSy);
+        auto it = trans.find(key);
+        if (it != trans.end())
+          return it->second;
+        vector<NState> dests;
+        newStamp();
+        for (NState q: sets[s]) {
+          const auto ds = cn.destsOf(q, c);
+          for (const NState *d = ds.first; d != ds.second; d++)
+            addWithClosure(*d, dests);
+        } // for
+        const StateId d = intern(std::move(dests));
+        trans.emplace(key, d);
+        return d;
+      } // next
+      bool isFinal(StateId s) override { return s != dead && finals[s]; }
+      int nrOfExploredStates() const override { return (int)sets.size(); }
+  }; // NFAOperand
+
+
+  class ProductDFA final: public LazyDFA {
+    public:
+      enum Op { intersection, union_, difference };
+    private:
+      LazyDFAPtr a, b;
+      Op op;
+      vector<pair<StateId, StateId>> pairs;  // id -> (state of a, of b)
+      unordered_map<uint64_t, StateId> idOf; // (state of a, of b) -> id
+      unordered_map<uint64_t, StateId> trans; // (id, tSy) -> id
+      StateId s0;
+
+      StateId intern(StateId pa, StateId pb) {
+        if ((op == intersection && (pa == dead || pb == dead)) ||
+            (op == union_       && (pa == dead && pb == dead)) ||
+            (op == difference   &&  pa == dead))
+          return dead;         // early exit, no final state reachable
+        auto ir = idOf.emplace(keyOf(pa, pb), (StateId)pairs.size());
+        if (ir.second)
+          pairs.emplace_back(pa, pb);
+        return ir.first->second;
+      } // intern
+
+    public:
+      ProductDFA(LazyDFAPtr a, LazyDFAPtr b, Op op)
+      : LazyDFA(alphabetUnionOf(a->alphabet(), b->alphabet())),
+        a(std::move(a)), b(std::move(b)), op(op) {
+        s0 = intern(this->a->start(), this->b->start());
+      } // ProductDFA
+      StateId start() override { return s0; }
+      StateId next(StateId s, TapeSymbol tSy) override {
+        if (s == dead)
+          return dead;
+        const uint64_t key = keyOf(s, (unsigned char)tSy);
+        auto it = trans.find(key);
+        if (it != trans.end())
+          return it->second;
+        const auto [pa, pb] = pairs[s];
+        const StateId d = intern(a->next(pa, tSy), b->next(pb, tSy));
+        trans.emplace(key, d);
+        return d;
+      } // next
+      bool isFinal(StateId s) override {
+        if (s == dead)
+          return false;
+        const bool fa = a->isFinal(pairs[s].first), fb = b->isFinal(pairs[s].second);
+        switch (op) {
+          case intersection: return fa && fb;
+          case union_:       return fa || fb;
+          default:           return fa && !fb;
+        } // switch
+      } // isFinal
+      int nrOfExploredStates() const override { return (int)pairs.size(); }
+  }; // ProductDFA
+
+
+  // id 0 is the final sink for a's dead, a's states s have ids s + 1
+  class ComplementDFA final: public LazyDFA {
+      LazyDFAPtr a;
+      bool inSigma[256];
+    public:
+      ComplementDFA(LazyDFAPtr a, const string &alphabet)
+      : LazyDFA(alphabet), a(std::move(a)) {
+        fill(begin(inSigma), end(inSigma), false);
+        for (TapeSymbol tSy: sigma)
+          inSigma[(unsigned char)tSy] = true;
+      } // ComplementDFA
+      StateId start() override {
+        const StateId s = a->start();
+        return s == dead ? 0 : s + 1;
+      } // start
+      StateId next(StateId s, TapeSymbol tSy) override {
+        if (s == dead || !inSigma[(unsigned char)tSy])
+          return dead;         // outside of alphabet*
+        if (s == 0)
+          return 0;
+        const StateId d = a->next(s - 1, tSy);
+        return d == dead ? 0 : d + 1;
+      } // next
+      bool isFinal(StateId s) override {
+        return s != dead && (s == 0 || !a->isFinal(s - 1));
+      } // isFinal
+      int nrOfExploredStates() const override { return a->nrOfExploredStates() + 1; }
+  }; // ComplementDFA
+
+} // namespace
+
+
+LazyDFAPtr lazyOf(const DFA &dfa) {
+  return make_shared<DFAOperand>(dfa);
+} // lazyOf
+
+LazyDFAPtr lazyOf(const NFA &nfa) {
+  return make_shared<NFAOperand>(nfa);
+} // lazyOf
+
+LazyDFAPtr intersectionOf(LazyDFAPtr a, LazyDFAPtr b) {
+  return make_shared<ProductDFA>(std::move(a), std::move(b), ProductDFA::intersection);
+} // intersectionOf
+
+LazyDFAPtr unionOf(LazyDFAPtr a, LazyDFAPtr b) {
+  return make_shared<ProductDFA>(std::move(a), std::move(b), ProductDFA::union_);
+} // unionOf
+
+LazyDFAPtr differenceOf(LazyDFAPtr a, LazyDFAPtr b) {
+  return make_shared<ProductDFA>(std::move(a), std::move(b), ProductDFA::difference);
+} // differenceOf
+
+LazyDFAPtr complementOf(LazyDFAPtr a, const string &alphabet) {
+  string sigma = alphabet.empty() ? a->alphabet() : alphabet;
+  sort(sigma.begin(), sigma.end());
+  sigma.erase(unique(sigma.begin(), sigma.end()), sigma.end());
+  return make_shared<ComplementDFA>(std::move(a), sigma);
+} // complementOf
+
+
+// end of LazyDFA.cpp
+//======================================================================
@@ -0,0 +1,92 @@
+// LazyDFA.h:                                                      2024
+// ---------
+// LazyDFA is the interface of deterministic automata whose states are
+// explored on demand only, and the combinators on them: product
+// automata for intersection, union and difference and the complement.
+// *  states are numbered 0, 1, ... in the order of their discovery,
+//    dead (-1) is the implicit sink for all undefined transitions,
+// *  operands are DFAs, NFAs (subset construction on demand) or other
+//    LazyDFAs, so "matches A and not B" is differenceOf(A, B),
+// *  only reachable pairs (sets) of states are ever created, and a DFA
+//    is materialized on request only.
+// Exploration memoizes states and transitions, so the methods are not
+// const and one LazyDFA must not be used by several threads at once.
+//======================================================================
+
+#pragma once
+#ifndef LazyDFA_h
+#define LazyDFA_h
+
+#include <memory>
+#include <string>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+
+class DFA;
+class NFA;
+
+
+class LazyDFA
+        /*OC+*/ : private ObjectCounter<LazyDFA> /*+OC*/ {
+
+  public:
+
+    typedef int StateId;
+    static constexpr StateId dead = -1; // non-final sink, never left
+
+  protected:
+
+    std::string sigma;      // sorted tape symbols (alphabet)
+
+    explicit LazyDFA(std::string sigma): sigma(std::move(sigma)) {}
+
+  public:
+
+    LazyDFA(const LazyDFA  &ld) = delete;
+    LazyDFA(      LazyDFA &&ld) = delete;
+
+    virtual ~LazyDFA() = default;
+
+    const std::string &alphabet() const { return sigma; }
+
+    virtual StateId start() = 0;
+    virtual StateId next(StateId s, TapeSymbol tSy) = 0; // dead for s == dead
+    virtual bool    isFinal(StateId s) = 0;              // false for dead
+
+    virtual int nrOfExploredStates() const = 0;
+
+    bool accepts(TapeView tape);
+
+    // BFS from start() with early exit on the first final state, then
+    //   witness (if not nullptr) is a shortest tape of the language
+    bool isEmpty(Tape *witness = nullptr);
+
+    // explores all reachable states, states are named 0, 1, ...,
+    //   throws for empty languages as FABuilder requires final states,
+    //   {eps} gives a final start state without transitions
+    DFA *dfaOf();
+
+}; // LazyDFA
+
+typedef std::shared_ptr<LazyDFA> LazyDFAPtr;
+
+
+// operands
+LazyDFAPtr lazyOf(const DFA &dfa);
+LazyDFAPtr lazyOf(const NFA &nfa);     // subset construction on demand
+
+// combinators, alphabets of products are the unions of the operands'
+LazyDFAPtr intersectionOf(LazyDFAPtr a, LazyDFAPtr b);
+LazyDFAPtr unionOf       (LazyDFAPtr a, LazyDFAPtr b);
+LazyDFAPtr differenceOf  (LazyDFAPtr a, LazyDFAPtr b); // L(a) \ L(b)
+
+// complement relative to alphabet* (default: a's alphabet), dead states
+//   of a become one final sink, so partial automata need no full table
+LazyDFAPtr complementOf(LazyDFAPtr a, const std::string &alphabet = "");
+
+
+#endif
+
+// end of LazyDFA.h
+//======================================================================
@@ -0,0 +1,191 @@
+// LevenshteinDFA.cpp:                                             2024
+// ------------------
+// Deterministic Levenshtein automata on capped rows of the edit
+// distance table and their lazy product with dictionary DFAs.
+//======================================================================
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "DFA.h"
+#include "CompiledNFA.h"
+#include "CompiledDFA.h"
+#include "LevenshteinDFA.h"
+
+
+LevenshteinDFA::LevenshteinDFA(TapeView word, int k)
+: word(word), k(k), nClasses(1) {
+  if (k < 0 || k > maxDistance)
+    throw invalid_argument("LevenshteinDFA: distance " + to_string(k) +
+                           " not in 0 .. " + to_string(maxDistance));
+  fill(begin(cls), end(cls), (uint16_t)0);
+  for (unsigned char b: this->word)
+    if (cls[b] == 0)
+      cls[b] = (uint16_t)nClasses++;
+  const size_t n = this->word.size();
+  const char cap = (char)(k + 1);
+
+  // rows as strings of entries, row[i] = min(d(t, w[0 .. i)), k + 1)
+  string row(n + 1, cap);
+  for (size_t i = 0; i <= n; i++)
+    row[i] = (char)min<size_t>(i, k + 1);
+  unordered_map<string, StateId> ids{{row, 0}};
+  vector<string> rows{row};
+  string nextRow(n + 1, cap);
+  for (size_t s = 0; s < rows.size(); s++) {
+    distances.push_back((unsigned char)rows[s][n]);
+    for (int c = 0; c < nClasses; c++) {
+      const string &r = rows[s];
+      nextRow[0] = (char)min(r[0] + 1, (int)cap);
+      char lowest = nextRow[0];
+      for (size_t i = 1; i <= n; i++) {
+        const int subst = r[i - 1] + (cls[(unsigned char)this->word[i - 1]] != c);
+        nextRow[i] = (char)min({subst, r[i] + 1, nextRow[i - 1] + 1, (int)cap});
+        lowest = min(lowest, nextRow[i]);
+      } // for
+      if (lowest == cap) {   // all alignments above k
+        table.push_back(dead);
+        continue;
+      } // if
+      const auto it = ids.emplace(nextRow, (StateId)rows.size());
+      if (it.second)
+        rows.push_back(nextRow);
+      table.push_back(it.first->second);
+    } // for
+  } // for
+} // LevenshteinDFA::LevenshteinDFA
+
+
+bool LevenshteinDFA::accepts(TapeView tape) const {
+  return distanceOf(tape) <= k;
+} // LevenshteinDFA::accepts
+
+int LevenshteinDFA::distanceOf(TapeView tape) const {
+  StateId s = startState();
+  for (const char *p = tape.data(), *end = p + tape.size(); p != end && s != dead; p++)
+    s = next(s, (unsigned char)*p);
+  return distanceOf(s);
+} // LevenshteinDFA::distanceOf
+
+
+namespace {
+
+  typedef CompiledDFA::StateId DState;
+  typedef LevenshteinDFA::StateId LState;
+
+  // depth first on pairs of states, the Levenshtein automaton is acyclic
+  //   but for dead, so the depth is at most |w| + k
+  class ProductSearch final {
+
+      const LevenshteinDFA &ld;
+      const CompiledDFA    &dict;
+      size_t maxMatches;
+      vector<vector<unsigned char>> bytesOf; // class of dict -> bytes
+      unordered_set<uint64_t> fruitless;  // pairs without matches below
+      Tape tape;
+
+      static uint64_t keyOf(DState d, LState l) {
+        return ((uint64_t)(uint32_t)d << 32) | (uint32_t)l;
+      } // keyOf
+
+    public:
+
+      vector<LevenshteinDFA::Match> matches;
+
+      ProductSearch(const LevenshteinDFA &ld, const CompiledDFA &dict, size_t maxMatches)
+      : ld(ld), dict(dict), maxMatches(maxMatches), bytesOf(dict.nrOfClasses()) {
+        for (int b = 0; b < 256; b++)
+          bytesOf[dict.classOf((TapeSymbol)b)].push_back((unsigned char)b);
+      } // ProductSearch
+
+      bool done() const { return matches.size() >= maxMatches; }
+
+      // true if there is a match in the subtree of (d, l)
+      bool explore(DState d, LState l) {
+        if (fruitless.count(keyOf(d, l)) > 0)
+          return false;
+        bool found = false;
+        if (dict.isFinal(d) && ld.isFinal(l)) {
+          matches.push_back({tape, ld.distanceOf(l)});
+          found = true;
+        } // if
+        for (int c = 0; c < dict.nrOfClasses(); c++) {
+          const DState dd = dict.destOf(d, c);
+          if (dd == CompiledDFA::undef)
+            continue;
+          for (unsigned char b: bytesOf[c]) {
+            if (done())
+              return true;
+            const LState ll = ld.next(l, b);
+            if (ll == LevenshteinDFA::dead)
+              continue;
+            tape.push_back((char)b);
+            found = explore(dd, ll) || found;
+            tape.pop_back();
+          } // for
+        } // for
+        if (!found)
+          fruitless.insert(keyOf(d, l));
+        return found;
+      } // explore
+
+  }; // ProductSearch
+
+} // namespace
+
+
+vector<LevenshteinDFA::Match> LevenshteinDFA::matchesIn(const CompiledDFA &dict,
+                                                        size_t maxMatches) const {
+  ProductSearch ps(*this, dict, maxMatches);
+  if (maxMatches > 0 && dict.startState() != CompiledDFA::undef)
+    ps.explore(dict.startState(), startState());
+  sort(ps.matches.begin(), ps.matches.end(),
+       [](const Match &m1, const Match &m2) { return m1.tape < m2.tape; });
+  return std::move(ps.matches);
+} // LevenshteinDFA::matchesIn
+
+vector<LevenshteinDFA::Match> LevenshteinDFA::matchesIn(const DFA &dict,
+                                                        size_t maxMatches) const {
+  return matchesIn(CompiledDFA(dict, false), maxMatches);
+} // LevenshteinDFA::matchesIn
+
+bool LevenshteinDFA::hasMatchIn(const CompiledDFA &dict) const {
+  return !matchesIn(dict, 1).empty();
+} // LevenshteinDFA::hasMatchIn
+
+
+// via a (deterministic) CompiledNFA, one transition per destination
+//   and state, dead is left out
+CompiledDFA LevenshteinDFA::compiledOf() const {
+  vector<CompiledNFA::Transition> transitions;
+  vector<CompiledNFA::StateId> finals;
+  for (StateId s = 0; s < nrOfStates(); s++) {
+    if (isFinal(s))
+      finals.push_back(s);
+    const size_t first = transitions.size();
+    for (int b = 0; b < 256; b++) {
+      const StateId d = next(s, (unsigned char)b);
+      if (d == dead)
+        continue;
+      size_t i = first;
+      while (i < transitions.size() && transitions[i].dest != d)
+        i++;
+      if (i == transitions.size())
+        transitions.push_back({s, CompiledNFA::SymbolSet(), d});
+      transitions[i].label.set(b);
+    } // for
+  } // for
+  return CompiledDFA(CompiledNFA(nrOfStates(), 0, finals, std::move(transitions)));
+} // LevenshteinDFA::compiledOf
+
+
+// end of LevenshteinDFA.cpp
+//======================================================================
@@ -0,0 +1,108 @@
+// LevenshteinDFA.h:                                               2024
+// ----------------
+// LevenshteinDFA is the deterministic Levenshtein automaton of a word w
+// and a distance k <= 3: it accepts all tapes t with edit distance
+// d(t, w) <= k (insertions, deletions and substitutions of bytes), for
+// typo-tolerant lookup in dictionaries:
+// *  a state is the row of the edit distance table of t against all
+//    prefixes of w, with entries above k capped to k + 1, so the number
+//    of states is linear in |w| for fixed k, rows with all entries
+//    above k are the dead state,
+// *  a transition depends on the characteristic vector of the byte in
+//    w only (as in the parametric automata of Schulz and Mihov), so the
+//    classes are one per distinct byte of w and class 0 for all others
+//    (up to 257 classes, so they are 16 bit),
+// *  matchesIn explores the product with a dictionary DFA lazily: depth
+//    first from the pair of start states, pairs with a dead component
+//    are never created and pairs without any match below are memoized
+//    as fruitless, so the product is never materialized, the matches
+//    are sorted by tape.
+//======================================================================
+
+#pragma once
+#ifndef LevenshteinDFA_h
+#define LevenshteinDFA_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+
+class DFA;
+class CompiledDFA;
+
+
+class LevenshteinDFA final
+        /*OC+*/ : private ObjectCounter<LevenshteinDFA> /*+OC*/ {
+
+  public:
+
+    typedef std::int32_t StateId;
+    static constexpr StateId dead = -1;     // non-final sink
+    static constexpr int maxDistance = 3;
+
+    struct Match {
+      Tape tape;                            // of the dictionary
+      int  distance;                        // edit distance to the word
+    }; // Match
+
+  private:
+
+    Tape word;
+    int  k;
+    std::uint16_t              cls[256];    // byte -> class, 0: not in word
+    int                        nClasses;
+    std::vector<StateId>       table;       // nStates x nClasses
+    std::vector<unsigned char> distances;   // last entry of the row per state
+
+  public:
+
+    // throws invalid_argument for k < 0 or k > maxDistance
+    LevenshteinDFA(TapeView word, int k);
+
+    LevenshteinDFA(const LevenshteinDFA  &ld) = default;
+    LevenshteinDFA(      LevenshteinDFA &&ld) = default;
+
+    ~LevenshteinDFA() = default;
+
+    const Tape &wordOf()        const { return word; }
+    int         maxDistanceOf() const { return k; }
+    int         nrOfStates()    const { return (int)distances.size(); }
+    int         nrOfClasses()   const { return nClasses; }
+
+    StateId startState() const { return 0; }
+
+    StateId next(StateId s, unsigned char b) const {    // dead for s == dead
+      return s == dead ? dead : table[(std::size_t)s * nClasses + cls[b]];
+    } // next
+
+    bool isFinal(StateId s) const { return s != dead && distances[s] <= k; }
+
+    // edit distance of the tape read to s and the word, k + 1 if above k
+    int distanceOf(StateId s) const { return s == dead ? k + 1 : distances[s]; }
+
+    bool accepts(TapeView tape) const;
+    int  distanceOf(TapeView tape) const;   // k + 1 if above k
+
+    // all tapes of dict within distance k with their distances, at most
+    //   maxMatches of them, useless states of dict (e.g., of a DFA that
+    //   is not minimal) only cost time, the DFA version compiles it first
+    std::vector<Match> matchesIn(const CompiledDFA &dict,
+                                 std::size_t maxMatches = SIZE_MAX) const;
+    std::vector<Match> matchesIn(const DFA &dict,
+                                 std::size_t maxMatches = SIZE_MAX) const;
+    bool hasMatchIn(const CompiledDFA &dict) const;
+
+    CompiledDFA compiledOf() const;         // on all 256 bytes, throws
+                                            //   length_error as CompiledNFA
+                                            //   for more than 255 classes
+
+}; // LevenshteinDFA
+
+
+#endif
+
+// end of LevenshteinDFA.h
+//======================================================================
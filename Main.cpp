@@ -6,9 +6,20 @@
 //======================================================================
 
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
 #include <memory>  // For smart pointers
+#include <random>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include "GrammarBuilder.h"
 
@@ -22,6 +33,27 @@ using namespace std;
 #include "DFA.h"
 #include "NFA.h"
 #include "FABuilder.h"
+#include "FAProfile.h"
+#include "FACache.h"
+#include "FAEquivalence.h"
+#include "FragmentArena.h"
+#include "LazyDFA.h"
+#include "NFAReduction.h"
+#include "Regex.h"
+#include "RangeDelta.h"
+#include "Utf8.h"
+#include "CompiledDFA.h"
+#include "ShuffleDFA.h"
+#include "Prefilter.h"
+#include "AhoCorasick.h"
+#include "DawgBuilder.h"
+#include "LevenshteinDFA.h"
+#include "Searcher.h"
+#include "TaggedDFA.h"
+#include "MooreDFA.h"
+#include "MealyDFA.h"
+#include "OutputSink.h"
+#include "PerfCounters.h"
 #include "GraphVizUtil.h"
 
 void testDFA() {
@@ -464,6 +496,1562 @@ void testDfaOf() {
     vizualizeFA("minDfaOfNfa", minDfaOfNfa.get());
 }
 
+void testProfiling() {
+    cout << "9. Profiling of accepts" << endl;
+    cout << "------------------------" << endl;
+    cout << endl;
+
+    const auto fab = make_unique<FABuilder>(
+        "-> 1 -> a 2 | b 1         \n\
+         () 2 -> a 2 | b 1 | b 3  \n\
+            3 -> a 2 | b 4        \n\
+         () 4 -> a 4 | b 4");
+    const unique_ptr<NFA> nfa(fab->buildNFA());
+    const unique_ptr<DFA> dfa(nfa->dfaOf());
+
+    vector<string> tapes = {"a", "ab", "abba", "bbab", "babbba", "aaaa", "bbbb"};
+
+    // four threads profile the same DFA, each one counts on its own
+    FAProfiler dfaProfiler(*dfa);
+    vector<thread> tv;
+    for (int t = 0; t < 4; t++)
+        tv.emplace_back([&] {
+            for (int i = 0; i < 1000; i++)
+                for (const auto &tape: tapes)
+                    dfa->accepts(tape, dfaProfiler);
+        });
+    for (auto &t: tv)
+        t.join();
+    const FAProfile dfaProfile = dfaProfiler.profile();
+    cout << "dfa:" << endl << *dfa;
+    cout << dfaProfile << endl;
+    cout << "unvisited states: " << dfaProfile.unvisitedStates() << endl;
+    dfa->genGraphVizFile("dfaProfile.gv", "dfaProfile", &dfaProfile);
+
+    FAProfiler nfaProfiler(*nfa);
+    for (const auto &tape: tapes)
+        nfa->accepts(tape, nfaProfiler);
+    const FAProfile nfaProfile = nfaProfiler.profile();
+    cout << "nfa:" << endl << *nfa;
+    cout << nfaProfile << endl;
+    nfa->genGraphVizFile("nfaProfile.gv", "nfaProfile", &nfaProfile);
+}
+
+void testRenumbering() {
+    cout << "10. Profile-guided renumbering" << endl;
+    cout << "------------------------------" << endl;
+    cout << endl;
+
+    // large random DFA where most transitions lead into a small hot set,
+    //   names are chosen randomly, so hot rows are scattered in the table
+    constexpr int nStates = 100000, nHot = 4096, tapeLen = 1000, nTapes = 1000;
+    const string symbols = "abcd";
+    mt19937 rng(4711);
+    uniform_int_distribution<int> anyState(0, nStates - 1), hotState(0, nHot - 1);
+    uniform_int_distribution<int> percent(0, 99), anySymbol(0, (int)symbols.size() - 1);
+    vector<int> perm(nStates);
+    for (int i = 0; i < nStates; i++)
+        perm[i] = i;
+    shuffle(perm.begin(), perm.end(), rng);
+    auto nameOf = [&](int i) { return "q" + to_string(perm[i]); };
+
+    FABuilder builder;
+    builder.setStartState(nameOf(0));
+    for (int i = 0; i < nStates; i++) {
+        if (i + 1 < nStates) // z, never on tapes, to make all states reachable
+            builder.addTransition(nameOf(i), 'z', nameOf(i + 1));
+        for (char tSy: symbols)
+            builder.addTransition(nameOf(i), tSy,
+                                  nameOf(percent(rng) < 95 ? hotState(rng) : anyState(rng)));
+        if (i % 3 == 0)
+            builder.addFinalState(nameOf(i));
+    }
+    const unique_ptr<DFA> dfa(builder.buildDFA());
+
+    vector<Tape> tapes(nTapes);
+    for (auto &tape: tapes)
+        for (int i = 0; i < tapeLen; i++)
+            tape += symbols[anySymbol(rng)];
+
+    startTimer();
+    const unique_ptr<DFA> renDfa(dfa->renumberedOf(vector<Tape>(tapes.begin(), tapes.begin() + 100)));
+    stopTimer();
+    cout << "renumbering with 100 training tapes: " << elapsedTime() << " s" << endl;
+
+    const CompiledDFA cDfa(*dfa), cRenDfa(*renDfa);
+    auto bench = [&](const string &name, const CompiledDFA &c) {
+        PerfCounters pc;
+        int nAccepted = 0;
+        startTimer();
+        pc.start();
+        for (int r = 0; r < 10; r++)
+            for (const auto &tape: tapes)
+                nAccepted += c.accepts(tape);
+        pc.stop();
+        stopTimer();
+        double mb = 10.0 * nTapes * tapeLen / 1e6;
+        cout << name << ": " << nAccepted << " accepted, "
+             << mb / max(elapsedTime(), 1e-3) << " MB/s" << endl
+             << "  " << pc << endl;
+    };
+    bench("original table  ", cDfa);
+    bench("renumbered table", cRenDfa);
+    for (const auto &tape: tapes)
+        if (cDfa.accepts(tape) != cRenDfa.accepts(tape))
+            throw runtime_error("renumbered DFA is not equivalent");
+}
+
+void testParser() {
+    cout << "11. Parsing large FA text files" << endl;
+    cout << "-------------------------------" << endl;
+    cout << endl;
+
+    // generate a file with 10^6 transitions: 10^5 states, 10 each
+    constexpr int nStates = 100000, nTransPerState = 10;
+    const string fileName = "bigFA.txt";
+    {
+        mt19937 rng(4711);
+        uniform_int_distribution<int> anyState(0, nStates - 1);
+        ofstream ofs(fileName);
+        for (int i = 0; i < nStates; i++) {
+            ofs << (i == 0 ? "-> " : (i % 10 == 0 ? "() " : "   ")) << "s" << i << " ->";
+            for (int j = 0; j < nTransPerState; j++)
+                ofs << (j == 0 ? " " : " | ") << (char) ('a' + j) << " s" << anyState(rng);
+            ofs << "\n";
+        }
+    }
+
+    startTimer();
+    ifstream ifs(fileName);
+    const FABuilder streamFab(ifs); // line by line with istringstreams
+    stopTimer();
+    cout << "stream parser:    " << elapsedTime() << " s" << endl;
+
+    startTimer();
+    const FABuilder mappedFab(fileName); // mmap'd buffer and string_views
+    stopTimer();
+    cout << "mmap'd parser:    " << elapsedTime() << " s" << endl;
+
+    startTimer();
+    const unique_ptr<DFA> dfa(FABuilder(fileName).buildDFA()); // rvalue build
+    stopTimer();
+    cout << "parse + buildDFA: " << elapsedTime() << " s, "
+         << dfa->S.size() << " states" << endl;
+}
+
+void testImages() {
+    cout << "12. Binary images of compiled automata" << endl;
+    cout << "--------------------------------------" << endl;
+    cout << endl;
+
+    // large random DFA, once as text file and once as binary image
+    constexpr int nStates = 1000000;
+    const string symbols = "abcd", textFileName = "bigDFA.txt", imageFileName = "bigDFA.fai";
+    {
+        mt19937 rng(4711);
+        uniform_int_distribution<int> anyState(0, nStates - 1);
+        ofstream ofs(textFileName);
+        for (int i = 0; i < nStates; i++) {
+            ofs << (i == 0 ? "-> " : (i % 3 == 0 ? "() " : "   ")) << "s" << i << " ->";
+            for (char tSy: symbols)
+                ofs << (tSy == symbols[0] ? " " : " | ") << tSy << " s" << anyState(rng);
+            if (i + 1 < nStates) // z, never on tapes, to make all states reachable
+                ofs << " | z s" << i + 1;
+            ofs << "\n";
+        }
+    }
+
+    startTimer();
+    const unique_ptr<DFA> dfa(FABuilder(textFileName).buildDFA());
+    stopTimer();
+    cout << "text:  parse + buildDFA:  " << elapsedTime() << " s" << endl;
+
+    startTimer();
+    const CompiledDFA cDfa(*dfa);
+    cDfa.save(imageFileName);
+    stopTimer();
+    cout << "image: compile + save:    " << elapsedTime() << " s, "
+         << cDfa.image().size() / 1e6 << " MB" << endl;
+
+    constexpr int nLoads = 1000; // too fast for the timer's resolution
+    startTimer();
+    for (int i = 0; i < nLoads; i++)
+        CompiledDFA::load(imageFileName); // mmap and header checks only
+    stopTimer();
+    cout << "image: load (cold start): " << elapsedTime() * 1e6 / nLoads << " us" << endl;
+    const CompiledDFA loaded = CompiledDFA::load(imageFileName);
+
+    startTimer();
+    const CompiledDFA verified = CompiledDFA::load(imageFileName, true);
+    stopTimer();
+    cout << "image: load + checksum:   " << elapsedTime() * 1e3 << " ms" << endl;
+
+    mt19937 rng(4712);
+    uniform_int_distribution<int> anySymbol(0, (int)symbols.size() - 1);
+    for (int t = 0; t < 1000; t++) {
+        Tape tape;
+        for (int i = 0; i < 100; i++)
+            tape += symbols[anySymbol(rng)];
+        if (loaded.accepts(tape) != dfa->accepts(tape) ||
+            loaded.nameOf(loaded.startState()) != dfa->s1)
+            throw runtime_error("loaded image is not equivalent");
+    }
+    cout << "loaded image is equivalent to the DFA" << endl;
+}
+
+void testCache() {
+    cout << "13. Persistent cache for transformations" << endl;
+    cout << "----------------------------------------" << endl;
+    cout << endl;
+
+    // NFA for (a|b)* a (a|b)^(k-1), its DFA has 2^k states
+    constexpr int k = 10;
+    FABuilder builder;
+    builder.setStartState("Q0")
+            .addTransition("Q0", 'a', "Q0")
+            .addTransition("Q0", 'b', "Q0")
+            .addTransition("Q0", 'a', "Q1")
+            .addFinalState("Q" + to_string(k));
+    for (int i = 1; i < k; i++)
+        builder.addTransition("Q" + to_string(i), 'a', "Q" + to_string(i + 1))
+                .addTransition("Q" + to_string(i), 'b', "Q" + to_string(i + 1));
+    const unique_ptr<NFA> nfa(builder.buildNFA());
+
+    FACache cache("faCache");
+    cache.clear();
+    for (int run = 1; run <= 3; run++) {
+        startTimer();
+        const unique_ptr<DFA> minDfa(cache.minimalDfaOf(*nfa));
+        stopTimer();
+        cout << "run " << run << ": " << minDfa->S.size() << " states, "
+             << elapsedTime() << " s" << endl;
+    }
+    cout << "cache: " << cache.stats() << ", "
+         << cache.sizeInBytes() << " bytes on disk" << endl;
+}
+
+void testFingerprint() {
+    cout << "14. Canonical form and fingerprint" << endl;
+    cout << "----------------------------------" << endl;
+    cout << endl;
+
+    // same DFA twice, with different names of states, and a variant
+    const unique_ptr<DFA> dfa1(FABuilder(
+        "-> B -> b R  \n\
+         () R -> b R | z R").buildDFA());
+    const unique_ptr<DFA> dfa2(FABuilder(
+        "-> Start -> b Rest  \n\
+         () Rest  -> z Rest | b Rest").buildDFA());
+    const unique_ptr<DFA> dfa3(FABuilder(
+        "-> B -> b R  \n\
+         () R -> b R | z B").buildDFA());
+
+    cout << "dfa1: " << dfa1->fingerprint() << endl
+         << "dfa2: " << dfa2->fingerprint() << endl
+         << "dfa3: " << dfa3->fingerprint() << endl;
+    cout << "canonicalOf(dfa2):" << endl << *unique_ptr<DFA>(dfa2->canonicalOf());
+
+    unordered_set<Fingerprint> distinct;
+    for (const DFA *dfa: {dfa1.get(), dfa2.get(), dfa3.get()})
+        distinct.insert(dfa->fingerprint());
+    cout << distinct.size() << " distinct DFAs" << endl;
+}
+
+void testEquivalence() {
+    cout << "15. Equivalence and inclusion" << endl;
+    cout << "-----------------------------" << endl;
+    cout << endl;
+
+    // large random DFA, a renamed copy and a copy with one more final state
+    constexpr int nStates = 100000;
+    const string symbols = "abcd";
+    mt19937 rng(4711);
+    uniform_int_distribution<int> anyState(0, nStates - 1);
+    FABuilder builder;
+    builder.setStartState("q0");
+    for (int i = 0; i < nStates; i++) {
+        if (i + 1 < nStates) // z to make all states reachable
+            builder.addTransition("q" + to_string(i), 'z', "q" + to_string(i + 1));
+        for (char tSy: symbols)
+            builder.addTransition("q" + to_string(i), tSy, "q" + to_string(anyState(rng)));
+        if (i % 3 == 0)
+            builder.addFinalState("q" + to_string(i));
+    }
+    const unique_ptr<DFA> dfa(builder.buildDFA());
+    const unique_ptr<DFA> renDfa(dfa->renamedOf());
+    builder.addFinalState("q1"); // q1 was not final
+    const unique_ptr<DFA> modDfa(builder.buildDFA());
+
+    Tape ce;
+    startTimer();
+    bool eq = equivalent(*dfa, *renDfa); // via fingerprints
+    stopTimer();
+    cout << "dfa == renamed dfa: " << eq << ", " << elapsedTime() << " s" << endl;
+
+    const CompiledDFA cDfa(*dfa, false), cRenDfa(*renDfa, false), cModDfa(*modDfa, false);
+    startTimer();
+    eq = equivalent(cDfa, cRenDfa); // via union-find
+    stopTimer();
+    cout << "dfa == renamed dfa (union-find): " << eq << ", " << elapsedTime() << " s" << endl;
+
+    startTimer();
+    eq = equivalent(cDfa, cModDfa, &ce);
+    stopTimer();
+    cout << "dfa == modified dfa: " << eq << ", " << elapsedTime() << " s, counterexample of length "
+         << ce.length() << ": " << dfa->accepts(ce) << " vs. " << modDfa->accepts(ce) << endl;
+
+    // NFA for (a|b)* a (a|b)^(k-1), inclusion in NFA for (a|b)* a (a|b)^*
+    constexpr int k = 16;
+    FABuilder nb;
+    nb.setStartState("Q0")
+      .addTransition("Q0", 'a', "Q0").addTransition("Q0", 'b', "Q0")
+      .addTransition("Q0", 'a', "Q1").addFinalState("Q" + to_string(k));
+    for (int i = 1; i < k; i++)
+        nb.addTransition("Q" + to_string(i), 'a', "Q" + to_string(i + 1))
+          .addTransition("Q" + to_string(i), 'b', "Q" + to_string(i + 1));
+    const unique_ptr<NFA> nfa(nb.buildNFA());
+    const unique_ptr<NFA> someA(FABuilder(
+        "-> S -> a S | b S | a A \n\
+         () A -> a A | b A").buildNFA());
+
+    startTimer();
+    bool inc1 = includedIn(*nfa, *someA, &ce);
+    bool inc2 = includedIn(*someA, *nfa, &ce);
+    stopTimer();
+    cout << "nfa <= someA: " << inc1 << ", someA <= nfa: " << inc2
+         << " (counterexample \"" << ce << "\"), " << elapsedTime() << " s" << endl;
+}
+
+void testLazyProducts() {
+    cout << "16. Lazy product automata" << endl;
+    cout << "-------------------------" << endl;
+    cout << endl;
+
+    // "matches A and not B": identifiers containing "ab" but not ending with "b"
+    const unique_ptr<DFA> containsAB(FABuilder(
+        "-> S -> a A | b S     \n\
+            A -> a A | b F     \n\
+         () F -> a F | b F").buildDFA());
+    FABuilder endsWithBBuilder;
+    endsWithBBuilder.setStartState("S")
+            .addTransition("S", 'a', "S")
+            .addTransition("S", 'b', {"S", "F"})
+            .addFinalState("F");
+    const unique_ptr<NFA> endsWithB(endsWithBBuilder.buildNFA());
+    LazyDFAPtr aNotB = differenceOf(lazyOf(*containsAB), lazyOf(*endsWithB));
+
+    Tape witness;
+    bool empty = aNotB->isEmpty(&witness);
+    cout << "A \\ B empty: " << empty << ", witness \"" << witness << "\"" << endl;
+    const unique_ptr<DFA> aNotBDfa(aNotB->dfaOf());
+    cout << "A \\ B materialized:" << endl << *aNotBDfa;
+
+    LazyDFAPtr notA = complementOf(lazyOf(*containsAB));
+    cout << "complement of A accepts \"ba\": " << notA->accepts("ba")
+         << ", \"bab\": " << notA->accepts("bab") << endl;
+    cout << "A and complement of A empty: "
+         << intersectionOf(lazyOf(*containsAB), notA)->isEmpty() << endl;
+
+    // large random DFAs, emptiness of the intersection stops early
+    constexpr int nStates = 100000;
+    mt19937 rng(4711);
+    uniform_int_distribution<int> anyState(0, nStates - 1);
+    auto randomDFA = [&](const string &symbols) {
+        FABuilder builder;
+        builder.setStartState("q0");
+        for (int i = 0; i < nStates; i++) {
+            if (i + 1 < nStates) // z to make all states reachable
+                builder.addTransition("q" + to_string(i), 'z', "q" + to_string(i + 1));
+            for (char tSy: symbols)
+                builder.addTransition("q" + to_string(i), tSy, "q" + to_string(anyState(rng)));
+            if (i % 1000 == 999)
+                builder.addFinalState("q" + to_string(i));
+        }
+        return unique_ptr<DFA>(builder.buildDFA());
+    };
+    const unique_ptr<DFA> d1(randomDFA("ab")), d2(randomDFA("ab"));
+    startTimer();
+    LazyDFAPtr both = intersectionOf(lazyOf(*d1), lazyOf(*d2));
+    empty = both->isEmpty(&witness);
+    stopTimer();
+    cout << "intersection of two " << nStates << "-state DFAs empty: " << empty
+         << ", witness of length " << witness.length() << ", "
+         << both->nrOfExploredStates() << " pairs explored, "
+         << elapsedTime() << " s" << endl;
+}
+
+void testEpsFree() {
+    cout << "17. Epsilon removal" << endl;
+    cout << "-------------------" << endl;
+    cout << endl;
+
+    // chain of k blocks (a|b) with epsilon loops back and epsilon cycles
+    constexpr int k = 40;
+    FABuilder builder;
+    auto p = [](int i) { return "P" + to_string(i); };
+    builder.setStartState(p(0)).addFinalState(p(k));
+    for (int i = 0; i < k; i++) {
+        const string a = "A" + to_string(i), b = "B" + to_string(i), q = "Q" + to_string(i);
+        builder.addTransition(p(i), eps, {a, b, q})
+               .addTransition(q, eps, p(i))   // epsilon cycle p(i) <-> q
+               .addTransition(a, 'a', p(i + 1))
+               .addTransition(b, 'b', p(i + 1))
+               .addTransition(p(i + 1), eps, p(i)); // loop back
+    }
+    const unique_ptr<NFA> nfa(builder.buildNFA());
+
+    startTimer();
+    const unique_ptr<NFA> efNfa(nfa->epsFreeOf());
+    stopTimer();
+    cout << "epsFreeOf: " << nfa->S.size() << " -> " << efNfa->S.size()
+         << " states, " << elapsedTime() << " s" << endl;
+
+    mt19937 rng(4711);
+    vector<Tape> tapes(100);
+    for (auto &tape: tapes)
+        for (int i = 0; i < 200; i++)
+            tape += (rng() % 2) ? 'a' : 'b';
+    int n1 = 0, n2 = 0;
+    startTimer();
+    for (const auto &tape: tapes)
+        n1 += nfa->accepts3(tape);
+    stopTimer();
+    cout << "accepts3 on epsilon NFA:      " << n1 << " accepted, " << elapsedTime() << " s" << endl;
+    startTimer();
+    for (const auto &tape: tapes)
+        n2 += efNfa->accepts3(tape);
+    stopTimer();
+    cout << "accepts3 on epsilon-free NFA: " << n2 << " accepted, " << elapsedTime() << " s" << endl;
+    cout << "equivalent: " << equivalent(*nfa, *efNfa) << endl;
+
+    // language {eps}: no transitions left
+    FABuilder epsBuilder;
+    epsBuilder.setStartState("S").addFinalState("S").addTransition("S", eps, "S");
+    const unique_ptr<NFA> epsNfa(epsBuilder.buildNFA());
+    const unique_ptr<NFA> efEpsNfa(epsNfa->epsFreeOf());
+    const unique_ptr<DFA> epsDfa(lazyOf(*epsNfa)->dfaOf());
+    cout << "{eps}: epsFreeOf " << efEpsNfa->S.size() << " state, accepts \"\": "
+         << efEpsNfa->accepts3("") << ", \"a\": " << efEpsNfa->accepts3("a")
+         << ", equivalent: " << equivalent(*epsNfa, *efEpsNfa) << ", LazyDFA::dfaOf "
+         << epsDfa->S.size() << " state, accepts \"\": " << epsDfa->accepts("") << endl;
+}
+
+void testReduction() {
+    cout << "18. NFA reduction" << endl;
+    cout << "-----------------" << endl;
+    cout << endl;
+
+    // k redundant copies of (a|b)* a (a|b)^m, joined by epsilon moves
+    constexpr int k = 20, m = 10;
+    FABuilder builder;
+    builder.setStartState("S");
+    for (int c = 0; c < k; c++) {
+        auto q = [c](int i) { return "C" + to_string(c) + "_" + to_string(i); };
+        builder.addTransition("S", eps, q(0))
+               .addTransition(q(0), 'a', {q(0), q(1)})
+               .addTransition(q(0), 'b', q(0))
+               .addFinalState(q(m + 1));
+        for (int i = 1; i <= m; i++)
+            builder.addTransition(q(i), 'a', q(i + 1))
+                   .addTransition(q(i), 'b', q(i + 1));
+    }
+    const unique_ptr<NFA> nfa(builder.buildNFA());
+
+    for (bool useSimulation: {false, true}) {
+        NFAReductionReport report;
+        startTimer();
+        const unique_ptr<NFA> reduced(reducedOf(*nfa, useSimulation, &report));
+        stopTimer();
+        cout << "reducedOf (simulation: " << useSimulation << "): "
+             << elapsedTime() << " s" << endl;
+        cout << "  " << report << endl;
+        cout << "  equivalent: " << equivalent(*nfa, *reduced) << endl;
+    }
+
+    const unique_ptr<NFA> reduced(reducedOf(*nfa));
+    startTimer();
+    const unique_ptr<DFA> dfa1(nfa->dfaOf());
+    stopTimer();
+    cout << "dfaOf without reduction: " << dfa1->S.size() << " states, "
+         << elapsedTime() << " s" << endl;
+    startTimer();
+    const unique_ptr<DFA> dfa2(reduced->dfaOf());
+    stopTimer();
+    cout << "dfaOf with reduction:    " << dfa2->S.size() << " states, "
+         << elapsedTime() << " s" << endl;
+}
+
+void testRegex() {
+    cout << "19. Regex: Thompson vs. Glushkov" << endl;
+    cout << "--------------------------------" << endl;
+    cout << endl;
+
+    mt19937 rng(4711);
+    auto wordOf = [&rng](int len) {
+        string w;
+        for (int i = 0; i < len; i++)
+            w += (char)('a' + rng() % 26);
+        return w;
+    };
+    vector<string> keywords(1000);
+    string words;            // alternative of 1000 keywords
+    for (int i = 0; i < 1000; i++) {
+        keywords[i] = wordOf(3 + rng() % 8);
+        words += (i > 0 ? "|" : "") + keywords[i];
+    }
+    const vector<string> patterns = {
+        "[A-Za-z_][A-Za-z0-9_]*",
+        "[+-]?(\\d+\\.\\d*|\\.\\d+)([eE][+-]?\\d+)?",
+        "(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)",
+        "/\\*([^*]|\\*+[^*/])*\\*+/",
+        "(" + words + ")",
+    };
+    const vector<string> alphabets = { // for tapes of the patterns
+        "abcXYZ_019",
+        "+-0123456789.eE",
+        "ab",
+        "/*a ",
+        "abcdefghijklmnopqrstuvwxyz",
+    };
+
+    // tapes of pattern p, each second one with a random symbol replaced
+    auto tapeOf = [&](size_t p) {
+        const string &a = alphabets[p];
+        auto some = [&](const string &syms, int n) {
+            string t;
+            for (int i = 0; i < n; i++)
+                t += syms[rng() % syms.size()];
+            return t;
+        };
+        const string digits = "0123456789";
+        Tape tape;
+        switch (p) {
+            case 0:
+                tape = some("abcXYZ_", 1) + some(a, rng() % 16);
+                break;
+            case 1:
+                tape = some("+-", rng() % 2);
+                tape += rng() % 2 ? some(digits, 1 + rng() % 5) + "." + some(digits, rng() % 5)
+                                  : "." + some(digits, 1 + rng() % 5);
+                if (rng() % 2)
+                    tape += some("eE", 1) + some("+-", rng() % 2) + some(digits, 1 + rng() % 3);
+                break;
+            case 2:
+                tape = some(a, 9 + rng() % 20);
+                break;
+            case 3:
+                tape = "/*";
+                for (int i = rng() % 8; i > 0; i--)
+                    tape += rng() % 2 ? some("/a ", 1) : string(1 + rng() % 3, '*') + some("a ", 1);
+                tape += string(1 + rng() % 3, '*') + "/";
+                break;
+            default:
+                tape = keywords[rng() % keywords.size()];
+        }
+        if (rng() % 2)
+            tape[rng() % tape.size()] = a[rng() % a.size()];
+        return tape;
+    };
+
+    // hand-built NFA for (a|b)*a(a|b)^8
+    FABuilder builder;
+    builder.setStartState("0").addFinalState("9")
+           .addTransition("0", 'a', "0").addTransition("0", 'b', "0")
+           .addTransition("0", 'a', "1");
+    for (int i = 1; i < 9; i++)
+        builder.addTransition(to_string(i), 'a', to_string(i + 1))
+               .addTransition(to_string(i), 'b', to_string(i + 1));
+    const unique_ptr<NFA> handNfa(builder.buildNFA());
+    const CompiledNFA handCNfa(*handNfa);
+
+    for (size_t p = 0; p < patterns.size(); p++) {
+        cout << (patterns[p].length() <= 50 ? patterns[p] : patterns[p].substr(0, 47) + "...") << endl;
+        vector<Tape> tapes(1000);
+        for (auto &tape: tapes)
+            tape = tapeOf(p);
+        constexpr int nCompiles = 100;
+        int accepted[2];
+        for (bool glushkov: {false, true}) {
+            startTimer();
+            int nStates = 0;
+            for (int i = 0; i < nCompiles; i++) {
+                const Regex re(patterns[p]);
+                nStates = (glushkov ? re.glushkovOf() : re.thompsonOf()).nrOfStates();
+            }
+            stopTimer();
+            const double compileTime = elapsedTime() / nCompiles;
+            const Regex re(patterns[p]);
+            const CompiledNFA cNfa = glushkov ? re.glushkovOf() : re.thompsonOf();
+            constexpr int nRounds = 100;
+            int n = 0;
+            startTimer();
+            for (int i = 0; i < nRounds; i++)
+                for (const auto &tape: tapes)
+                    n += cNfa.accepts(tape);
+            stopTimer();
+            accepted[glushkov] = n / nRounds;
+            cout << "  " << (glushkov ? "Glushkov: " : "Thompson: ")
+                 << nStates << " states, compile " << compileTime * 1e3 << " ms, "
+                 << nRounds * tapes.size() << " tapes in " << elapsedTime() << " s ("
+                 << n / nRounds << " accepted)" << endl;
+        }
+        const Regex re(patterns[p]);
+        const CompiledNFA thompson = re.thompsonOf(), glushkov = re.glushkovOf();
+        cout << "  accepted counts " << (accepted[0] == accepted[1] ? "agree" : "DIFFER")
+             << ", equivalent: " << (includedIn(thompson, glushkov) && includedIn(glushkov, thompson));
+        if (p == 2)
+            cout << ", equivalent to hand-built NFA: "
+                 << (includedIn(thompson, handCNfa) && includedIn(handCNfa, thompson));
+        cout << endl;
+    }
+}
+
+void testFragments() {
+    cout << "20. Fragment combinators" << endl;
+    cout << "------------------------" << endl;
+    cout << endl;
+
+    constexpr int k = 5000;  // alternative of k keywords
+    mt19937 rng(4711);
+    vector<string> words(k);
+    for (auto &w: words)
+        for (int i = 0, len = 3 + rng() % 8; i < len; i++)
+            w += (char)('a' + rng() % 26);
+
+    // 1. by hand with FABuilder and fresh state names
+    startTimer();
+    FABuilder builder;
+    builder.setStartState("S").addFinalState("F");
+    for (int i = 0; i < k; i++) {
+        const string prefix = "W" + to_string(i) + "_";
+        State src = "S";
+        for (size_t j = 0; j < words[i].length(); j++) {
+            const State dest = j + 1 == words[i].length() ? "F" : prefix + to_string(j);
+            builder.addTransition(src, words[i][j], dest);
+            src = dest;
+        }
+    }
+    const unique_ptr<NFA> nfa1(std::move(builder).buildNFA());
+    stopTimer();
+    cout << "FABuilder::addTransition: " << nfa1->S.size() << " states, "
+         << elapsedTime() << " s" << endl;
+
+    // 2. with combinators on integer ids, one pass to the NFA
+    startTimer();
+    FragmentArena arena;
+    vector<FragmentArena::Fragment> alternatives;
+    alternatives.reserve(k);
+    for (const auto &w: words)
+        alternatives.push_back(arena.literal(w));
+    const unique_ptr<NFA> nfa2(arena.nfaOf(arena.alternate(alternatives)));
+    stopTimer();
+    cout << "FragmentArena::nfaOf:     " << nfa2->S.size() << " states, "
+         << elapsedTime() << " s" << endl;
+
+    // 3. same without state names at all
+    startTimer();
+    FragmentArena arena2;
+    alternatives.clear();
+    for (const auto &w: words)
+        alternatives.push_back(arena2.literal(w));
+    const CompiledNFA cNfa = arena2.compiledOf(arena2.alternate(alternatives));
+    stopTimer();
+    cout << "FragmentArena::compiledOf: " << cNfa.nrOfStates() << " states, "
+         << elapsedTime() << " s" << endl;
+    cout << "equivalent: " << equivalent(*nfa1, *nfa2) << endl;
+
+    // 4. repetitions, IPv4 addresses: d{1,3} (. d{1,3}){3}
+    FragmentArena arena3;
+    CompiledNFA::SymbolSet digits;
+    for (char d = '0'; d <= '9'; d++)
+        digits.set((unsigned char)d);
+    auto number = [&]() { return arena3.repeat(arena3.symbols(digits), 1, 3); };
+    const auto ip = arena3.concat(number(),
+                                  arena3.repeat(arena3.concat(arena3.symbol('.'), number()), 3, 3));
+    const CompiledNFA ipNfa = arena3.compiledOf(ip);
+    cout << "IPv4 NFA: " << ipNfa.nrOfStates() << " states, accepts 192.168.0.1: "
+         << ipNfa.accepts("192.168.0.1") << ", 1.2.3: " << ipNfa.accepts("1.2.3") << endl;
+}
+
+void testRanges() {
+    cout << "21. Range transitions for large alphabets" << endl;
+    cout << "-----------------------------------------" << endl;
+    cout << endl;
+
+    // identifiers over Unicode: (letter | CJK) (letter | CJK | digit)*
+    constexpr WideSymbol maxCodePoint = 0x10FFFF;
+    RangeSet first;
+    first.add('A', 'Z').add('a', 'z').add('_', '_').add(0x4E00, 0x9FFF);
+    RangeSet rest(first);
+    rest.add('0', '9');
+    RangeNFA rNfa(2);
+    rNfa.setStartState(0).addFinalState(1)
+        .addTransition(0, first, 1)
+        .addTransition(1, rest, 1);
+    startTimer();
+    const RangeDFA rDfa = rNfa.dfaOf().minimalOf();
+    stopTimer();
+    size_t nSymbols = 0;
+    for (const auto &r: rest.ranges())
+        nSymbols += r.hi - r.lo + 1;
+    cout << "identifier DFA: " << rDfa.nrOfStates() << " states, "
+         << rDfa.nrOfRanges() << " ranges, " << rDfa.nrOfClasses() << " classes, "
+         << rDfa.memoryInBytes() << " bytes (vs. " << nSymbols
+         << " transitions per symbol), built in " << elapsedTime() << " s" << endl;
+    RangeDFA tableDfa = rDfa;
+    tableDfa.buildClassTable();
+    cout << "with class table: " << tableDfa.memoryInBytes() << " bytes" << endl;
+    cout << "complement of first symbols: " << first.complementOf(maxCodePoint) << endl;
+
+    mt19937 rng(4711);
+    vector<vector<WideSymbol>> tapes(1000);
+    for (auto &tape: tapes)
+        for (int i = 0, len = 5 + rng() % 20; i < len; i++)
+            tape.push_back(rng() % 4 ? 0x4E00 + rng() % 0x5200    // some beyond CJK
+                                    : (rng() % 2 ? 'a' + rng() % 26 : '0' + rng() % 10));
+
+    constexpr int nRounds = 1000;
+    for (int mode = 0; mode < 3; mode++) { // next, nextOfClass w/o and with table
+        const bool byClass = mode > 0;
+        const RangeDFA &rDfa2 = mode < 2 ? rDfa : tableDfa;
+        int n = 0;
+        startTimer();
+        for (int i = 0; i < nRounds; i++)
+            for (const auto &tape: tapes) {
+                RangeDFA::StateId s = rDfa2.startState();
+                for (WideSymbol sy: tape) {
+                    s = byClass ? rDfa2.nextOfClass(s, rDfa2.classOf(sy)) : rDfa2.next(s, sy);
+                    if (s == RangeDFA::undef)
+                        break;
+                }
+                n += s != RangeDFA::undef && rDfa2.isFinal(s);
+            }
+        stopTimer();
+        const char *modes[] = {"next:                    ", "nextOfClass (ranges):    ",
+                               "nextOfClass (table):     "};
+        cout << modes[mode] << nRounds * tapes.size()
+             << " tapes in " << elapsedTime() << " s (" << n / nRounds << " accepted)" << endl;
+    }
+
+    // byte alphabet: alternative of 100 keywords, per symbol vs. ranges
+    FragmentArena arena;
+    vector<FragmentArena::Fragment> alternatives;
+    for (int i = 0; i < 100; i++) {
+        string w;
+        for (int j = 0, len = 3 + rng() % 8; j < len; j++)
+            w += (char)('a' + rng() % 26);
+        alternatives.push_back(arena.literal(w));
+    }
+    const unique_ptr<NFA> nfa(arena.nfaOf(arena.alternate(alternatives)));
+    startTimer();
+    const unique_ptr<DFA> dfa(nfa->dfaOf());
+    const unique_ptr<DFA> minDfa(dfa->minimalOf());
+    stopTimer();
+    cout << "NFA::dfaOf + minimalOf:      " << minDfa->S.size() << " states, "
+         << elapsedTime() << " s" << endl;
+    startTimer();
+    RangeDFA kDfa = RangeNFA(*nfa).dfaOf().minimalOf();
+    stopTimer();
+    cout << "RangeNFA::dfaOf + minimalOf: " << kDfa.nrOfStates() << " states, "
+         << kDfa.nrOfRanges() << " ranges, " << elapsedTime() << " s" << endl;
+    const size_t kRangeBytes = kDfa.memoryInBytes();
+    kDfa.buildClassTable();
+    cout << "memory: " << kRangeBytes << " bytes, with class table "
+         << kDfa.memoryInBytes() << " bytes" << endl;
+    const unique_ptr<DFA> kDfa2(kDfa.dfaOf());
+    cout << "equivalent: " << equivalent(*minDfa, *kDfa2) << endl;
+}
+
+void testBinaryTapes() {
+    cout << "22. Binary tapes (all 256 byte values)" << endl;
+    cout << "--------------------------------------" << endl;
+    cout << endl;
+
+    // frames: 0x7E, type 0x00 or 0x01, payload without 0x7E, 0x7E
+    const Regex frame("\\x7E[\\x00\\x01][^\\x7E]*\\x7E");
+    const CompiledDFA binDfa(frame.glushkovOf());
+    cout << "frame DFA: " << binDfa.nrOfStates() << " states, "
+         << binDfa.nrOfClasses() << " classes" << endl;
+    const Tape ok("\x7E\x00\x00\x01\xFF\x7E", 6), bad("\x7E\x02\x00\x7E", 4);
+    cout << "accepts frame with NULs: " << binDfa.accepts(ok)
+         << ", with type 0x02: " << binDfa.accepts(bad) << endl;
+
+    // same DFA for text, must be as fast on text as on binary data
+    const Regex ident("[A-Za-z_][A-Za-z0-9_]*");
+    const CompiledDFA textDfa(ident.glushkovOf());
+    mt19937 rng(4711);
+    Tape text(1 << 24, 'a'), binary("\x7E\x01", 2);
+    for (size_t i = 1; i < text.size(); i++)
+        text[i] = "abcxyz_019"[rng() % 10];
+    while (binary.size() < text.size() - 1) {
+        const char b = (char)(rng() % 256);
+        binary += b == '\x7E' ? '\x00' : b;
+    }
+    binary += '\x7E';
+    constexpr int nRounds = 20;
+    for (bool bin: {false, true}) {
+        const CompiledDFA &cDfa = bin ? binDfa : textDfa;
+        const TapeView tape = bin ? binary : text;
+        int n = 0;
+        startTimer();
+        for (int i = 0; i < nRounds; i++)
+            n += cDfa.accepts(tape);
+        stopTimer();
+        cout << (bin ? "binary: " : "text:   ") << nRounds << " x " << tape.size()
+             << " bytes in " << elapsedTime() << " s (" << n << " accepted)" << endl;
+    }
+}
+
+void testUtf8() {
+    cout << "23. UTF-8: code point ranges compiled to bytes" << endl;
+    cout << "----------------------------------------------" << endl;
+    cout << endl;
+
+    // sentences of words in several scripts: word (" " word)*
+    const vector<pair<WideSymbol, WideSymbol>> scripts = {
+        {'a', 'z'},         // Latin
+        {0xE0, 0xFF},       // Latin-1 letters with diacritics
+        {0x3B1, 0x3C9},     // Greek
+        {0x430, 0x44F},     // Cyrillic
+        {0x621, 0x64A},     // Arabic
+        {0x3041, 0x3096},   // Hiragana
+        {0x4E00, 0x9FFF},   // CJK
+        {0x1F600, 0x1F64F}, // emoticons
+    };
+    RangeSet letters;
+    for (const auto &sc: scripts)
+        letters.add(sc.first, sc.second);
+    RangeNFA cpNfa(3);
+    cpNfa.setStartState(0).addFinalState(1)
+         .addTransition(0, letters, 1)
+         .addTransition(1, letters, 1)
+         .addTransition(1, ' ', ' ', 2)
+         .addTransition(2, letters, 1);
+
+    startTimer();
+    const RangeNFA byteNfa = utf8Of(cpNfa);
+    const RangeDFA byteDfa = byteNfa.dfaOf();
+    const RangeDFA minDfa  = byteDfa.minimalOf();
+    const CompiledDFA cDfa = minDfa.compiledOf();
+    stopTimer();
+    const RangeDFA cpDfa = cpNfa.dfaOf().minimalOf();
+    cout << "code points: " << cpNfa.nrOfRanges() << " ranges, DFA with "
+         << cpDfa.nrOfStates() << " states" << endl;
+    cout << "bytes:       NFA with " << byteNfa.nrOfStates() << " states (shared suffixes), DFA with "
+         << byteDfa.nrOfStates() << " -> " << minDfa.nrOfStates() << " states (minimal), "
+         << cDfa.nrOfClasses() << " classes, " << elapsedTime() << " s" << endl;
+
+    mt19937 rng(4711);
+    Tape corpus;             // one sentence per line, 1 in 8 with a '!'
+    vector<TapeView> lines;
+    vector<size_t> ends;
+    while (corpus.size() < (1 << 24)) {
+        for (int w = 0, nWords = 5 + rng() % 10; w < nWords; w++) {
+            if (w > 0)
+                corpus += ' ';
+            const auto &sc = scripts[rng() % scripts.size()];
+            for (int i = 0, len = 2 + rng() % 8; i < len; i++)
+                appendUtf8(corpus, sc.first + rng() % (sc.second - sc.first + 1));
+        }
+        if (rng() % 8 == 0)
+            corpus += '!';
+        ends.push_back(corpus.size());
+    }
+    for (size_t i = 0, b = 0; i < ends.size(); b = ends[i++])
+        lines.push_back(TapeView(corpus).substr(b, ends[i] - b));
+    cout << "corpus: " << lines.size() << " lines, " << corpus.size() << " bytes" << endl;
+
+    vector<WideSymbol> cps;
+    for (int mode = 0; mode < 3; mode++) {
+        int n = 0;
+        startTimer();
+        for (const TapeView line: lines)
+            switch (mode) {
+                case 0:      // decode, then one transition per code point
+                    n += codePointsOf(line, cps) && cpDfa.accepts(cps);
+                    break;
+                case 1:
+                    n += minDfa.accepts(line);
+                    break;
+                default:
+                    n += cDfa.accepts(line);
+            }
+        stopTimer();
+        cout << (mode == 0 ? "decode + code point RangeDFA: " :
+                 mode == 1 ? "byte RangeDFA:                " :
+                             "byte CompiledDFA:             ")
+             << n << " accepted in " << elapsedTime() << " s ("
+             << corpus.size() / 1e6 / max(elapsedTime(), 1e-3) << " MB/s)" << endl;
+    }
+}
+
+void testShuffle() {
+    cout << "24. Shuffle-based DFAs for small state counts" << endl;
+    cout << "---------------------------------------------" << endl;
+    cout << endl;
+
+    cout << "best engine of this CPU: " << ShuffleDFA::nameOf(ShuffleDFA::bestEngine()) << endl;
+    mt19937 rng(4711);
+    const vector<pair<string, string>> cases = { // pattern, symbols of the tape
+        {"[A-Za-z_][A-Za-z0-9_]*", "abcxyz_019"},
+        {"(a|b)*a(a|b)(a|b)(a|b)", "ab"},
+    };
+    const unsigned nThreads = max(thread::hardware_concurrency(), 1u);
+    for (const auto &c: cases) {
+        const CompiledDFA cDfa(Regex(c.first).glushkovOf());
+        Tape tape(1 << 26, c.second[0]);
+        for (size_t i = 1; i < tape.size(); i++)
+            tape[i] = c.second[rng() % c.second.size()];
+        cout << c.first << ": " << cDfa.nrOfStates() << " states, "
+             << tape.size() << " bytes" << endl;
+        constexpr int nRounds = 2;
+        int n = 0;
+        startTimer();
+        for (int i = 0; i < nRounds; i++)
+            n += cDfa.accepts(tape);
+        stopTimer();
+        cout << "  CompiledDFA:        " << elapsedTime() / nRounds << " s (" << n << ")" << endl;
+        for (auto e: {ShuffleDFA::Engine::scalar, ShuffleDFA::bestEngine()}) {
+            const ShuffleDFA sDfa(cDfa, e);
+            n = 0;
+            startTimer();
+            for (int i = 0; i < nRounds; i++)
+                n += sDfa.accepts(tape);
+            stopTimer();
+            const double t1 = elapsedTime() / nRounds;
+            n = 0;
+            startTimer();
+            for (int i = 0; i < nRounds; i++)
+                n += sDfa.acceptsParallel(tape, nThreads);
+            stopTimer();
+            cout << "  ShuffleDFA " << setw(6) << left << ShuffleDFA::nameOf(sDfa.engine()) << right
+                 << "(" << sDfa.nrOfStates() << " states): " << t1 << " s, "
+                 << nThreads << " threads: " << elapsedTime() / nRounds << " s (" << n << ")" << endl;
+        }
+    }
+}
+
+void testAcceleration() {
+    cout << "25. Accelerated self-looping states" << endl;
+    cout << "-----------------------------------" << endl;
+    cout << endl;
+
+    mt19937 rng(4711);
+    Tape text(1 << 26, ' ');   // text without '*', '/' and 'q'
+    for (char &ch: text)
+        ch = "abcdefghijklmnoprstuvwxyz \n"[rng() % 27];
+    constexpr int nRounds = 5;
+
+    // 1. accepts: one long C comment
+    const Tape comment = "/*" + text + "*/";
+    const CompiledDFA commentDfa =
+        CompiledDFA(Regex("/\\*([^*]|\\*+[^*/])*\\*+/").glushkovOf()).minimalOf();
+    cout << "comment DFA: " << commentDfa.nrOfStates() << " states, "
+         << commentDfa.nrOfAcceleratedStates() << " accelerated" << endl;
+    int n = 0;
+    startTimer();
+    for (int i = 0; i < nRounds; i++)
+        n += commentDfa.accepts(comment);
+    stopTimer();
+    cout << "  accepts: " << elapsedTime() / nRounds << " s (" << n / nRounds << ")" << endl;
+
+    // 2. scan: first match of q(u|x) near the end of the text, the
+    //    start state of the minimal DFA loops on all bytes but q
+    Tape haystack = text;
+    haystack.replace(haystack.size() - 100, 2, "qx");
+    const CompiledDFA searchDfa =
+        CompiledDFA(Regex("(.|\\n)*q(u|x)").glushkovOf()).minimalOf();
+    cout << "(.|\\n)*q(u|x) DFA: " << searchDfa.nrOfStates() << " states, "
+         << searchDfa.nrOfAcceleratedStates() << " accelerated" << endl;
+    size_t end = 0;
+    startTimer();
+    for (int i = 0; i < nRounds; i++)
+        end = searchDfa.scan(haystack);
+    stopTimer();
+    cout << "  scan:    " << elapsedTime() / nRounds << " s (match ends at " << end << ")" << endl;
+    const char *volatile data = haystack.data(); // memchr is pure, so
+    size_t pos = 0;                              //   keep it in the loop
+    startTimer();
+    for (int i = 0; i < nRounds; i++)
+        pos += (const char *)memchr(data, 'q', haystack.size()) - haystack.data();
+    stopTimer();
+    cout << "  memchr:  " << elapsedTime() / nRounds << " s (q at "
+         << pos / nRounds << ")" << endl;
+
+    // 3. loop scan: too many escape bytes for memchr, as all bytes but
+    //    28 have no transition
+    const CompiledDFA plainDfa(Regex("[a-z \\n]*").glushkovOf());
+    n = 0;
+    startTimer();
+    for (int i = 0; i < nRounds; i++)
+        n += plainDfa.accepts(text);
+    stopTimer();
+    cout << "[a-z \\n]* (" << plainDfa.nrOfAcceleratedStates() << " accelerated): "
+         << elapsedTime() / nRounds << " s per run with loop scan (" << n / nRounds << ")" << endl;
+
+    // 4. the same for a DFA built from maps, whose V is the 28 symbols
+    FABuilder fab;
+    fab.setStartState("T").addFinalState("T");
+    for (char ch: string("abcdefghijklmnoprstuvwxyz \n"))
+        fab.addTransition("T", ch, "T");
+    const unique_ptr<DFA> textDfa(fab.buildDFA());
+    const CompiledDFA cTextDfa(*textDfa);
+    n = 0;
+    startTimer();
+    for (int i = 0; i < nRounds; i++)
+        n += cTextDfa.accepts(text);
+    stopTimer();
+    Tape withQ = text;
+    withQ[withQ.size() / 2] = 'q';   // no transition, so no acceptance
+    cout << "FABuilder DFA (" << cTextDfa.nrOfAcceleratedStates() << " accelerated): "
+         << elapsedTime() / nRounds << " s per run (" << n / nRounds << "), with q: "
+         << cTextDfa.accepts(withQ) << endl;
+
+    // 5. short runs: loop scan states left after a few bytes, so the
+    //    table walk does (nearly) all the work, long runs for comparison
+    auto wordsOf = [&rng, &text](const string &syms, const string &seps, int minLen, int maxLen) {
+        Tape t;
+        while (t.size() < text.size()) {
+            for (int i = minLen + rng() % (maxLen - minLen + 1); i > 0; i--)
+                t += syms[rng() % syms.size()];
+            t += seps[rng() % seps.size()];
+        }
+        return t;
+    };
+    const string lower = "abcdefghijklmnopqrstuvwxyz", ident = lower + "0123456789_";
+    const CompiledDFA wordDfa(Regex("([a-z]+ )*").glushkovOf()),
+                      identDfa(Regex("([a-z0-9_]+[ ,;])*").glushkovOf());
+    const struct { const char *name; const CompiledDFA &dfa; Tape tape; } runs[] = {
+        {"words of 1 .. 10 letters:  ", wordDfa,  wordsOf(lower, " ", 1, 10)},
+        {"words of 2 letters:        ", wordDfa,  wordsOf(lower, " ", 2, 2)},
+        {"identifiers of 1 .. 12:    ", identDfa, wordsOf(ident, " ,;", 1, 12)},
+        {"identifiers of 1000:       ", identDfa, wordsOf(ident, " ,;", 1000, 1000)},
+    };
+    for (const auto &r: runs) {
+        n = 0;
+        startTimer();
+        for (int i = 0; i < nRounds; i++)
+            n += r.dfa.accepts(r.tape);
+        stopTimer();
+        cout << r.name << elapsedTime() / nRounds << " s per run (" << n / nRounds << ")" << endl;
+    }
+}
+
+void testPrefilter() {
+    cout << "26. Required literals and prefilter" << endl;
+    cout << "-----------------------------------" << endl;
+    cout << endl;
+
+    // log lines of random words, few of them with an error or a timeout
+    mt19937 rng(4711);
+    const char *words[] = {"request", "user", "ok", "GET", "POST", "served", "in", "ms",
+                           "cache", "hit", "miss", "session", "id", "code", "200"};
+    vector<Tape> lines(200000);
+    for (size_t i = 0; i < lines.size(); i++) {
+        for (int k = 0; k < 16; k++)
+            lines[i] += string(words[rng() % 15]) + " ";
+        if (i % 1000 == 0)
+            lines[i] += "ERROR code 42 ";
+        else if (i % 1000 == 500)
+            lines[i] += "timeout ";
+    }
+
+    for (const char *pattern: {".*(ERROR|FATAL) code [0-9]+.*", ".*timeout.*",
+                               "[a-zA-Z0-9 ]*"}) {
+        const CompiledDFA dfa = CompiledDFA(Regex(pattern).glushkovOf()).minimalOf();
+        const Prefilter pf(dfa);
+        int n1 = 0, n2 = 0;
+        startTimer();
+        for (const Tape &line: lines)
+            n1 += dfa.accepts(line);
+        stopTimer();
+        const double tDfa = elapsedTime();
+        startTimer();
+        for (const Tape &line: lines)
+            n2 += pf.accepts(line);
+        stopTimer();
+        cout << pattern << endl;
+        cout << "  " << pf << endl;
+        cout << "  DFA only: " << tDfa << " s (" << n1 << " accepted), with prefilter: "
+             << elapsedTime() << " s (" << n2 << " accepted)" << endl;
+    }
+}
+
+void testAhoCorasick() {
+    cout << "27. Aho-Corasick keyword automata" << endl;
+    cout << "---------------------------------" << endl;
+    cout << endl;
+
+    mt19937 rng(4711);
+    auto randomWords = [&rng](size_t n) {
+        vector<Tape> words(n);
+        for (Tape &w: words)
+            for (int len = 4 + rng() % 7; len > 0; len--)
+                w += (char)('a' + rng() % 26);
+        return words;
+    };
+    Tape text(1 << 24, ' ');
+    for (char &ch: text)
+        ch = "abcdefghijklmnopqrstuvwxyz "[rng() % 27];
+
+    for (size_t n: {100000, 1000000}) {
+        const vector<Tape> words = randomWords(n);
+        for (AhoCorasick::Form form: {AhoCorasick::Form::compact, AhoCorasick::Form::full}) {
+            if (n > 100000 && form == AhoCorasick::Form::full)
+                continue;            // table with millions of rows
+            startTimer();
+            const AhoCorasick ac(words, form);
+            stopTimer();
+            cout << n << " words, " << (form == AhoCorasick::Form::full ? "full" : "compact")
+                 << ": " << ac.nrOfStates() << " states, " << ac.memoryInBytes() / (1 << 20)
+                 << " MB, built in " << elapsedTime() << " s" << endl;
+            startTimer();
+            const size_t nMatches = ac.findAll(text).size();
+            stopTimer();
+            cout << "  findAll on 16 MB: " << elapsedTime() << " s (" << nMatches << " matches)" << endl;
+        }
+    }
+
+    // DFA for a small dictionary
+    const AhoCorasick small(randomWords(1000));
+    startTimer();
+    unique_ptr<DFA> dfa(small.dfaOf());
+    stopTimer();
+    cout << "DFA for 1000 words: " << dfa->S.size() << " states in " << elapsedTime() << " s" << endl;
+
+    // CompiledDFA of it: accepts the tapes ending with a word, so scan
+    //   ends where the first match ends
+    const CompiledDFA cDfa = small.compiledOf();
+    const vector<AhoCorasick::Match> matches = small.findAll(text);
+    const size_t scanEnd = cDfa.scan(text);
+    cout << "CompiledDFA for 1000 words: " << cDfa.nrOfStates() << " states, first match ends at "
+         << scanEnd << " (" << (!matches.empty() && scanEnd == matches[0].end &&
+                                small.containsAny(text) ? "same" : "DIFFERENT")
+         << " as findAll)" << endl;
+
+    // words on all 256 bytes: 257 classes for Form::full
+    vector<Tape> allBytes;
+    for (int b = 0; b < 256; b++)
+        allBytes.push_back(Tape(1, (char)b) + "x");
+    const Tape haystack = "\xffx";
+    const AhoCorasick fullAc(allBytes), compactAc(allBytes, AhoCorasick::Form::compact);
+    cout << "256 words b + \"x\": " << fullAc.nrOfClasses() << " classes, matches in \"\\xffx\": "
+         << fullAc.findAll(haystack).size() << " (full), " << compactAc.findAll(haystack).size()
+         << " (compact), containsAny: " << fullAc.containsAny(haystack) << endl;
+    try {
+        fullAc.compiledOf();
+        cout << "  compiledOf: no length_error" << endl;
+    } catch (const length_error &e) {
+        cout << "  compiledOf: " << e.what() << endl;
+    }
+}
+
+void testDawg() {
+    cout << "28. Minimal acyclic DFAs (DAWGs) from word lists" << endl;
+    cout << "-------------------------------------------------" << endl;
+    cout << endl;
+
+    // words of syllables, so prefixes and suffixes are shared
+    mt19937 rng(4711);
+    const char *syllables[] = {"ka", "to", "ri", "ne", "su", "mo", "la", "pi",
+                               "er", "ing", "ed", "s", "un", "re", "tion", "al"};
+    auto randomWords = [&](size_t n) {
+        vector<Tape> words(n);
+        for (Tape &w: words)
+            for (int k = 2 + rng() % 5; k > 0; k--)
+                w += syllables[rng() % 16];
+        return words;
+    };
+    vector<Tape> words = randomWords(1000000);
+
+    for (bool sorted: {true, false}) {
+        if (sorted)
+            sort(words.begin(), words.end());
+        else
+            shuffle(words.begin(), words.end(), rng);
+        DawgBuilder db;
+        startTimer();
+        for (const Tape &w: words)
+            db.add(w);
+        stopTimer();
+        const double tAdd = elapsedTime();
+        startTimer();
+        const CompiledDFA cDfa = db.compiledOf();
+        stopTimer();
+        cout << (sorted ? "sorted:   " : "unsorted: ") << db.nrOfWords() << " words, "
+             << db.nrOfStates() << " states, " << db.nrOfTransitions() << " transitions, built in "
+             << tAdd << " s, compiled in " << elapsedTime() << " s" << endl;
+        if (!sorted) {
+            cDfa.save("dawg.fai");
+            const CompiledDFA loaded = CompiledDFA::load("dawg.fai");
+            size_t n = 0;
+            for (size_t i = 0; i < words.size(); i += 100)
+                n += loaded.accepts(words[i]);
+            cout << "  image: " << loaded.image().size() / 1e6 << " MB, "
+                 << n << " of " << (words.size() + 99) / 100 << " sample words accepted" << endl;
+        }
+    }
+
+    // DFA::minimalOf of the trie for a small part only (NeTable is quadratic)
+    const vector<Tape> few(words.begin(), words.begin() + 500);
+    DawgBuilder db;
+    startTimer();
+    for (const Tape &w: few)
+        db.add(w);
+    const unique_ptr<DFA> dawg(db.dfaOf());
+    stopTimer();
+    cout << "500 words: DawgBuilder + dfaOf: " << elapsedTime() << " s ("
+         << dawg->S.size() << " states)" << endl;
+    startTimer();
+    FABuilder fab;
+    fab.setStartState("q");    // states named q + prefix
+    for (const Tape &w: few) {
+        for (size_t i = 0; i < w.length(); i++)
+            fab.addTransition("q" + w.substr(0, i), w[i], "q" + w.substr(0, i + 1));
+        fab.addFinalState("q" + w);
+    }
+    const unique_ptr<DFA> trie(fab.buildDFA());
+    const unique_ptr<DFA> minimal(trie->minimalOf());
+    stopTimer();
+    cout << "           trie + minimalOf:    " << elapsedTime() << " s (" << trie->S.size()
+         << " -> " << minimal->S.size() << " states)" << endl;
+}
+
+void testLevenshtein() {
+    cout << "29. Levenshtein automata for approximate matching" << endl;
+    cout << "-------------------------------------------------" << endl;
+    cout << endl;
+
+    mt19937 rng(4711);
+    const char *syllables[] = {"ka", "to", "ri", "ne", "su", "mo", "la", "pi",
+                               "er", "ing", "ed", "s", "un", "re", "tion", "al"};
+    vector<Tape> words(200000);
+    for (Tape &w: words)
+        for (int k = 2 + rng() % 4; k > 0; k--)
+            w += syllables[rng() % 16];
+    sort(words.begin(), words.end());
+    words.erase(unique(words.begin(), words.end()), words.end());
+    DawgBuilder db;
+    for (const Tape &w: words)
+        db.add(w);
+    const CompiledDFA dict = db.compiledOf();
+    cout << words.size() << " words, dictionary DFA with " << dict.nrOfStates() << " states" << endl;
+
+    // queries: dictionary words with up to 2 random edits
+    vector<Tape> queries(200);
+    for (Tape &q: queries) {
+        q = words[rng() % words.size()];
+        for (int e = rng() % 3; e > 0 && !q.empty(); e--) {
+            const size_t i = rng() % q.size();
+            const char ch = (char)('a' + rng() % 26);
+            switch (rng() % 3) {
+                case 0: q[i] = ch;                   break;
+                case 1: q.insert(q.begin() + i, ch); break;
+                case 2: q.erase(i, 1);               break;
+            }
+        }
+    }
+
+    auto editDistance = [](const Tape &a, const Tape &b) {
+        vector<int> row(b.size() + 1);
+        for (size_t j = 0; j <= b.size(); j++)
+            row[j] = (int)j;
+        for (size_t i = 1; i <= a.size(); i++) {
+            int diag = row[0];
+            row[0] = (int)i;
+            for (size_t j = 1; j <= b.size(); j++) {
+                const int up = row[j];
+                row[j] = min({row[j] + 1, row[j - 1] + 1, diag + (a[i - 1] != b[j - 1])});
+                diag = up;
+            }
+        }
+        return row[b.size()];
+    };
+
+    for (int k = 1; k <= LevenshteinDFA::maxDistance; k++) {
+        size_t n1 = 0, n2 = 0, nStates = 0;
+        startTimer();
+        for (const Tape &q: queries) {
+            const LevenshteinDFA ld(q, k);
+            nStates += ld.nrOfStates();
+            n1 += ld.matchesIn(dict).size();
+        }
+        stopTimer();
+        const double tAutomaton = elapsedTime();
+        startTimer();
+        for (const Tape &q: queries)
+            for (const Tape &w: words)
+                n2 += abs((int)w.size() - (int)q.size()) <= k && editDistance(w, q) <= k;
+        stopTimer();
+        cout << "k = " << k << ": automaton + lazy product: " << tAutomaton << " s ("
+             << n1 << " matches, " << nStates / queries.size() << " states per automaton), "
+             << "brute force: " << elapsedTime() << " s (" << n2 << " matches)" << endl;
+    }
+
+    // a word on all 256 bytes: 257 classes
+    Tape allBytes;
+    for (int b = 0; b < 256; b++)
+        allBytes += (char)b;
+    Tape edited = allBytes;
+    edited[255] = 'x';
+    const LevenshteinDFA allLd(allBytes, 1);
+    cout << "word on all 256 bytes, k = 1: " << allLd.nrOfClasses() << " classes, distances "
+         << allLd.distanceOf(allBytes) << " (itself), " << allLd.distanceOf(edited)
+         << " (last byte replaced)" << endl;
+    try {
+        allLd.compiledOf();
+        cout << "  compiledOf: no length_error" << endl;
+    } catch (const length_error &e) {
+        cout << "  compiledOf: " << e.what() << endl;
+    }
+}
+
+void testSearch() {
+    cout << "30. Unanchored search with forward and reverse DFAs" << endl;
+    cout << "---------------------------------------------------" << endl;
+    cout << endl;
+
+    // log lines of 8 MB
+    mt19937 rng(4711);
+    const char *levels[] = {"INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR"};
+    const char *events[] = {"logged in", "logged out", "timeout after 30 s",
+                            "request failed", "cache miss"};
+    Tape text;
+    while (text.size() < (1 << 23))
+        text += "2024-05-" + to_string(10 + rng() % 20) + " " + levels[rng() % 6] +
+                " user" + to_string(rng() % 1000) + " " + events[rng() % 5] +
+                " from 10.0." + to_string(rng() % 256) + "." + to_string(rng() % 256) + "\n";
+
+    const vector<string> patterns = {
+        "ERROR user\\d+",
+        "10\\.0\\.\\d+\\.\\d+",
+        "(timeout|failed)",
+        "user\\d*7 (logged|request)[a-z ]*",
+    };
+    for (const string &p: patterns) {
+        const CompiledNFA cNfa = Regex(p).thompsonOf();
+        cout << p << endl;
+        for (auto kind: {Searcher::MatchKind::leftmostFirst, Searcher::MatchKind::leftmostLongest}) {
+            startTimer();
+            const Searcher searcher(cNfa, kind);
+            stopTimer();
+            const double tBuild = elapsedTime();
+            startTimer();
+            const vector<Searcher::Match> matches = searcher.findAll(text);
+            stopTimer();
+            cout << "  " << (kind == Searcher::MatchKind::leftmostFirst ? "leftmost-first:  " : "leftmost-longest: ")
+                 << searcher.forwardDfa().nrOfStates() << " + " << searcher.reverseDfa().nrOfStates()
+                 << " states, built in " << tBuild << " s, findAll: " << elapsedTime() << " s ("
+                 << matches.size() << " matches)" << endl;
+        }
+
+        // anchored DFA tried at each position, longest match
+        const CompiledDFA anchored(cNfa);
+        size_t n = 0;
+        startTimer();
+        for (size_t i = 0; i < text.size(); ) {
+            CompiledDFA::StateId s = anchored.startState();
+            size_t end = anchored.isFinal(s) ? i : CompiledDFA::npos;
+            for (size_t j = i; j < text.size(); j++) {
+                if ((s = anchored.next(s, text[j])) == CompiledDFA::undef)
+                    break;
+                if (anchored.isFinal(s))
+                    end = j + 1;
+            }
+            if (end != CompiledDFA::npos && end > i) {
+                n++;
+                i = end;
+            } else
+                i++;
+        }
+        stopTimer();
+        cout << "  anchored DFA at each position: " << elapsedTime() << " s (" << n << " matches)" << endl;
+    }
+}
+
+void testSubmatches() {
+    cout << "31. Submatch extraction with tagged DFAs" << endl;
+    cout << "----------------------------------------" << endl;
+    cout << endl;
+
+    // ConstDef of the README, e.g., "const int max = 10, min = -3;"
+    const string constDef =
+        "const (bool|int) ([a-z][a-z0-9]*) = (false|true|[+-]?[0-9]+)"
+        "(, ([a-z][a-z0-9]*) = (false|true|[+-]?[0-9]+))*;";
+    mt19937 rng(4711);
+    auto identOf = [&rng]() {
+        string id(1, (char)('a' + rng() % 26));
+        for (int k = rng() % 8; k > 0; k--)
+            id += "abcdefghijklmnopqrstuvwxyz0123456789"[rng() % 36];
+        return id;
+    };
+    vector<Tape> tapes(100000);
+    for (Tape &t: tapes) {
+        const bool isBool = rng() % 2;
+        t = string("const ") + (isBool ? "bool " : "int ");
+        for (int k = 1 + rng() % 3; k > 0; k--) {
+            t += identOf() + " = " + (isBool ? (rng() % 2 ? "true" : "false")
+                                             : (rng() % 2 ? "-" : "") + to_string(rng() % 1000));
+            t += k > 1 ? ", " : ";";
+        }
+    }
+
+    const Regex re(constDef);
+    const TaggedNFA tNfa = re.taggedOf();
+    const TaggedDFA tDfa(tNfa);
+    cout << constDef << endl;
+    cout << "  " << re.nrOfGroups() << " groups, tagged NFA: " << tNfa.nrOfStates()
+         << " states, tagged DFA: " << tDfa.nrOfStates() << " states, "
+         << tDfa.nrOfRegisters() << " registers, " << tDfa.nrOfOps() << " operations" << endl;
+    vector<TaggedNFA::Submatch> groups;
+    if (tDfa.match(tapes[0], groups)) {
+        cout << "  " << tapes[0] << endl;
+        for (int g = 1; g < (int)groups.size(); g++)
+            if (groups[g].start != TaggedNFA::npos)
+                cout << "    " << g << ": \"" << tapes[0].substr(groups[g].start,
+                                                    groups[g].end - groups[g].start) << "\"" << endl;
+    }
+
+    size_t n1 = 0, n2 = 0, n3 = 0, sum1 = 0, sum2 = 0;
+    startTimer();
+    for (const Tape &t: tapes)
+        if (tDfa.match(t, groups)) {
+            n1++;
+            sum1 += groups[3].end - groups[2].start; // ident and value
+        }
+    stopTimer();
+    cout << "  tagged DFA: " << elapsedTime() << " s (" << n1 << " matches)" << endl;
+    startTimer();
+    for (const Tape &t: tapes)
+        if (tNfa.match(t, groups)) {
+            n2++;
+            sum2 += groups[3].end - groups[2].start;
+        }
+    stopTimer();
+    cout << "  Pike VM:    " << elapsedTime() << " s (" << n2 << " matches, "
+         << (sum1 == sum2 ? "same" : "DIFFERENT") << " submatches)" << endl;
+    const regex stdRe(constDef);     // backtracking
+    smatch sm;
+    startTimer();
+    for (const Tape &t: tapes)
+        n3 += regex_match(t, sm, stdRe);
+    stopTimer();
+    cout << "  std::regex: " << elapsedTime() << " s (" << n3 << " matches)" << endl;
+
+    // too many states for a tagged DFA: the Submatcher falls back
+    const Submatcher big(Regex("((a|b)*)a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)"));
+    cout << "((a|b)*)a(a|b)...(a|b) (14 times): " << (big.hasDfa() ? "tagged DFA" : "Pike VM") << endl;
+}
+
+void testTransduction() {
+    cout << "32. Buffered transduction into output sinks" << endl;
+    cout << "--------------------------------------------" << endl;
+    cout << endl;
+
+    const size_t len = 8 << 20;
+    mt19937 rng(4711);
+
+    // Moore: parity of the 1s read so far
+    FABuilder mooreBuilder;
+    mooreBuilder.setStartState("E")
+            .addFinalState("E")
+            .addTransition("E", '0', "E")
+            .addTransition("E", '1', "O")
+            .addTransition("O", '0', "O")
+            .addTransition("O", '1', "E")
+            .setMooreLambda({{"E", 'e'}, {"O", 'o'}});
+    const unique_ptr<MooreDFA> moore(mooreBuilder.buildMooreDFA());
+
+    // Mealy: capitalizes the first letter of each word (on a .. d)
+    FABuilder mealyBuilder;
+    mealyBuilder.setStartState("S").addFinalState("S").addFinalState("W");
+    for (char ch = 'a'; ch <= 'd'; ch++)
+        mealyBuilder.addTransition("S", ch, "W").addTransition("W", ch, "W");
+    mealyBuilder.addTransition("S", ' ', "S").addTransition("W", ' ', "S")
+            .setMealyLambda({
+                {{"S", 'a'}, 'A'}, {{"S", 'b'}, 'B'}, {{"S", 'c'}, 'C'}, {{"S", 'd'}, 'D'},
+                {{"W", 'a'}, 'a'}, {{"W", 'b'}, 'b'}, {{"W", 'c'}, 'c'}, {{"W", 'd'}, 'd'},
+                {{"S", ' '}, ' '}, {{"W", ' '}, ' '}
+            });
+    const unique_ptr<MealyDFA> mealy(mealyBuilder.buildMealyDFA());
+
+    Tape bits(len, '0'), words(len, ' ');
+    for (char &b: bits)
+        b = (char)('0' + rng() % 2);
+    for (char &w: words)
+        if (rng() % 6 != 0)
+            w = (char)('a' + rng() % 4);
+
+    auto run = [len](const char *name, const Tape &input,
+                     const function<bool(TapeView, OutputSink &)> &transduce,
+                     const function<bool(const Tape &, ostream &)> &symbolwise) {
+        cout << name << ", " << (len >> 20) << " MB input" << endl;
+        ostringstream oss;
+        startTimer();
+        const bool a0 = symbolwise(input, oss);
+        stopTimer();
+        const double t0 = elapsedTime();
+        cout << "  symbol by symbol (maps, ostream): " << t0 << " s" << endl;
+
+        Tape out;
+        out.reserve(len);
+        StringSink stringSink(out);
+        startTimer();
+        const bool a1 = transduce(input, stringSink);
+        stopTimer();
+        cout << "  transduce to StringSink:          " << elapsedTime() << " s ("
+             << t0 / elapsedTime() << " x, " << (out == oss.str() && a1 == a0 ? "same" : "DIFFERENT")
+             << " output)" << endl;
+
+        vector<char> buffer(len);
+        BufferSink bufferSink(buffer.data(), buffer.size());
+        startTimer();
+        transduce(input, bufferSink);
+        stopTimer();
+        cout << "  transduce to BufferSink:          " << elapsedTime() << " s ("
+             << bufferSink.size() << " bytes"
+             << (bufferSink.overflowed() ? ", overflowed" : "") << ")" << endl;
+
+        const string fileName = "transduction.out";
+        startTimer();
+        {
+            FileSink fileSink(fileName);
+            transduce(input, fileSink);
+            fileSink.flush();
+        }
+        stopTimer();
+        cout << "  transduce to FileSink:            " << elapsedTime() << " s" << endl;
+        remove(fileName.c_str());
+    };
+
+    run("Moore (parity)", bits,
+        [&moore](TapeView in, OutputSink &sink) { return moore->transduce(in, sink); },
+        [&moore](const Tape &in, ostream &os) { // as the former MooreDFA::accepts
+            State s = moore->s1;
+            os << moore->lambda.at(s);
+            for (size_t i = 0; i < in.size(); i++) {
+                s = moore->delta[s][in[i]];
+                if (!defined(s))
+                    return false;
+                if (i + 1 < in.size())
+                    os << moore->lambda.at(s);
+            }
+            return moore->F.contains(s);
+        });
+    run("Mealy (capitalization)", words,
+        [&mealy](TapeView in, OutputSink &sink) { return mealy->transduce(in, sink); },
+        [&mealy](const Tape &in, ostream &os) { // as the former MealyDFA::accepts
+            State s = mealy->s1;
+            for (size_t i = 0; i < in.size(); i++) {
+                os << mealy->lambda.at(make_pair(s, in[i]));
+                s = mealy->delta[s][in[i]];
+                if (!defined(s))
+                    return false;
+            }
+            return mealy->F.contains(s);
+        });
+}
+
 int main(int argc, char *argv[]) {
     installSignalHandlers();
 
@@ -492,6 +2080,78 @@ int main(int argc, char *argv[]) {
         /*testDfaOf();
         cout << endl;*/
 
+        /*testProfiling();
+        cout << endl;*/
+
+        /*testRenumbering();
+        cout << endl;*/
+
+        /*testParser();
+        cout << endl;*/
+
+        /*testImages();
+        cout << endl;*/
+
+        /*testCache();
+        cout << endl;*/
+
+        /*testFingerprint();
+        cout << endl;*/
+
+        /*testEquivalence();
+        cout << endl;*/
+
+        /*testLazyProducts();
+        cout << endl;*/
+
+        /*testEpsFree();
+        cout << endl;*/
+
+        /*testReduction();
+        cout << endl;*/
+
+        /*testRegex();
+        cout << endl;*/
+
+        /*testFragments();
+        cout << endl;*/
+
+        /*testRanges();
+        cout << endl;*/
+
+        /*testBinaryTapes();
+        cout << endl;*/
+
+        /*testUtf8();
+        cout << endl;*/
+
+        /*testShuffle();
+        cout << endl;*/
+
+        /*testAcceleration();
+        cout << endl;*/
+
+        /*testPrefilter();
+        cout << endl;*/
+
+        /*testAhoCorasick();
+        cout << endl;*/
+
+        /*testDawg();
+        cout << endl;*/
+
+        /*testLevenshtein();
+        cout << endl;*/
+
+        /*testSearch();
+        cout << endl;*/
+
+        /*testSubmatches();
+        cout << endl;*/
+
+        /*testTransduction();
+        cout << endl;*/
+
         testNFAFromGrammar();
         cout << endl;
     } catch (const exception &e) {
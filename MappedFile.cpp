@@ -0,0 +1,67 @@
+// MappedFile.cpp:                                                 2024
+// --------------
+// MappedFile provides the read-only contents of a whole file as one
+// contiguous buffer.
+//======================================================================
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if (defined(__unix__) || defined(__APPLE__))
+  #define USE_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+using namespace std;
+
+#include "MappedFile.h"
+
+
+MappedFile::MappedFile(const string &fileName) {
+#ifdef USE_MMAP
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw invalid_argument("file \"" + fileName + "\" not found");
+  struct stat st;
+  bool statOk = (fstat(fd, &st) == 0);
+  if (statOk && st.st_size > 0) {
+    void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+      addr   = (const char *)p;
+      len    = (size_t)st.st_size;
+      mapped = true;
+    } // if
+  } // if
+  close(fd); // the mapping stays valid
+  if (mapped)
+    return;
+  if (statOk && st.st_size == 0 && S_ISREG(st.st_mode)) {
+    addr = buffer.data(); // empty file, so empty buffer
+    return;
+  } // if
+  // mmap failed (e.g., for special files), so read the file
+#endif
+  ifstream ifs(fileName, ios::binary);
+  if (!ifs.good())
+    throw invalid_argument("file \"" + fileName + "\" not found");
+  buffer.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+  addr = buffer.data();
+  len  = buffer.size();
+} // MappedFile::MappedFile
+
+
+MappedFile::~MappedFile() {
+#ifdef USE_MMAP
+  if (mapped)
+    munmap((void *)addr, len);
+#endif
+} // MappedFile::~MappedFile
+
+
+// end of MappedFile.cpp
+//======================================================================
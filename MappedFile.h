@@ -0,0 +1,47 @@
+// MappedFile.h:                                                   2024
+// ------------
+// MappedFile provides the read-only contents of a whole file as one
+// contiguous buffer: mapped into memory via mmap on POSIX systems,
+// read into a buffer on all other systems.
+//======================================================================
+
+#pragma once
+#ifndef MappedFile_h
+#define MappedFile_h
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "ObjectCounter.h"
+
+
+class MappedFile final
+        /*OC+*/ : private ObjectCounter<MappedFile> /*+OC*/ {
+
+    const char *addr = nullptr; // start of contents
+    std::size_t len  = 0;       // length of contents in bytes
+    bool        mapped = false; // mapped via mmap or ...
+    std::string buffer;         // ... read into this buffer
+
+  public:
+
+    explicit MappedFile(const std::string &fileName); // throws if not found
+
+    MappedFile(const MappedFile  &mf) = delete;
+    MappedFile(      MappedFile &&mf) = delete;
+
+    ~MappedFile();
+
+    const char *data() const { return addr; }
+    std::size_t size() const { return len;  }
+
+    std::string_view contents() const { return std::string_view(addr, len); }
+
+}; // MappedFile
+
+
+#endif
+
+// end of MappedFile.h
+//======================================================================
@@ -1,44 +1,82 @@
 
+#include <cstdint>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
 #include "MealyDFA.h"
+#include "CompiledDFA.h"
+#include "OutputSink.h"
 #include "FABuilder.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
 #include "MbMatrix.h"
 
 
-MealyDFA::MealyDFA(const StateSet &S, const TapeSymbolSet &V,
-         const State &s1, const StateSet &F,
-         const DDelta &delta,
-         const map<pair<State, TapeSymbol>, char> &mealyLambda)
-    : DFA(S, V, s1, F, delta), lambda(mealyLambda) {
-}
+// delta as CompiledDFA, lambda per state id and byte (-1 for no output)
+struct MealyDFA::Tables {
 
-bool MealyDFA::accepts(const Tape &tape) const {
-    int i = 0;
-    TapeSymbol tSy = tape[i];
-    State s = s1;
+    CompiledDFA     cDfa;
+    vector<int16_t> out;
 
-    std::cout << lambda.at(make_pair(s, tSy));
+    Tables(const DFA &dfa, const map<pair<State, TapeSymbol>, char> &lambda)
+        : cDfa(dfa), out((size_t)cDfa.nrOfStates() * 256, -1) {
+        for (const auto &entry: lambda) {
+            CompiledDFA::StateId s = cDfa.idOf(entry.first.first);
+            if (s != CompiledDFA::undef)
+                out[(size_t)s * 256 + (unsigned char)entry.first.second] =
+                    (unsigned char)entry.second;
+        }
+    }
 
-    while (tSy != eot) {
-        s = delta[s][tSy];
+};
 
-        if (!defined(s)) {
-            return false;
-        }
+MealyDFA::MealyDFA(StateSet S, TapeSymbolSet V,
+         State s1, StateSet F,
+         DDelta delta,
+         map<pair<State, TapeSymbol>, char> mealyLambda)
+    : DFA(std::move(S), std::move(V), std::move(s1), std::move(F), std::move(delta)),
+      lambdaPtr(make_shared<const map<pair<State, TapeSymbol>, char>>(
+                  std::move(mealyLambda))),
+      tables(make_shared<const Tables>(*this, *lambdaPtr)),
+      lambda(*lambdaPtr) {
+}
 
-        i++;
-        tSy = tape[i];
+bool MealyDFA::transduce(TapeView input, OutputSink &sink) const {
+    const CompiledDFA &cDfa = tables->cDfa;
+    const int16_t *out = tables->out.data();
+    char chunk[4096]; // output collected here, one sink.write per chunk
+    size_t n = 0;
 
-        if (tSy != eot) {
-            std::cout << lambda.at(make_pair(s, tSy));
+    CompiledDFA::StateId s = cDfa.startState();
+    for (size_t i = 0; i < input.size(); i++) {
+        const int16_t o = out[(size_t)s * 256 + (unsigned char)input[i]];
+        if (o < 0) {
+            sink.write(chunk, n);
+            throw out_of_range("MealyDFA: no output for state " + cDfa.nameOf(s) +
+                               " and symbol " + input[i]);
+        }
+        if (n == sizeof(chunk)) {
+            sink.write(chunk, n);
+            n = 0;
+        }
+        chunk[n++] = (char)o;
+        s = cDfa.next(s, input[i]);
+        if (s == CompiledDFA::undef) {
+            sink.write(chunk, n);
+            return false;
         }
     }
+    sink.write(chunk, n);
+    return cDfa.isFinal(s);
+}
 
-    return F.contains(s);
+bool MealyDFA::accepts(const Tape &tape) const {
+    StreamSink sink(cout);
+    return transduce(TapeView(tape).substr(0, tape.find(eot)), sink);
 }
@@ -4,7 +4,13 @@
 
 #ifndef MEALYDFA_H
 #define MEALYDFA_H
+#include <map>
+#include <memory>
+#include <utility>
+
 #include "DFA.h"
+#include "OutputSink.h"
+#include "TapeStuff.h"
 
 class FABuilder;
 
@@ -16,16 +22,28 @@ class MealyDFA final : public DFA, private ObjectCounter<MealyDFA> {
 
 protected:
 
-    MealyDFA(const StateSet &S, const TapeSymbolSet &V,
-             const State &s1, const StateSet &F,
-             const DDelta &delta,
-             const std::map<std::pair<State, TapeSymbol>, char> &lambda);
+    MealyDFA(StateSet S, TapeSymbolSet V,
+             State s1, StateSet F,
+             DDelta delta,
+             std::map<std::pair<State, TapeSymbol>, char> lambda);
+
+private:
+
+    std::shared_ptr<const std::map<std::pair<State, TapeSymbol>, char>> lambdaPtr; // shared by copies
+
+    struct Tables;                         // compiled delta and lambda
+    std::shared_ptr<const Tables> tables;  // shared by copies
 
 public:
 
-    const std::map<std::pair<State, TapeSymbol>, char> lambda;   // lambda function for output
+    const std::map<std::pair<State, TapeSymbol>, char> &lambda;   // lambda function for output
 
     bool accepts(const Tape &tape) const override; // override DFA::accepts
+
+    // output of lambda for each state and symbol read to sink (on the
+    //   compiled table, in chunks), result as for accepts; throws
+    //   out_of_range for missing outputs (after the output up to them)
+    bool transduce(TapeView input, OutputSink &sink) const;
 };
 
 
@@ -4,12 +4,19 @@
 // for transformation purposes as defined by Edward F. Moore.
 //======================================================================
 
+#include <cstdint>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
 #include "MooreDFA.h"
+#include "CompiledDFA.h"
+#include "OutputSink.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
 #include "MbMatrix.h"
@@ -18,37 +25,68 @@ using namespace std;
 
 // --- implementation of class MooreDFA ---
 
-MooreDFA::MooreDFA(const StateSet &S, const TapeSymbolSet &V,
-                   const State &s1, const StateSet &F,
-                   const DDelta &delta,
-                   const map<State, char> &lambda)
-    : DFA(S, V, s1, F, delta), lambda(lambda) {
-}
-
-bool MooreDFA::accepts(const Tape &tape) const {
-    int i = 0; // Index des ersten Symbols
-    TapeSymbol tSy = tape[i]; // Erstes Tape-Symbol
-    State s = s1; // Startzustand
+// delta as CompiledDFA, lambda per state id (-1 for no output)
+struct MooreDFA::Tables {
 
-    // Ausgabe des Startzustands (vor Verarbeitung der Eingabe)
-    std::cout << lambda.at(s);
+    CompiledDFA     cDfa;
+    vector<int16_t> out;
 
-    while (tSy != eot) { // Solange das Ende des Bands nicht erreicht ist
-        s = delta[s][tSy]; // Übergang zum nächsten Zustand
-        if (!defined(s)) {
-            return false; // Ungültiger Zustand
+    Tables(const DFA &dfa, const map<State, char> &lambda)
+        : cDfa(dfa), out(cDfa.nrOfStates(), -1) {
+        for (CompiledDFA::StateId s = 0; s < cDfa.nrOfStates(); s++) {
+            auto it = lambda.find(cDfa.nameOf(s));
+            if (it != lambda.end())
+                out[s] = (unsigned char)it->second;
         }
+    }
+
+};
+
+MooreDFA::MooreDFA(StateSet S, TapeSymbolSet V,
+                   State s1, StateSet F,
+                   DDelta delta,
+                   map<State, char> lambda)
+    : DFA(std::move(S), std::move(V), std::move(s1), std::move(F), std::move(delta)),
+      lambdaPtr(make_shared<const map<State, char>>(std::move(lambda))),
+      tables(make_shared<const Tables>(*this, *lambdaPtr)), lambda(*lambdaPtr) {
+}
+
+bool MooreDFA::transduce(TapeView input, OutputSink &sink) const {
+    const CompiledDFA &cDfa = tables->cDfa;
+    const int16_t *out = tables->out.data();
+    char chunk[4096]; // output collected here, one sink.write per chunk
+    size_t n = 0;
 
-        i++;
-        tSy = tape[i]; // Nächstes Symbol vom Band
+    auto put = [&](CompiledDFA::StateId s) {
+        if (out[s] < 0) {
+            sink.write(chunk, n);
+            throw out_of_range("MooreDFA: no output for state " + cDfa.nameOf(s));
+        }
+        if (n == sizeof(chunk)) {
+            sink.write(chunk, n);
+            n = 0;
+        }
+        chunk[n++] = (char)out[s];
+    };
 
-        // Ausgabe des Zustands NACH dem Wechsel, ABER VOR dem Lesen des nächsten Symbols
-        if (tSy != eot) {
-            std::cout << lambda.at(s);
+    CompiledDFA::StateId s = cDfa.startState();
+    put(s);
+    for (size_t i = 0; i < input.size(); i++) {
+        s = cDfa.next(s, input[i]);
+        if (s == CompiledDFA::undef) {
+            sink.write(chunk, n);
+            return false;
         }
+        if (i + 1 < input.size()) // no output for the last state entered
+            put(s);
     }
+    sink.write(chunk, n);
+    return cDfa.isFinal(s);
+}
 
-    return F.contains(s); // Akzeptieren, wenn Zustand final ist
+bool MooreDFA::accepts(const Tape &tape) const {
+    StreamSink sink(cout);
+    return transduce(TapeView(tape).substr(0, tape.find(eot)), sink);
 }
 
 void MooreDFA::onStateEntered(const State &s) const {
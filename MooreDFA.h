@@ -2,14 +2,19 @@
 // ----------
 // Objects of class MooreDFA represent deterministic finite automata
 // for transformation purposes as defined by Edward F. Moore.
+// transduce runs on a compiled table (CompiledDFA and lambda per state
+// id) and hands its output to an OutputSink in chunks, accepts writes
+// the output to cout that way.
 //======================================================================
 
 #ifndef MooreDFA_h
 #define MooreDFA_h
 
 #include <map>
+#include <memory>
 
 #include "ObjectCounter.h"
+#include "OutputSink.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
 #include "DFA.h"
@@ -26,17 +31,29 @@ class MooreDFA final : public DFA, private ObjectCounter<MooreDFA> {
   protected:
 
     // constructor called by FABuilder::buildMooreDFA method only
-    MooreDFA(const StateSet &S,  const TapeSymbolSet &V,
-             const State    &s1, const StateSet      &F,
-             const DDelta   &delta,
-             const std::map<State, char> &lambda);
+    MooreDFA(StateSet S,  TapeSymbolSet V,
+             State    s1, StateSet      F,
+             DDelta   delta,
+             std::map<State, char> lambda);
+
+  private:
+
+    std::shared_ptr<const std::map<State, char>> lambdaPtr; // shared by copies
+
+    struct Tables;                         // compiled delta and lambda
+    std::shared_ptr<const Tables> tables;  // shared by copies
 
   public:
 
-    const std::map<State, char> lambda;    // lambda function for output
+    const std::map<State, char> &lambda;   // lambda function for output
 
     bool accepts(const Tape &tape) const override; // override DFA::accepts
 
+    // output of lambda for the start state and all states entered but
+    //   the last one to sink, result as for accepts; throws out_of_range
+    //   for states without output (after the output up to them)
+    bool transduce(TapeView input, OutputSink &sink) const;
+
     void onStateEntered(const State &s) const override;
 
 };
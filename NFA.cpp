@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
@@ -21,11 +22,113 @@ using namespace std;
 #include "DFA.h"
 #include "NFA.h"
 #include "FABuilder.h"
+#include "FAProfile.h"
+#include "CompiledNFA.h"
 
-NFA::NFA(const StateSet &S, const TapeSymbolSet &V,
-         const State &s1, const StateSet &F,
+NFA::NFA(StateSet S, TapeSymbolSet V,
+         State s1, StateSet F,
          NDelta delta)
-    : FA(S, V, s1, F), delta(std::move(delta)) {
+    : FA(std::move(S), std::move(V), std::move(s1), std::move(F)),
+      deltaPtr(make_shared<const NDelta>(std::move(delta))),
+      epsClosures(make_shared<EpsClosures>()), delta(*deltaPtr) {
+}
+
+
+// NFA::EpsClosures: epsilon closures of all states, computed once
+//------------------
+struct NFA::EpsClosures {
+    once_flag once;
+    bool anyEps = false;
+    vector<State> names; // id -> name, in order of S, so sorted
+    vector<int> sccOf; // id -> strongly conn. comp. of epsilon graph
+    vector<vector<int>> closureOf; // SCC -> sorted ids of its closure
+
+    int idOf(const State &s) const { // -1 for unknown names
+        auto it = lower_bound(names.begin(), names.end(), s);
+        return (it == names.end() || *it != s) ? -1 : (int) (it - names.begin());
+    }
+};
+
+// Tarjan's algorithm (iterative, so deep epsilon chains are no problem),
+//   SCCs are numbered in the order of completion, so all successors of
+//   an SCC have smaller numbers (reverse topological order)
+static vector<int> sccsOf(const vector<vector<int>> &succ, int &nSccs) {
+    const int n = (int) succ.size();
+    vector<int> index(n, -1), low(n, 0), scc(n, -1), stack;
+    vector<pair<int, size_t>> callStack; // (node, next successor)
+    int nextIndex = 0;
+    nSccs = 0;
+    for (int root = 0; root < n; root++) {
+        if (index[root] >= 0)
+            continue;
+        callStack.emplace_back(root, 0);
+        index[root] = low[root] = nextIndex++;
+        stack.push_back(root);
+        while (!callStack.empty()) {
+            auto &[v, i] = callStack.back();
+            if (i < succ[v].size()) {
+                const int w = succ[v][i++];
+                if (index[w] < 0) { // "recursive call" for w
+                    index[w] = low[w] = nextIndex++;
+                    stack.push_back(w);
+                    callStack.emplace_back(w, 0);
+                } else if (scc[w] < 0) // w on stack
+                    low[v] = min(low[v], index[w]);
+            } else { // all successors of v done
+                const int u = v;
+                if (low[u] == index[u]) { // u is root of an SCC
+                    int w;
+                    do {
+                        w = stack.back();
+                        stack.pop_back();
+                        scc[w] = nSccs;
+                    } while (w != u);
+                    nSccs++;
+                }
+                callStack.pop_back();
+                if (!callStack.empty()) {
+                    const int p = callStack.back().first;
+                    low[p] = min(low[p], low[u]);
+                }
+            }
+        }
+    }
+    return scc;
+}
+
+const NFA::EpsClosures &NFA::closures() const {
+    EpsClosures &ec = *epsClosures;
+    call_once(ec.once, [&]() {
+        ec.names.assign(S.begin(), S.end());
+        const int n = (int) ec.names.size();
+        vector<vector<int>> succ(n); // epsilon graph
+        for (int id = 0; id < n; id++)
+            for (const State &dest: delta[ec.names[id]][eps]) {
+                const int d = ec.idOf(dest);
+                if (d >= 0)
+                    succ[id].push_back(d);
+            }
+        int nSccs = 0;
+        ec.sccOf = sccsOf(succ, nSccs);
+        ec.anyEps = nSccs < n || any_of(succ.begin(), succ.end(),
+                                        [](const vector<int> &v) { return !v.empty(); });
+        ec.closureOf.assign(nSccs, vector<int>());
+        vector<vector<int>> members(nSccs);
+        for (int id = 0; id < n; id++)
+            members[ec.sccOf[id]].push_back(id);
+        for (int c = 0; c < nSccs; c++) { // successors are done already
+            vector<int> &cl = ec.closureOf[c];
+            cl = members[c];
+            for (int id: members[c])
+                for (int d: succ[id])
+                    if (ec.sccOf[d] != c)
+                        cl.insert(cl.end(), ec.closureOf[ec.sccOf[d]].begin(),
+                                  ec.closureOf[ec.sccOf[d]].end());
+            sort(cl.begin(), cl.end());
+            cl.erase(unique(cl.begin(), cl.end()), cl.end());
+        }
+    });
+    return ec;
 }
 
 StateSet NFA::deltaAt(const State &src, const TapeSymbol tSy) const {
@@ -115,6 +218,68 @@ bool NFA::accepts3(const Tape &tape) const {
     return !empty(ss ^ F); // accepted <==> (ss ^ F) != {}
 }
 
+// NFA::accepts with profiling: accepts3 counting visits and firings
+//-------------
+bool NFA::accepts(const Tape &tape, FAProfiler &profiler) const {
+    FAProfiler::Counters &cnt = profiler.localCounters(); // no contention
+    cnt.runStarted();
+    const int epsCol = profiler.colOf(eps);
+
+    // sets of rows instead of state names, member marks per row
+    vector<bool> inSet(S.size(), false);
+    vector<int> ss, dest;
+
+    // epsilon closure of rows in place, counts each epsilon transition fired
+    auto profiledEpsClosureOf = [&](vector<int> &rows) {
+        for (size_t k = 0; k < rows.size(); k++) { // rows grows
+            const auto dr = profiler.destRowsOf(rows[k], epsCol);
+            if (dr.first != dr.second)
+                cnt.transitionFired(rows[k], epsCol);
+            for (const int *d = dr.first; d != dr.second; d++)
+                if (!inSet[*d]) {
+                    inSet[*d] = true;
+                    rows.push_back(*d);
+                }
+        }
+        for (int r: rows) {
+            cnt.stateEntered(r);
+            inSet[r] = false;
+        }
+    };
+
+    int i = 0;
+    TapeSymbol tSy = tape[i];
+    ss.push_back(profiler.startRowOf());
+    inSet[ss[0]] = true;
+    profiledEpsClosureOf(ss);
+    while (tSy != eot) {
+        const int col = profiler.colOf(tSy);
+        if (col < 0)
+            return false;
+        dest.clear();
+        for (int r: ss) {
+            const auto dr = profiler.destRowsOf(r, col);
+            if (dr.first != dr.second)
+                cnt.transitionFired(r, col);
+            for (const int *d = dr.first; d != dr.second; d++)
+                if (!inSet[*d]) {
+                    inSet[*d] = true;
+                    dest.push_back(*d);
+                }
+        }
+        if (dest.empty())
+            return false;
+        profiledEpsClosureOf(dest);
+        swap(ss, dest);
+        i++;
+        tSy = tape[i];
+    }
+    for (int r: ss)
+        if (profiler.isFinalRow(r))
+            return true;
+    return false;
+}
+
 // NFA::epsilonClosureOf (cf. Aho/Sethi/Ullman, p. 119):
 //----------------------
 StateSet NFA::epsClosureOf(const State &src) const {
@@ -122,18 +287,25 @@ StateSet NFA::epsClosureOf(const State &src) const {
 }
 
 StateSet NFA::epsClosureOf(const StateSet &src) const {
-    StateSet ec = src;
-    StateSet stc = src;
-    while (!stc.empty()) {
-        State s = stc.anyElement();
-        stc.erase(s);
-        for (const State &dest: delta[s][eps]) {
-            const auto ir = ec.insert(dest);
-            if (ir.second) // new state dest was inserted
-                stc.insert(dest);
-        } // for
-    } // while
-    return ec;
+    const EpsClosures &ec = closures(); // precomputed, no worklist
+    if (!ec.anyEps)
+        return src;
+    StateSet result;
+    vector<int> ids;
+    for (const State &s: src) {
+        const int id = ec.idOf(s);
+        if (id < 0)
+            result.insert(s); // unknown state, closure is {s}
+        else {
+            const vector<int> &cl = ec.closureOf[ec.sccOf[id]];
+            ids.insert(ids.end(), cl.begin(), cl.end());
+        }
+    } // for
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    for (int id: ids) // in order, so each insertion in O(1)
+        result.emplace_hint(result.end(), ec.names[id]);
+    return result;
 } // NFA::epsClosureOf
 
 
@@ -184,7 +356,66 @@ DFA *NFA::dfaOf() const {
             if (stateSet.contains(f))
                 fab.addFinalState(stateSet.stateOf());
 
-    return fab.buildDFA();
+    return std::move(fab).buildDFA();
+}
+
+// NFA::epsFreeOf: epsilon removal over the precomputed closures
+//---------------
+NFA *NFA::epsFreeOf() const {
+    const EpsClosures &ec = closures();
+    // name of an SCC: name of its first (smallest) state
+    vector<int> repOf(ec.closureOf.size(), -1);
+    for (int id = (int) ec.names.size() - 1; id >= 0; id--)
+        repOf[ec.sccOf[id]] = id;
+
+    FABuilder fab;
+    const int startScc = ec.sccOf[ec.idOf(s1)];
+    const State &start = ec.names[repOf[startScc]];
+    fab.setStartState(start);
+    bool anyTransition = false, startFinal = false;
+    vector<bool> visited(ec.closureOf.size(), false);
+    vector<int> queue{startScc}; // reachable SCCs only
+    visited[startScc] = true;
+    for (size_t i = 0; i < queue.size(); i++) {
+        const int c = queue[i];
+        const State &src = ec.names[repOf[c]];
+        for (int id: ec.closureOf[c]) {
+            const State &q = ec.names[id];
+            if (F.contains(q)) {
+                fab.addFinalState(src);
+                startFinal |= c == startScc;
+            }
+            for (const auto &e: delta[q]) { // all (tSy, destSet) of q
+                if (e.first == eps)
+                    continue;
+                for (const State &dest: e.second) {
+                    const int dc = ec.sccOf[ec.idOf(dest)];
+                    fab.addTransition(src, e.first, ec.names[repOf[dc]]);
+                    anyTransition = true;
+                    if (!visited[dc]) {
+                        visited[dc] = true;
+                        queue.push_back(dc);
+                    }
+                }
+            }
+        }
+    }
+    if (!anyTransition) // language {eps}, FABuilder rejects an empty delta
+        return new NFA(StateSet(start), TapeSymbolSet(), start,
+                       startFinal ? StateSet(start) : StateSet(), NDelta());
+    return std::move(fab).buildNFA();
+}
+
+size_t NFA::nrOfEpsSCCs() const {
+    return closures().closureOf.size();
+}
+
+void NFA::save(const std::string &fileName, bool names) const {
+    CompiledNFA(*this, names).save(fileName);
+}
+
+NFA *NFA::load(const std::string &fileName) {
+    return CompiledNFA::load(fileName).nfaOf();
 }
 
 // end of NFA.cpp
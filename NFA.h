@@ -7,6 +7,9 @@
 #ifndef NFA_h
 #define NFA_h
 
+#include <cstddef>
+#include <memory>
+
 #include "ObjectCounter.h"
 #include "TapeStuff.h"
 #include "StateStuff.h"
@@ -15,6 +18,7 @@
 
 class FABuilder; // forward for friend declaration only
 class DFA; // forward for transformation NFA -> DFA
+class FAProfiler; // forward for profiling of accepts only
 
 class NFA final : public FA, private ObjectCounter<NFA> {
     friend class FABuilder; // so ::build.. methods can call prot. constr.
@@ -22,16 +26,22 @@ class NFA final : public FA, private ObjectCounter<NFA> {
     using Base = FA;
 
     // constructor called by FABuilder::build... methods only
-    NFA(const StateSet &S, const TapeSymbolSet &V,
-        const State &s1, const StateSet &F,
+    NFA(StateSet S, TapeSymbolSet V,
+        State s1, StateSet F,
         NDelta delta);
 
     StateSet deltaAt(const State &src, TapeSymbol tSy) const override;
 
     bool accepts2(const State &s, const Tape &tape, int i) const; // uses backtracking
 
+    std::shared_ptr<const NDelta> deltaPtr; // shared by all copies
+
+    struct EpsClosures; // computed once on demand, shared by all copies
+    std::shared_ptr<EpsClosures> epsClosures;
+    const EpsClosures &closures() const;
+
 public:
-    const NDelta delta; // non-deterministic transition function
+    const NDelta &delta; // non-deterministic transition function
 
     NFA(const NFA &nfa) = default;
 
@@ -48,13 +58,27 @@ public:
 
     bool accepts3(const Tape &tape) const; // uses tracing of StateSets
 
+    bool accepts(const Tape &tape, FAProfiler &profiler) const;
+    // opt-in profiling, traces StateSets as accepts3 does
+
     StateSet epsClosureOf(const State &src) const;
 
     StateSet epsClosureOf(const StateSet &srcSet) const;
+    // both use the precomputed closures, see closures()
+
+    NFA *epsFreeOf() const; // equiv. NFA without epsilon transitions:
+    // states of epsilon cycles are merged (Tarjan's SCCs), transitions
+    // are rewired over the closures and unreachable states are dropped,
+    // for the language {eps} a single final start state without delta
+
+    std::size_t nrOfEpsSCCs() const; // states left after merging epsilon cycles
 
     StateSet allDestsFor(const StateSet &srcSet, TapeSymbol tSy) const;
 
     DFA *dfaOf() const; // transformation: NFA => DFA
+
+    void save(const std::string &fileName, bool names = true) const; // binary image
+    static NFA *load(const std::string &fileName); // in compiled form: CompiledNFA::load
 };
 
 
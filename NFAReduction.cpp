@@ -0,0 +1,327 @@
+// NFAReduction.cpp:                                               2024
+// ----------------
+// Language preserving reduction of NFAs before determinization.
+//======================================================================
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "NFA.h"
+#include "FABuilder.h"
+#include "NFAReduction.h"
+
+
+ostream &operator<<(ostream &os, const NFAReductionReport &r) {
+  os << "states: "      << r.statesBefore      << " -> " << r.statesAfter
+     << ", transitions: " << r.transitionsBefore << " -> " << r.transitionsAfter
+     << " (eps. cycles: " << r.epsCycleMerged
+     << ", trimmed: "   << r.trimmedStates
+     << ", forward bisim.: "  << r.forwardMerged
+     << ", backward bisim.: " << r.backwardMerged;
+  if (r.simulationSkipped)
+    os << ", simulation skipped";
+  else
+    os << ", simulation: " << r.simulationMerged
+       << ", pruned transitions: " << r.prunedTransitions;
+  return os << ")";
+} // operator<<
+
+
+namespace {
+
+  typedef pair<TapeSymbol, int> Edge; // (symbol, destination)
+
+  // epsilon-free NFA on integer states
+  struct IntNFA {
+    vector<State> names;            // id -> name
+    int start = 0;
+    vector<bool> final;
+    vector<vector<Edge>> out;       // sorted, without duplicates
+
+    int nrOfStates() const { return (int)names.size(); }
+    size_t nrOfTransitions() const {
+      size_t n = 0;
+      for (const auto &o: out)
+        n += o.size();
+      return n;
+    } // nrOfTransitions
+    vector<vector<Edge>> in() const { // reverse edges
+      vector<vector<Edge>> rev(names.size());
+      for (int p = 0; p < nrOfStates(); p++)
+        for (const Edge &e: out[p])
+          rev[e.second].emplace_back(e.first, p);
+      return rev;
+    } // in
+  }; // IntNFA
+
+  IntNFA intNFAOf(const NFA &nfa) {   // requires: nfa is epsilon-free
+    IntNFA a;
+    a.names.assign(nfa.S.begin(), nfa.S.end());
+    auto idOf = [&](const State &s) {
+      return (int)(lower_bound(a.names.begin(), a.names.end(), s) - a.names.begin());
+    }; // idOf
+    a.start = idOf(nfa.s1);
+    a.final.assign(a.names.size(), false);
+    for (const State &f: nfa.F)
+      a.final[idOf(f)] = true;
+    a.out.resize(a.names.size());
+    for (const auto &row: nfa.delta) {
+      const int p = idOf(row.first);
+      for (const auto &e: row.second)
+        for (const State &d: e.second)
+          a.out[p].emplace_back(e.first, idOf(d)); // sorted by construction
+    } // for
+    return a;
+  } // intNFAOf
+
+  // states are the blocks, each named after its smallest state
+  IntNFA quotientOf(const IntNFA &a, const vector<int> &blockOf, int nBlocks) {
+    IntNFA q;
+    q.names.assign(nBlocks, State());
+    vector<bool> named(nBlocks, false);
+    q.final.assign(nBlocks, false);
+    q.out.resize(nBlocks);
+    for (int p = 0; p < a.nrOfStates(); p++) {
+      const int b = blockOf[p];
+      if (b < 0)
+        continue;            // trimmed state
+      if (!named[b] || a.names[p] < q.names[b]) {
+        q.names[b] = a.names[p];
+        named[b] = true;
+      } // if
+      if (a.final[p])
+        q.final[b] = true;
+      for (const Edge &e: a.out[p])
+        if (blockOf[e.second] >= 0)
+          q.out[b].emplace_back(e.first, blockOf[e.second]);
+    } // for
+    for (auto &o: q.out) {
+      sort(o.begin(), o.end());
+      o.erase(unique(o.begin(), o.end()), o.end());
+    } // for
+    q.start = blockOf[a.start];
+    return q;
+  } // quotientOf
+
+  // removes states that are unreachable or cannot reach a final state,
+  //   false if the language is empty (then a is left unchanged)
+  bool trim(IntNFA &a, size_t &nTrimmed) {
+    const int n = a.nrOfStates();
+    auto markFrom = [n](const vector<int> &starts, const vector<vector<Edge>> &adj) {
+      vector<bool> mark(n, false);
+      vector<int> stack(starts);
+      for (int s: starts)
+        mark[s] = true;
+      while (!stack.empty()) {
+        const int p = stack.back();
+        stack.pop_back();
+        for (const Edge &e: adj[p])
+          if (!mark[e.second]) {
+            mark[e.second] = true;
+            stack.push_back(e.second);
+          } // if
+      } // while
+      return mark;
+    }; // markFrom
+    vector<int> finals;
+    for (int p = 0; p < n; p++)
+      if (a.final[p])
+        finals.push_back(p);
+    const vector<bool> reachable = markFrom({a.start}, a.out);
+    const vector<bool> useful    = markFrom(finals, a.in());
+    if (!useful[a.start])
+      return false;
+    vector<int> blockOf(n, -1);
+    int nBlocks = 0;
+    for (int p = 0; p < n; p++)
+      if (reachable[p] && useful[p])
+        blockOf[p] = nBlocks++;
+    if (nBlocks < n) {
+      nTrimmed += n - nBlocks;
+      a = quotientOf(a, blockOf, nBlocks);
+    } // if
+    return true;
+  } // trim
+
+  // partition refinement on signatures: forward (successors, finality)
+  //   or backward (predecessors, being the start state)
+  int bisimulationBlocksOf(const IntNFA &a, bool backward, vector<int> &blockOf) {
+    const int n = a.nrOfStates();
+    const vector<vector<Edge>> adj = backward ? a.in() : a.out;
+    blockOf.assign(n, 0);
+    for (int p = 0; p < n; p++)
+      blockOf[p] = backward ? (p == a.start) : (int)a.final[p];
+    int nBlocks = -1;
+    for (;;) {
+      map<pair<int, vector<Edge>>, int> idOfSignature;
+      vector<int> newBlockOf(n);
+      for (int p = 0; p < n; p++) {
+        vector<Edge> sig;
+        sig.reserve(adj[p].size());
+        for (const Edge &e: adj[p])
+          sig.emplace_back(e.first, blockOf[e.second]);
+        sort(sig.begin(), sig.end());
+        sig.erase(unique(sig.begin(), sig.end()), sig.end());
+        auto ir = idOfSignature.emplace(make_pair(blockOf[p], std::move(sig)),
+                                        (int)idOfSignature.size());
+        newBlockOf[p] = ir.first->second;
+      } // for
+      const int newNBlocks = (int)idOfSignature.size();
+      blockOf.swap(newBlockOf);
+      if (newNBlocks == nBlocks)
+        return nBlocks;      // stable, refinement only splits blocks
+      nBlocks = newNBlocks;
+    } // for
+  } // bisimulationBlocksOf
+
+  // sim[p * n + q]: q simulates p (naive fixpoint, for small NFAs only)
+  vector<bool> simulationOf(const IntNFA &a) {
+    const int n = a.nrOfStates();
+    vector<bool> sim((size_t)n * n, true);
+    for (int p = 0; p < n; p++)
+      for (int q = 0; q < n; q++)
+        if (a.final[p] && !a.final[q])
+          sim[(size_t)p * n + q] = false;
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (int p = 0; p < n; p++)
+        for (int q = 0; q < n; q++) {
+          if (p == q || !sim[(size_t)p * n + q])
+            continue;
+          for (const Edge &ep: a.out[p]) { // q must match each move of p
+            auto first = lower_bound(a.out[q].begin(), a.out[q].end(), Edge(ep.first, -1));
+            bool matched = false;
+            for (auto it = first; it != a.out[q].end() && it->first == ep.first; ++it)
+              if (sim[(size_t)ep.second * n + it->second]) {
+                matched = true;
+                break;
+              } // if
+            if (!matched) {
+              sim[(size_t)p * n + q] = false;
+              changed = true;
+              break;
+            } // if
+          } // for
+        } // for
+    } // while
+    return sim;
+  } // simulationOf
+
+  // removes p -a-> r1 if p -a-> r2 with r1 < r2 (r2 simulates r1),
+  //   for mutually similar r1, r2 the one with the larger id is removed
+  size_t pruneLittleBrothers(IntNFA &a, const vector<bool> &sim) {
+    const int n = a.nrOfStates();
+    auto le = [&](int x, int y) { return (bool)sim[(size_t)x * n + y]; };
+    size_t nPruned = 0;
+    for (auto &o: a.out) {
+      vector<Edge> kept;
+      for (size_t i = 0; i < o.size(); i++) {
+        bool little = false;
+        for (size_t j = 0; j < o.size() && !little; j++)
+          little = j != i && o[j].first == o[i].first &&
+                   le(o[i].second, o[j].second) &&
+                   (!le(o[j].second, o[i].second) || o[j].second < o[i].second);
+        if (little)
+          nPruned++;
+        else
+          kept.push_back(o[i]);
+      } // for
+      o.swap(kept);
+    } // for
+    return nPruned;
+  } // pruneLittleBrothers
+
+  NFA *nfaOf(const IntNFA &a) {
+    FABuilder fab;
+    fab.setStartState(a.names[a.start]);
+    for (int p = 0; p < a.nrOfStates(); p++) {
+      if (a.final[p])
+        fab.addFinalState(a.names[p]);
+      for (const Edge &e: a.out[p])
+        fab.addTransition(a.names[p], e.first, a.names[e.second]);
+    } // for
+    return std::move(fab).buildNFA();
+  } // nfaOf
+
+} // namespace
+
+
+NFA *reducedOf(const NFA &nfa, bool useSimulation, NFAReductionReport *report) {
+  NFAReductionReport r;
+  r.statesBefore = nfa.S.size();
+  for (const auto &row: nfa.delta)
+    for (const auto &e: row.second)
+      r.transitionsBefore += e.second.size();
+
+  const unique_ptr<NFA> epsFree(nfa.epsFreeOf());
+  r.epsCycleMerged = nfa.S.size() - nfa.nrOfEpsSCCs();
+  r.trimmedStates  = nfa.nrOfEpsSCCs() - epsFree->S.size(); // unreachable ones
+  IntNFA a = intNFAOf(*epsFree);
+
+  if (!trim(a, r.trimmedStates)) { // empty language: nothing to reduce
+    if (report != nullptr) {
+      r.statesAfter      = epsFree->S.size();
+      r.transitionsAfter = a.nrOfTransitions();
+      *report = r;
+    } // if
+    return new NFA(*epsFree);
+  } // if
+
+  // 1. alternate forward and backward bisimulation until stable
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (bool backward: {false, true}) {
+      vector<int> blockOf;
+      const int nBlocks = bisimulationBlocksOf(a, backward, blockOf);
+      if (nBlocks < a.nrOfStates()) {
+        (backward ? r.backwardMerged : r.forwardMerged) += a.nrOfStates() - nBlocks;
+        a = quotientOf(a, blockOf, nBlocks);
+        changed = true;
+      } // if
+    } // for
+  } // while
+
+  // 2. optional simulation: prune little brothers, merge mutually similar
+  if (useSimulation && (size_t)a.nrOfStates() <= maxStatesForSimulation) {
+    r.prunedTransitions = pruneLittleBrothers(a, simulationOf(a));
+    trim(a, r.trimmedStates);
+    const int n = a.nrOfStates();
+    const vector<bool> sim = simulationOf(a);
+    vector<int> blockOf(n, -1);
+    int nBlocks = 0;
+    for (int p = 0; p < n; p++) {
+      if (blockOf[p] >= 0)
+        continue;
+      blockOf[p] = nBlocks;
+      for (int q = p + 1; q < n; q++)
+        if (blockOf[q] < 0 && sim[(size_t)p * n + q] && sim[(size_t)q * n + p])
+          blockOf[q] = nBlocks;
+      nBlocks++;
+    } // for
+    if (nBlocks < n) {
+      r.simulationMerged = n - nBlocks;
+      a = quotientOf(a, blockOf, nBlocks);
+    } // if
+  } else
+    r.simulationSkipped = true;
+
+  r.statesAfter      = a.nrOfStates();
+  r.transitionsAfter = a.nrOfTransitions();
+  if (report != nullptr)
+    *report = r;
+  return nfaOf(a);
+} // reducedOf
+
+
+// end of NFAReduction.cpp
+//======================================================================
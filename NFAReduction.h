@@ -0,0 +1,50 @@
+// NFAReduction.h:                                                 2024
+// --------------
+// Language preserving reduction of NFAs before determinization:
+// *  epsilon removal (cf. NFA::epsFreeOf) and trimming of states that
+//    are not reachable or cannot reach a final state,
+// *  merging of forward and backward bisimilar states (partition
+//    refinement on signatures), alternating until nothing changes,
+// *  optionally, simulation preorder pruning: merging of mutually
+//    similar states and removal of transitions to "little brothers",
+//    i.e., p -a-> r1 when also p -a-> r2 and r2 simulates r1.
+// Simulation costs O(|S|^2) memory, so it is skipped for large NFAs.
+//======================================================================
+
+#pragma once
+#ifndef NFAReduction_h
+#define NFAReduction_h
+
+#include <cstddef>
+#include <iosfwd>
+
+class NFA;
+
+
+struct NFAReductionReport {
+  std::size_t statesBefore      = 0, transitionsBefore = 0;
+  std::size_t statesAfter       = 0, transitionsAfter  = 0;
+  std::size_t epsCycleMerged    = 0; // states removed by merging eps. cycles
+  std::size_t trimmedStates     = 0; // unreachable (without eps.) or useless
+  std::size_t forwardMerged     = 0; // states removed by forward bisim.
+  std::size_t backwardMerged    = 0; // states removed by backward bisim.
+  std::size_t simulationMerged  = 0; // states removed by mutual simulation
+  std::size_t prunedTransitions = 0; // transitions to little brothers
+  bool        simulationSkipped = false;
+}; // NFAReductionReport
+
+std::ostream &operator<<(std::ostream &os, const NFAReductionReport &r);
+
+
+constexpr std::size_t maxStatesForSimulation = 2000;
+
+// equivalent, epsilon-free NFA with (usually) fewer states, the states
+//   are named after one of the states they represent
+NFA *reducedOf(const NFA &nfa, bool useSimulation = false,
+               NFAReductionReport *report = nullptr);
+
+
+#endif
+
+// end of NFAReduction.h
+//======================================================================
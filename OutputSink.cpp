@@ -0,0 +1,54 @@
+// OutputSink.cpp:                                                 2024
+// --------------
+// Sinks for the output tapes of transducers: strings, fixed buffers,
+// files and streams.
+//======================================================================
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+#include "OutputSink.h"
+
+
+void BufferSink::write(const char *data, size_t len) {
+  const size_t k = min(len, capacity - n);
+  memcpy(buffer + n, data, k);
+  n += k;
+  nLost += len - k;
+} // BufferSink::write
+
+
+FileSink::FileSink(const string &fileName)
+: ofs(fileName, ios::binary) {
+  if (!ofs.good())
+    throw runtime_error("error on opening output file \"" +
+                        fileName + "\"");
+} // FileSink::FileSink
+
+void FileSink::write(const char *data, size_t n) {
+  if (!ofs.write(data, (streamsize)n))
+    throw runtime_error("error on writing output file");
+} // FileSink::write
+
+void FileSink::flush() {
+  ofs.flush();
+} // FileSink::flush
+
+
+void StreamSink::write(const char *data, size_t n) {
+  os.write(data, (streamsize)n);
+} // StreamSink::write
+
+void StreamSink::flush() {
+  os.flush();
+} // StreamSink::flush
+
+
+// end of OutputSink.cpp
+//======================================================================
@@ -0,0 +1,109 @@
+// OutputSink.h:                                                   2024
+// ------------
+// OutputSink is the interface for the output tapes of transducers (cf.
+// MooreDFA::transduce and MealyDFA::transduce), which collect their
+// output in chunks and hand each chunk over in one call of write:
+// *  StringSink appends to a caller's Tape,
+// *  BufferSink fills a caller's buffer of fixed capacity and counts
+//    what did not fit,
+// *  FileSink writes to a (binary) file,
+// *  StreamSink writes to an ostream, e.g., cout.
+//======================================================================
+
+#pragma once
+#ifndef OutputSink_h
+#define OutputSink_h
+
+#include <cstddef>
+#include <fstream>
+#include <iosfwd>
+#include <string>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+
+
+class OutputSink
+        /*OC+*/ : private ObjectCounter<OutputSink> /*+OC*/ {
+
+  public:
+
+    OutputSink() = default;
+
+    OutputSink(const OutputSink  &os) = delete;
+    OutputSink(      OutputSink &&os) = delete;
+
+    virtual ~OutputSink() = default;
+
+    virtual void write(const char *data, std::size_t n) = 0;
+    virtual void flush() {}
+
+}; // OutputSink
+
+
+class StringSink final: public OutputSink {
+
+    Tape &tape;
+
+  public:
+
+    explicit StringSink(Tape &tape): tape(tape) {}
+
+    void write(const char *data, std::size_t n) override { tape.append(data, n); }
+
+}; // StringSink
+
+
+class BufferSink final: public OutputSink {
+
+    char        *buffer;
+    std::size_t  capacity, n = 0, nLost = 0;
+
+  public:
+
+    BufferSink(char *buffer, std::size_t capacity)
+    : buffer(buffer), capacity(capacity) {}
+
+    void write(const char *data, std::size_t len) override;
+
+    std::size_t size()       const { return n; }
+    std::size_t nrOfLost()   const { return nLost; } // beyond capacity
+    bool        overflowed() const { return nLost > 0; }
+
+    void clear() { n = nLost = 0; }
+
+}; // BufferSink
+
+
+class FileSink final: public OutputSink {
+
+    std::ofstream ofs;
+
+  public:
+
+    explicit FileSink(const std::string &fileName); // runtime_error if not opened
+
+    void write(const char *data, std::size_t n) override;
+    void flush() override;
+
+}; // FileSink
+
+
+class StreamSink final: public OutputSink {
+
+    std::ostream &os;
+
+  public:
+
+    explicit StreamSink(std::ostream &os): os(os) {}
+
+    void write(const char *data, std::size_t n) override;
+    void flush() override;
+
+}; // StreamSink
+
+
+#endif
+
+// end of OutputSink.h
+//======================================================================
@@ -0,0 +1,140 @@
+// PerfCounters.cpp:                                               2024
+// ----------------
+// Simple utility to read hardware performance counters around a piece
+// of code, based on perf_event_open on Linux.
+//======================================================================
+
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #if defined(__x86_64__) || defined(__i386__)
+    #include <cpuid.h>
+  #endif
+#endif
+
+using namespace std;
+
+#include "PerfCounters.h"
+
+
+static const char *eventName[PerfCounters::nrOfEvents] =
+  {"cycles", "instructions", "L1d read misses", "L2 misses", "LLC read misses"};
+
+#ifdef __linux__
+
+static int openEvent(unsigned int type, unsigned long long config) {
+  perf_event_attr pea;
+  memset(&pea, 0, sizeof(pea));
+  pea.type           = type;
+  pea.size           = sizeof(pea);
+  pea.config         = config;
+  pea.disabled       = 1;
+  pea.exclude_kernel = 1; // user space only, works with paranoid level 2
+  pea.exclude_hv     = 1;
+  return (int)syscall(__NR_perf_event_open, &pea, 0, -1, -1, 0);
+} // openEvent
+
+static unsigned long long cacheConfigOf(unsigned long long cache) {
+  return cache |
+         (PERF_COUNT_HW_CACHE_OP_READ     <<  8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+} // cacheConfigOf
+
+// raw config (umask << 8 | event) for L2 misses, 0 for unknown CPUs
+static unsigned long long l2MissConfig() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  char vendor[13] = {0};
+  if (__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+    memcpy(vendor,     &ebx, 4);
+    memcpy(vendor + 4, &edx, 4);
+    memcpy(vendor + 8, &ecx, 4);
+  } // if
+  if (strcmp(vendor, "GenuineIntel") == 0)
+    return 0x3F24;  // L2_RQSTS.MISS
+  if (strcmp(vendor, "AuthenticAMD") == 0)
+    return 0x0964;  // l2_cache_req_stat.ic_dc_miss_in_l2 (Zen)
+#endif
+  return 0;
+} // l2MissConfig
+
+#endif
+
+
+PerfCounters::PerfCounters() {
+  for (int e = 0; e < nrOfEvents; e++) {
+    fds[e]    = -1;
+    counts[e] =  0;
+  } // for
+#ifdef __linux__
+  fds[cycles]        = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  fds[instructions]  = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  fds[l1dReadMisses] = openEvent(PERF_TYPE_HW_CACHE, cacheConfigOf(PERF_COUNT_HW_CACHE_L1D));
+  if (l2MissConfig() != 0)
+    fds[l2Misses]    = openEvent(PERF_TYPE_RAW, l2MissConfig());
+  fds[llcReadMisses] = openEvent(PERF_TYPE_HW_CACHE, cacheConfigOf(PERF_COUNT_HW_CACHE_LL));
+#endif
+} // PerfCounters::PerfCounters
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (int e = 0; e < nrOfEvents; e++)
+    if (fds[e] >= 0)
+      close(fds[e]);
+#endif
+} // PerfCounters::~PerfCounters
+
+
+bool PerfCounters::available() const {
+  for (int e = 0; e < nrOfEvents; e++)
+    if (fds[e] >= 0)
+      return true;
+  return false;
+} // PerfCounters::available
+
+
+void PerfCounters::start() {
+#ifdef __linux__
+  for (int e = 0; e < nrOfEvents; e++)
+    if (fds[e] >= 0) {
+      ioctl(fds[e], PERF_EVENT_IOC_RESET,  0);
+      ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+    } // if
+#endif
+} // PerfCounters::start
+
+void PerfCounters::stop() {
+#ifdef __linux__
+  for (int e = 0; e < nrOfEvents; e++)
+    if (fds[e] >= 0) {
+      ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+      unsigned long long value = 0;
+      if (read(fds[e], &value, sizeof(value)) == (ssize_t)sizeof(value))
+        counts[e] = value;
+    } // if
+#endif
+} // PerfCounters::stop
+
+
+ostream &operator<<(ostream &os, const PerfCounters &pc) {
+  if (!pc.available())
+    return os << "(perf counters not available)";
+  bool first = true;
+  for (int e = 0; e < PerfCounters::nrOfEvents; e++)
+    if (pc.available((PerfCounters::Event)e)) {
+      if (!first)
+        os << ", ";
+      os << eventName[e] << " = " << pc.count((PerfCounters::Event)e);
+      first = false;
+    } // if
+  return os;
+} // operator<<
+
+
+// end of PerfCounters.cpp
+//======================================================================
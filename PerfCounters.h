@@ -0,0 +1,59 @@
+// PerfCounters.h:                                                 2024
+// --------------
+// Simple utility to read hardware performance counters (cycles,
+// instructions, L1 data cache, L2 and last level cache misses) around
+// a piece of code, based on perf_event_open on Linux.
+// The kernel has no generic event for L2 misses, so l2Misses is a raw
+// event of the CPU: L2_RQSTS.MISS on Intel, the L2 misses of L1
+// requests (l2_cache_req_stat) on AMD, unavailable on other CPUs.
+// Where perf events are not available (other OSs, missing permissions,
+// virtual machines) available() is false and all counts are 0.
+//======================================================================
+
+#pragma once
+#ifndef PerfCounters_h
+#define PerfCounters_h
+
+#include <iosfwd>
+
+#include "ObjectCounter.h"
+
+
+class PerfCounters final
+        /*OC+*/ : private ObjectCounter<PerfCounters> /*+OC*/ {
+
+  public:
+
+    enum Event { cycles, instructions, l1dReadMisses, l2Misses, llcReadMisses, nrOfEvents };
+
+  private:
+
+    int fds[nrOfEvents];                   // -1 for unavailable events
+    unsigned long long counts[nrOfEvents];
+
+  public:
+
+    PerfCounters();
+
+    PerfCounters(const PerfCounters  &pc) = delete;
+    PerfCounters(      PerfCounters &&pc) = delete;
+
+    ~PerfCounters() override;
+
+    bool available() const;                // any event available?
+    bool available(Event e) const { return fds[e] >= 0; }
+
+    void start();
+    void stop();
+
+    unsigned long long count(Event e) const { return counts[e]; }
+
+}; // PerfCounters
+
+std::ostream &operator<<(std::ostream &os, const PerfCounters &pc);
+
+
+#endif
+
+// end of PerfCounters.h
+//======================================================================
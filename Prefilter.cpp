@@ -0,0 +1,296 @@
+// Prefilter.cpp:                                                  2024
+// -------------
+// Required literals of DFAs and the prefilter stage that searches for
+// them before the automaton runs.
+//======================================================================
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "CompiledNFA.h"
+#include "CompiledDFA.h"
+#include "FragmentArena.h"
+#include "Prefilter.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+namespace {
+
+  typedef CompiledDFA::StateId StateId;
+
+  constexpr int    maxStates   = 2000; // of the minimal DFA, no literals above
+  constexpr size_t maxLiterals = 16;   // per set
+  constexpr size_t maxPairs    = 4096; // (state, tape) pairs per level
+  constexpr int    maxLength   = 32;   // of literals
+
+  struct Edge {
+    StateId state;          // destination (succ.) or source (pred.)
+    int     c;              // class of the transition
+  }; // Edge
+
+  typedef vector<vector<Edge>> Graph;
+
+  vector<int> distancesOf(const vector<StateId> &sources, const Graph &g) {
+    vector<int> dist(g.size(), numeric_limits<int>::max());
+    vector<StateId> queue;
+    for (StateId s: sources) {
+      dist[s] = 0;
+      queue.push_back(s);
+    } // for
+    for (size_t i = 0; i < queue.size(); i++)
+      for (const Edge &e: g[queue[i]])
+        if (dist[e.state] == numeric_limits<int>::max()) {
+          dist[e.state] = dist[queue[i]] + 1;
+          queue.push_back(e.state);
+        } // if
+    return dist;
+  } // distancesOf
+
+  // d is reachable from itself
+  bool isOnCycle(const Graph &succ, StateId d) {
+    vector<bool> visited(succ.size(), false);
+    vector<StateId> stack{d};
+    while (!stack.empty()) {
+      const StateId s = stack.back();
+      stack.pop_back();
+      for (const Edge &e: succ[s]) {
+        if (e.state == d)
+          return true;
+        if (!visited[e.state]) {
+          visited[e.state] = true;
+          stack.push_back(e.state);
+        } // if
+      } // for
+    } // while
+    return false;
+  } // isOnCycle
+
+  // all accepting paths pass through d, i.e., no final state is
+  //   reachable from the start state without d
+  bool isRequired(const CompiledDFA &cDfa, const Graph &succ, StateId d) {
+    const StateId start = cDfa.startState();
+    if (d == start)
+      return true;
+    vector<bool> visited(succ.size(), false);
+    vector<StateId> stack{start};
+    visited[start] = visited[d] = true;
+    while (!stack.empty()) {
+      const StateId s = stack.back();
+      stack.pop_back();
+      if (cDfa.isFinal(s))
+        return false;
+      for (const Edge &e: succ[s])
+        if (!visited[e.state]) {
+          visited[e.state] = true;
+          stack.push_back(e.state);
+        } // if
+    } // while
+    return true;
+  } // isRequired
+
+  // the tapes read on the paths of j steps into the first visit of d
+  //   (backward) or out of its last visit, i.e., without d in between,
+  //   for the largest j <= maxJ with few tapes, so each accepting path
+  //   with at least j steps before (after) d reads one of them there
+  set<Tape> tapesAround(StateId d, const Graph &g, int maxJ, bool backward,
+                        const vector<vector<unsigned char>> &bytesOf) {
+    set<Tape> result{Tape()};
+    set<pair<StateId, Tape>> level{{d, Tape()}};
+    for (int j = 1; j <= maxJ; j++) {
+      set<pair<StateId, Tape>> next;
+      set<Tape> tapes;
+      for (const auto &st: level)
+        for (const Edge &e: g[st.first]) {
+          if (e.state == d)  // d in between
+            continue;
+          for (unsigned char b: bytesOf[e.c]) {
+            Tape t = backward ? Tape(1, (char)b) + st.second : st.second + (char)b;
+            tapes.insert(t);
+            next.emplace(e.state, std::move(t));
+            if (next.size() > maxPairs || tapes.size() > maxLiterals)
+              return result;
+          } // for
+        } // for
+      if (tapes.empty())     // no path of j steps
+        return result;
+      result.swap(tapes);
+      level.swap(next);
+    } // for
+    return result;
+  } // tapesAround
+
+  // longer literals first, then fewer of them
+  bool isBetter(const set<Tape> &a, const set<Tape> &b) {
+    const size_t la = a.begin()->length(), lb = b.begin()->length();
+    return la != lb ? la > lb : a.size() < b.size();
+  } // isBetter
+
+} // namespace
+
+
+vector<Tape> requiredLiteralsOf(const CompiledDFA &cDfa) {
+  const CompiledDFA d = cDfa.minimalOf(); // useful states only
+  const int n = d.nrOfStates(), nC = d.nrOfClasses();
+  if (n > maxStates)
+    return {};
+  vector<vector<unsigned char>> bytesOf(nC);
+  for (int b = 0; b < 256; b++)
+    bytesOf[d.classOf((TapeSymbol)b)].push_back((unsigned char)b);
+  Graph succ(n), pred(n);
+  vector<StateId> finals;
+  for (StateId s = 0; s < n; s++) {
+    if (d.isFinal(s))
+      finals.push_back(s);
+    for (int c = 0; c < nC; c++) {
+      const StateId dest = d.destOf(s, c);
+      if (dest != CompiledDFA::undef && !bytesOf[c].empty()) {
+        succ[s].push_back({dest, c});
+        pred[dest].push_back({s, c});
+      } // if
+    } // for
+  } // for
+  if (finals.empty())                     // empty language
+    return {};
+  const vector<int> fromStart = distancesOf({d.startState()}, succ),
+                    toFinal   = distancesOf(finals, pred);
+
+  set<Tape> best{Tape()};
+  for (StateId s = 0; s < n; s++) {
+    if (!isRequired(d, succ, s))
+      continue;
+    const set<Tape> in  = tapesAround(s, pred, min(maxLength, fromStart[s]), true, bytesOf),
+                    out = tapesAround(s, succ, min(maxLength, toFinal[s]), false, bytesOf);
+    for (const set<Tape> *ts: {&in, &out})
+      if (isBetter(*ts, best))
+        best = *ts;
+    if (in.size() * out.size() <= maxLiterals && !isOnCycle(succ, s)) {
+      set<Tape> joined;                   // first visit is the last one
+      for (const Tape &a: in)
+        for (const Tape &b: out)
+          joined.insert(a + b);
+      if (isBetter(joined, best))
+        best = joined;
+    } // if
+  } // for
+  if (best.begin()->empty())
+    return {};
+  return vector<Tape>(best.begin(), best.end());
+} // requiredLiteralsOf
+
+vector<Tape> requiredLiteralsOf(const CompiledNFA &cNfa) {
+  return requiredLiteralsOf(CompiledDFA(cNfa));
+} // requiredLiteralsOf
+
+
+Prefilter::Prefilter(const CompiledDFA &cDfa)
+: Prefilter(cDfa, requiredLiteralsOf(cDfa)) {
+} // Prefilter::Prefilter
+
+Prefilter::Prefilter(const CompiledDFA &cDfa, const vector<Tape> &literals)
+: dfa(cDfa), lits(literals) {
+  if (any_of(lits.begin(), lits.end(), [](const Tape &l) { return l.empty(); }))
+    lits.clear();            // the empty literal occurs everywhere
+  if (lits.size() > 1) {     // minimal DFA of .*(l1|...|ln)
+    FragmentArena fa;
+    FragmentArena::SymbolSet all;
+    all.set();
+    vector<FragmentArena::Fragment> alts;
+    for (const Tape &l: lits)
+      alts.push_back(fa.literal(l));
+    const FragmentArena::Fragment f = fa.concat(fa.star(fa.symbols(all)), fa.alternate(alts));
+    searchDfa = make_shared<const CompiledDFA>(CompiledDFA(fa.compiledOf(f)).minimalOf());
+  } // if
+} // Prefilter::Prefilter
+
+
+// candidates, i.e., positions of the first and the last byte of lit,
+//   are found with SIMD compares, the bytes between checked with memcmp
+static size_t findLiteral(const unsigned char *p, size_t n, const Tape &lit) {
+  const size_t len = lit.length();
+  if (len > n)
+    return Prefilter::npos;
+  const unsigned char *l = (const unsigned char *)lit.data();
+  if (len == 1) {
+    const void *q = memchr(p, l[0], n);
+    return q == nullptr ? Prefilter::npos : (const unsigned char *)q - p;
+  } // if
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128i first = _mm_set1_epi8((char)l[0]), last = _mm_set1_epi8((char)l[len - 1]);
+  for (; i + len - 1 + 16 <= n; i += 16) {
+    const __m128i a = _mm_loadu_si128((const __m128i *)(p + i)),
+                  b = _mm_loadu_si128((const __m128i *)(p + i + len - 1));
+    unsigned m = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first),
+                                                           _mm_cmpeq_epi8(b, last)));
+    for (; m != 0; m &= m - 1) {
+      const size_t k = i + __builtin_ctz(m);
+      if (memcmp(p + k + 1, l + 1, len - 2) == 0)
+        return k;
+    } // for
+  } // for
+#endif
+  for (; i + len <= n; i++)
+    if (p[i] == l[0] && memcmp(p + i + 1, l + 1, len - 1) == 0)
+      return i;
+  return Prefilter::npos;
+} // findLiteral
+
+size_t Prefilter::find(TapeView tape, size_t from) const {
+  if (lits.empty())
+    return from <= tape.size() ? from : npos;
+  if (from > tape.size())
+    return npos;
+  const TapeView rest = tape.substr(from);
+  if (!searchDfa) {
+    const size_t k = findLiteral((const unsigned char *)rest.data(), rest.size(), lits[0]);
+    return k == npos ? npos : from + k;
+  } // if
+  const size_t end = searchDfa->scan(rest);  // end of the first occurrence
+  if (end == npos)
+    return npos;
+  for (const Tape &l: lits)                  // the one that ends there
+    if (l.length() <= end && rest.compare(end - l.length(), l.length(), l) == 0)
+      return from + end - l.length();
+  return npos;               // not reached for required literals
+} // Prefilter::find
+
+bool Prefilter::mayAccept(TapeView tape) const {
+  stats.nrOfTapes++;
+  const bool passed = lits.empty() || find(tape) != npos;
+  if (passed) {
+    stats.nrOfPassed++;
+    stats.nrOfBytes += tape.size();
+  } // if
+  return passed;
+} // Prefilter::mayAccept
+
+
+ostream &operator<<(ostream &os, const Prefilter &pf) {
+  if (!pf.isUseful())
+    os << "no literals (pass through)";
+  else {
+    os << "literals {";
+    for (size_t i = 0; i < pf.literals().size(); i++)
+      os << (i > 0 ? ", " : "") << '"' << pf.literals()[i] << '"';
+    os << "}";
+  } // if
+  const Prefilter::Statistics &st = pf.statistics();
+  os << ": " << st.nrOfPassed << " of " << st.nrOfTapes << " tapes passed ("
+     << st.selectivity() * 100.0 << " %)";
+  return os;
+} // operator<<
+
+
+// end of Prefilter.cpp
+//======================================================================
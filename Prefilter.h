@@ -0,0 +1,101 @@
+// Prefilter.h:                                                    2024
+// -----------
+// Required literals and a prefilter stage in front of a CompiledDFA:
+// *  requiredLiteralsOf derives a set of literals (tapes) of which each
+//    accepted tape contains at least one, on the minimal DFA: for each
+//    state all accepting paths pass (a dominator of the final states),
+//    the tapes read on all paths into and out of it are enumerated up
+//    to the distances to the start and the final states, as long as
+//    there are only few of them, the longest such literals are best,
+// *  Prefilter searches for these literals before the automaton runs:
+//    one literal with SIMD compares of its first and last byte (memchr
+//    for one byte), several literals with the minimal DFA of
+//    .*(l1|...|ln), which is the Aho-Corasick automaton, and its
+//    accelerated scan; tapes without any literal are rejected at once,
+//    find locates candidate regions in long tapes,
+// *  without literals (e.g., for [a-z]*) all tapes pass through,
+// *  statistics count tapes and passes, so the selectivity of each
+//    prefilter can be reported (not thread safe).
+//======================================================================
+
+#pragma once
+#ifndef Prefilter_h
+#define Prefilter_h
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "CompiledDFA.h"
+
+class CompiledNFA;
+
+
+// empty if there are no useful literals (e.g., the DFA accepts the
+//   empty tape or too many different tapes), all literals of equal length
+std::vector<Tape> requiredLiteralsOf(const CompiledDFA &cDfa);
+std::vector<Tape> requiredLiteralsOf(const CompiledNFA &cNfa);
+
+
+class Prefilter final
+        /*OC+*/ : private ObjectCounter<Prefilter> /*+OC*/ {
+
+  public:
+
+    static constexpr std::size_t npos = CompiledDFA::npos;
+
+    struct Statistics {
+      std::size_t nrOfTapes  = 0;           // filtered tapes
+      std::size_t nrOfPassed = 0;           // ... that contain a literal
+      std::size_t nrOfBytes  = 0;           // ... and their bytes
+      double selectivity() const {          // fraction passed, 1 without literals
+        return nrOfTapes == 0 ? 1.0 : (double)nrOfPassed / nrOfTapes;
+      } // selectivity
+    }; // Statistics
+
+  private:
+
+    CompiledDFA dfa;                        // the automaton behind the filter
+    std::vector<Tape> lits;
+    std::shared_ptr<const CompiledDFA> searchDfa; // for several literals
+    mutable Statistics stats;
+
+  public:
+
+    explicit Prefilter(const CompiledDFA &cDfa);
+    // literals must be required ones, otherwise tapes are rejected wrongly
+    Prefilter(const CompiledDFA &cDfa, const std::vector<Tape> &literals);
+
+    Prefilter(const Prefilter  &pf) = default;
+    Prefilter(      Prefilter &&pf) = default;
+
+    ~Prefilter() = default;
+
+    const std::vector<Tape> &literals() const { return lits; }
+    bool isUseful() const { return !lits.empty(); }
+
+    // start of the occurrence of a literal that ends first at or after
+    //   from, npos if there is none (0 without literals)
+    std::size_t find(TapeView tape, std::size_t from = 0) const;
+
+    bool mayAccept(TapeView tape) const;    // false: DFA rejects, counted
+
+    bool        accepts(TapeView tape) const { return mayAccept(tape) && dfa.accepts(tape); }
+    std::size_t scan   (TapeView tape) const { return mayAccept(tape) ? dfa.scan(tape) : npos; }
+
+    const Statistics &statistics() const { return stats; }
+    void resetStatistics() { stats = Statistics(); }
+
+}; // Prefilter
+
+// literals and selectivity
+std::ostream &operator<<(std::ostream &os, const Prefilter &pf);
+
+
+#endif
+
+// end of Prefilter.h
+//======================================================================
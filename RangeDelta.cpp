@@ -0,0 +1,486 @@
+// RangeDelta.cpp:                                                 2024
+// --------------
+// Symbolic transitions for large alphabets: range sets, RangeNFA and
+// RangeDFA.
+//======================================================================
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "StateStuff.h"
+#include "NFA.h"
+#include "DFA.h"
+#include "FABuilder.h"
+#include "CompiledNFA.h"
+#include "CompiledDFA.h"
+#include "RangeDelta.h"
+
+
+static constexpr WideSymbol maxSymbol = numeric_limits<WideSymbol>::max();
+
+
+// --- implementation of class RangeSet ---
+
+RangeSet &RangeSet::add(WideSymbol lo, WideSymbol hi) {
+  if (lo > hi)
+    throw invalid_argument("RangeSet: invalid range");
+  // first range that may touch [lo, hi], i.e., with r.hi + 1 >= lo
+  auto first = lower_bound(rs.begin(), rs.end(), lo, [](const SymbolRange &r, WideSymbol s) {
+                 return r.hi != maxSymbol && r.hi + 1 < s;
+               });
+  auto last = first;         // behind the last touching range
+  while (last != rs.end() && (hi == maxSymbol || last->lo <= hi + 1)) {
+    lo = min(lo, last->lo);
+    hi = max(hi, last->hi);
+    ++last;
+  } // while
+  first = rs.erase(first, last);
+  rs.insert(first, SymbolRange{lo, hi});
+  return *this;
+} // RangeSet::add
+
+RangeSet &RangeSet::add(const RangeSet &other) {
+  for (const SymbolRange &r: other.rs)
+    add(r.lo, r.hi);
+  return *this;
+} // RangeSet::add
+
+bool RangeSet::contains(WideSymbol sy) const {
+  auto it = upper_bound(rs.begin(), rs.end(), sy, [](WideSymbol s, const SymbolRange &r) {
+              return s < r.lo;
+            });
+  return it != rs.begin() && prev(it)->hi >= sy;
+} // RangeSet::contains
+
+RangeSet RangeSet::complementOf(WideSymbol maxSy) const {
+  RangeSet c;
+  WideSymbol next = 0;           // first symbol not yet covered
+  bool done = false;
+  for (const SymbolRange &r: rs) {
+    if (r.lo > maxSy)
+      break;
+    if (r.lo > next)
+      c.rs.push_back({next, r.lo - 1});
+    if (r.hi >= maxSy) {
+      done = true;
+      break;
+    } // if
+    next = r.hi + 1;
+  } // for
+  if (!done)
+    c.rs.push_back({next, maxSy});
+  return c;
+} // RangeSet::complementOf
+
+static void printSymbol(ostream &os, WideSymbol sy) {
+  if (sy > ' ' && sy < 127)
+    os << (char)sy;
+  else
+    os << "0x" << hex << sy << dec;
+} // printSymbol
+
+ostream &operator<<(ostream &os, const RangeSet &rs) {
+  os << "{";
+  bool first = true;
+  for (const SymbolRange &r: rs.ranges()) {
+    os << (first ? "" : ", ");
+    first = false;
+    printSymbol(os, r.lo);
+    if (r.hi != r.lo) {
+      os << "-";
+      printSymbol(os, r.hi);
+    } // if
+  } // for
+  return os << "}";
+} // operator<<
+
+
+// --- implementation of class RangeNFA ---
+
+RangeNFA::RangeNFA(int nStates)
+: final(nStates, false), out(nStates), epsOut(nStates) {
+} // RangeNFA::RangeNFA
+
+RangeNFA::RangeNFA(const NFA &nfa)
+: RangeNFA((int)nfa.S.size()) {
+  const vector<State> names(nfa.S.begin(), nfa.S.end());
+  auto idOf = [&names](const State &s) {
+    return (StateId)(lower_bound(names.begin(), names.end(), s) - names.begin());
+  }; // idOf
+  start = idOf(nfa.s1);
+  for (const State &f: nfa.F)
+    final[idOf(f)] = true;
+  for (const auto &row: nfa.delta) {
+    const StateId src = idOf(row.first);
+    vector<pair<StateId, WideSymbol>> bySymbol; // (dest, symbol), then sorted
+    for (const auto &e: row.second)
+      for (const State &d: e.second)
+        if (e.first == eps)
+          epsOut[src].push_back(idOf(d));
+        else
+          bySymbol.emplace_back(idOf(d), (unsigned char)e.first);
+    sort(bySymbol.begin(), bySymbol.end());
+    for (size_t i = 0; i < bySymbol.size(); ) {
+      size_t j = i + 1;        // consecutive symbols to the same dest
+      while (j < bySymbol.size() && bySymbol[j].first == bySymbol[i].first &&
+             bySymbol[j].second == bySymbol[j - 1].second + 1)
+        j++;
+      out[src].push_back({{bySymbol[i].second, bySymbol[j - 1].second}, bySymbol[i].first});
+      i = j;
+    } // for
+  } // for
+} // RangeNFA::RangeNFA
+
+
+RangeNFA::StateId RangeNFA::addState() {
+  final.push_back(false);
+  out.emplace_back();
+  epsOut.emplace_back();
+  return (StateId)out.size() - 1;
+} // RangeNFA::addState
+
+RangeNFA &RangeNFA::setStartState(StateId s) {
+  start = s;
+  return *this;
+} // RangeNFA::setStartState
+
+RangeNFA &RangeNFA::addFinalState(StateId s) {
+  final[s] = true;
+  return *this;
+} // RangeNFA::addFinalState
+
+RangeNFA &RangeNFA::addTransition(StateId src, WideSymbol lo, WideSymbol hi, StateId dest) {
+  if (lo > hi)
+    throw invalid_argument("RangeNFA: invalid range");
+  out[src].push_back({{lo, hi}, dest});
+  return *this;
+} // RangeNFA::addTransition
+
+RangeNFA &RangeNFA::addTransition(StateId src, const RangeSet &rs, StateId dest) {
+  for (const SymbolRange &r: rs.ranges())
+    out[src].push_back({r, dest});
+  return *this;
+} // RangeNFA::addTransition
+
+RangeNFA &RangeNFA::addEpsTransition(StateId src, StateId dest) {
+  epsOut[src].push_back(dest);
+  return *this;
+} // RangeNFA::addEpsTransition
+
+size_t RangeNFA::nrOfRanges() const {
+  size_t n = 0;
+  for (const auto &o: out)
+    n += o.size();
+  return n;
+} // RangeNFA::nrOfRanges
+
+
+// subset construction: the ranges leaving a state set are split at all
+//   their bounds only, and a sweep over the bounds yields the dest. set
+//   of each elementary interval, so no symbol is ever enumerated
+RangeDFA RangeNFA::dfaOf() const {
+  const int n = nrOfStates();
+  vector<unsigned> mark(n, 0);
+  unsigned stamp = 0;
+  auto closureOf = [&](vector<StateId> set) {
+    stamp++;
+    for (StateId s: set)
+      mark[s] = stamp;
+    for (size_t i = 0; i < set.size(); i++)
+      for (StateId d: epsOut[set[i]])
+        if (mark[d] != stamp) {
+          mark[d] = stamp;
+          set.push_back(d);
+        } // if
+    sort(set.begin(), set.end());
+    return set;
+  }; // closureOf
+
+  map<vector<StateId>, RangeDFA::StateId> idOf;
+  vector<const vector<StateId> *> sets;
+  auto intern = [&](vector<StateId> set) {
+    auto ir = idOf.emplace(std::move(set), (RangeDFA::StateId)sets.size());
+    if (ir.second)
+      sets.push_back(&ir.first->first);
+    return ir.first->second;
+  }; // intern
+
+  intern(closureOf({start}));
+  vector<vector<RangeDFA::Transition>> rows;
+  vector<bool> finals;
+  struct Event { WideSymbol sy; int delta; StateId dest; };
+  vector<Event> events;
+  map<StateId, int> active;  // dest -> nr. of ranges covering the sweep
+  for (size_t i = 0; i < sets.size(); i++) {
+    const vector<StateId> &set = *sets[i];
+    bool f = false;
+    events.clear();
+    for (StateId s: set) {
+      f = f || final[s];
+      for (const Transition &t: out[s]) {
+        events.push_back({t.range.lo, +1, t.dest});
+        if (t.range.hi != maxSymbol)
+          events.push_back({t.range.hi + 1, -1, t.dest});
+      } // for
+    } // for
+    finals.push_back(f);
+    sort(events.begin(), events.end(), [](const Event &e1, const Event &e2) {
+      return e1.sy < e2.sy;
+    });
+    vector<RangeDFA::Transition> row;
+    active.clear();
+    for (size_t j = 0; j < events.size(); ) {
+      const WideSymbol lo = events[j].sy;
+      for (; j < events.size() && events[j].sy == lo; j++) {
+        int &cnt = active[events[j].dest];
+        cnt += events[j].delta;
+        if (cnt == 0)
+          active.erase(events[j].dest);
+      } // for
+      if (active.empty())
+        continue;
+      const WideSymbol hi = j < events.size() ? events[j].sy - 1 : maxSymbol;
+      vector<StateId> dests;
+      dests.reserve(active.size());
+      for (const auto &a: active)
+        dests.push_back(a.first);
+      row.push_back({lo, hi, intern(closureOf(std::move(dests)))});
+    } // for
+    rows.push_back(std::move(row));
+  } // for
+  return RangeDFA(0, std::move(finals), rows);
+} // RangeNFA::dfaOf
+
+
+// --- implementation of class RangeDFA ---
+
+RangeDFA::RangeDFA(StateId start, vector<bool> final,
+                   const vector<vector<Transition>> &rows)
+: start(start), final(std::move(final)) {
+  rowStart.reserve(rows.size() + 1);
+  for (const auto &row: rows) {
+    rowStart.push_back((uint32_t)ts.size());
+    const size_t first = ts.size();
+    for (const Transition &t: row)   // merge adjacent ranges, same dest
+      if (ts.size() > first && ts.back().dest == t.dest && ts.back().hi + 1 == t.lo)
+        ts.back().hi = t.hi;
+      else
+        ts.push_back(t);
+  } // for
+  rowStart.push_back((uint32_t)ts.size());
+  buildClasses();
+} // RangeDFA::RangeDFA
+
+void RangeDFA::buildClasses() {
+  bounds.clear();
+  for (const Transition &t: ts) {
+    bounds.push_back(t.lo);
+    if (t.hi != maxSymbol)
+      bounds.push_back(t.hi + 1);
+  } // for
+  sort(bounds.begin(), bounds.end());
+  bounds.erase(unique(bounds.begin(), bounds.end()), bounds.end());
+  for (WideSymbol b = 0; b < 256; b++)
+    byteClass[b] = classOfWide(b);
+} // RangeDFA::buildClasses
+
+void RangeDFA::buildClassTable() {
+  const size_t nC = bounds.size();
+  classTable.assign(final.size() * nC, undef);
+  for (StateId s = 0; s < nrOfStates(); s++)
+    for (uint32_t i = rowStart[s]; i < rowStart[s + 1]; i++) {
+      size_t c = lower_bound(bounds.begin(), bounds.end(), ts[i].lo) - bounds.begin();
+      for (; c < nC && bounds[c] <= ts[i].hi; c++)
+        classTable[s * nC + c] = ts[i].dest;
+    } // for
+} // RangeDFA::buildClassTable
+
+size_t RangeDFA::memoryInBytes() const {
+  return final.size() / 8 + rowStart.size() * sizeof(uint32_t) +
+         ts.size() * sizeof(Transition) + bounds.size() * sizeof(WideSymbol) +
+         classTable.size() * sizeof(StateId) + sizeof(byteClass);
+} // RangeDFA::memoryInBytes
+
+RangeDFA::StateId RangeDFA::next(StateId s, WideSymbol sy) const {
+  const Transition *first = ts.data() + rowStart[s], *last = ts.data() + rowStart[s + 1];
+  const Transition *it = upper_bound(first, last, sy, [](WideSymbol x, const Transition &t) {
+                           return x < t.lo;
+                         });
+  return (it != first && (it - 1)->hi >= sy) ? (it - 1)->dest : undef;
+} // RangeDFA::next
+
+int RangeDFA::classOfWide(WideSymbol sy) const {
+  return (int)(upper_bound(bounds.begin(), bounds.end(), sy) - bounds.begin()) - 1;
+} // RangeDFA::classOfWide
+
+bool RangeDFA::accepts(const vector<WideSymbol> &tape) const {
+  StateId s = start;
+  for (WideSymbol sy: tape) {
+    s = next(s, sy);
+    if (s == undef)
+      return false;
+  } // for
+  return final[s];
+} // RangeDFA::accepts
+
+bool RangeDFA::accepts(TapeView tape) const {
+  StateId s = start;
+  for (const char *p = tape.data(), *end = p + tape.size(); p != end; p++) {
+    s = nextOfClass(s, classOf((unsigned char)*p));
+    if (s == undef)
+      return false;
+  } // for
+  return final[s];
+} // RangeDFA::accepts
+
+
+// Moore's partition refinement, signatures are the rows with dest.
+//   replaced by blocks and adjacent ranges of equal blocks merged
+RangeDFA RangeDFA::minimalOf() const {
+  const int n = nrOfStates();
+  // 1. useful states: those that can reach a final state
+  vector<vector<StateId>> preds(n);
+  for (StateId s = 0; s < n; s++)
+    for (uint32_t i = rowStart[s]; i < rowStart[s + 1]; i++)
+      preds[ts[i].dest].push_back(s);
+  vector<bool> useful(final);
+  vector<StateId> stack;
+  for (StateId s = 0; s < n; s++)
+    if (useful[s])
+      stack.push_back(s);
+  while (!stack.empty()) {
+    const StateId s = stack.back();
+    stack.pop_back();
+    for (StateId p: preds[s])
+      if (!useful[p]) {
+        useful[p] = true;
+        stack.push_back(p);
+      } // if
+  } // while
+  if (!useful[start])        // empty language
+    return RangeDFA(0, {false}, vector<vector<Transition>>(1));
+
+  // 2. refinement, useless states form the implicit dead block -1
+  vector<int> block(n, -1);
+  for (StateId s = 0; s < n; s++)
+    if (useful[s])
+      block[s] = final[s] ? 1 : 0;
+  auto signatureOf = [&](StateId s) {
+    vector<Transition> sig;
+    for (uint32_t i = rowStart[s]; i < rowStart[s + 1]; i++) {
+      const int b = block[ts[i].dest];
+      if (b < 0)
+        continue;
+      if (!sig.empty() && sig.back().dest == b && sig.back().hi + 1 == ts[i].lo)
+        sig.back().hi = ts[i].hi;
+      else
+        sig.push_back({ts[i].lo, ts[i].hi, b});
+    } // for
+    return sig;
+  }; // signatureOf
+  auto keyOf = [](int b, const vector<Transition> &sig) {
+    vector<WideSymbol> key{(WideSymbol)b};
+    for (const Transition &t: sig) {
+      key.push_back(t.lo);
+      key.push_back(t.hi);
+      key.push_back((WideSymbol)t.dest);
+    } // for
+    return key;
+  }; // keyOf
+  int nBlocks = -1;
+  for (;;) {
+    map<vector<WideSymbol>, int> idOfKey;
+    vector<int> newBlock(n, -1);
+    for (StateId s = 0; s < n; s++)
+      if (block[s] >= 0)
+        newBlock[s] = idOfKey.emplace(keyOf(block[s], signatureOf(s)),
+                                      (int)idOfKey.size()).first->second;
+    block.swap(newBlock);
+    if ((int)idOfKey.size() == nBlocks)
+      break;
+    nBlocks = (int)idOfKey.size();
+  } // for
+
+  // 3. quotient, blocks renumbered in BFS order from start
+  vector<StateId> repOfBlock(nBlocks, undef);
+  for (StateId s = n - 1; s >= 0; s--)
+    if (block[s] >= 0)
+      repOfBlock[block[s]] = s;
+  vector<StateId> newId(nBlocks, undef), repOf;
+  newId[block[start]] = 0;
+  repOf.push_back(start);
+  vector<vector<Transition>> rows;
+  vector<bool> finals;
+  for (size_t i = 0; i < repOf.size(); i++) {
+    const StateId r = repOf[i];
+    vector<Transition> row = signatureOf(r);
+    for (Transition &t: row) {
+      if (newId[t.dest] == undef) {
+        newId[t.dest] = (StateId)repOf.size();
+        repOf.push_back(repOfBlock[t.dest]);
+      } // if
+      t.dest = newId[t.dest];
+    } // for
+    rows.push_back(std::move(row));
+    finals.push_back(final[r]);
+  } // for
+  return RangeDFA(0, std::move(finals), rows);
+} // RangeDFA::minimalOf
+
+
+DFA *RangeDFA::dfaOf() const {
+  vector<State> names(nrOfStates());
+  for (StateId s = 0; s < nrOfStates(); s++)
+    names[s] = to_string(s);
+  vector<FABuilder::IdTransition> transitions;
+  for (StateId s = 0; s < nrOfStates(); s++)
+    for (uint32_t i = rowStart[s]; i < rowStart[s + 1]; i++) {
+      const Transition &t = ts[i];
+      if (t.hi > 255 || t.lo <= (unsigned char)eps) // neither eot nor eps
+        throw domain_error("RangeDFA: range beyond tape symbols");
+      for (WideSymbol sy = t.lo; sy <= t.hi; sy++)
+        transitions.push_back({s, (TapeSymbol)sy, t.dest});
+    } // for
+  FABuilder fab;
+  fab.setStartState(names[start]);
+  for (StateId s = 0; s < nrOfStates(); s++)
+    if (final[s])
+      fab.addFinalState(names[s]);
+  fab.addTransitions(names, std::move(transitions));
+  return std::move(fab).buildDFA();
+} // RangeDFA::dfaOf
+
+// via the CompiledNFA of the ranges as symbol sets, whose subset
+//   construction is a mere renumbering as the automaton is deterministic
+CompiledDFA RangeDFA::compiledOf() const {
+  vector<CompiledNFA::Transition> transitions;
+  transitions.reserve(ts.size());
+  vector<CompiledNFA::StateId> finals;
+  for (StateId s = 0; s < nrOfStates(); s++) {
+    if (final[s])
+      finals.push_back(s);
+    for (uint32_t i = rowStart[s]; i < rowStart[s + 1]; i++) {
+      const Transition &t = ts[i];
+      if (t.hi > 255)
+        throw domain_error("RangeDFA: range beyond bytes");
+      CompiledNFA::SymbolSet label;
+      for (WideSymbol sy = t.lo; sy <= t.hi; sy++)
+        label.set(sy);
+      transitions.push_back({s, label, t.dest});
+    } // for
+  } // for
+  return CompiledDFA(CompiledNFA(nrOfStates(), start, finals, std::move(transitions)));
+} // RangeDFA::compiledOf
+
+
+// end of RangeDelta.cpp
+//======================================================================
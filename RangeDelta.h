@@ -0,0 +1,205 @@
+// RangeDelta.h:                                                   2024
+// ------------
+// Symbolic transitions for large alphabets: transitions are labelled
+// with ranges [lo, hi] of symbols (e.g., Unicode code points) instead
+// of single TapeSymbols, so memory is proportional to the number of
+// ranges, not to the size of the alphabet:
+// *  RangeSet is a set of symbols as sorted, non-overlapping ranges,
+// *  RangeNFA is an NFA on integer states with range and epsilon
+//    transitions, dfaOf is the subset construction which splits the
+//    ranges of each state set minimally (sweep over range bounds),
+// *  RangeDFA stores the sorted, non-overlapping ranges of each state
+//    in compressed sparse rows, next looks up by binary search and
+//    nextOfClass by symbol classes (the elementary intervals between
+//    all range bounds), through the ranges or, opt-in, through a dense
+//    table of states x classes; minimalOf merges adjacent ranges with
+//    equivalent destinations.
+//======================================================================
+
+#pragma once
+#ifndef RangeDelta_h
+#define RangeDelta_h
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+
+class DFA;
+class NFA;
+class CompiledDFA;
+
+
+typedef std::uint32_t WideSymbol;   // e.g., a Unicode code point
+
+struct SymbolRange {
+  WideSymbol lo, hi;                // inclusive bounds, lo <= hi
+}; // SymbolRange
+
+
+class RangeSet final
+        /*OC+*/ : private ObjectCounter<RangeSet> /*+OC*/ {
+
+    std::vector<SymbolRange> rs;    // sorted, non-overlapping, non-adjacent
+
+  public:
+
+    RangeSet() = default;
+    RangeSet(WideSymbol lo, WideSymbol hi) { add(lo, hi); }
+
+    RangeSet(const RangeSet  &rs) = default;
+    RangeSet(      RangeSet &&rs) = default;
+
+    RangeSet &operator=(const RangeSet  &rs) = default;
+    RangeSet &operator=(      RangeSet &&rs) = default;
+
+    ~RangeSet() = default;
+
+    RangeSet &add(WideSymbol lo, WideSymbol hi);
+    RangeSet &add(const RangeSet &other);
+
+    bool contains(WideSymbol sy) const; // binary search
+    bool empty() const { return rs.empty(); }
+
+    const std::vector<SymbolRange> &ranges() const { return rs; }
+
+    RangeSet complementOf(WideSymbol maxSymbol) const; // within [0, maxSymbol]
+
+}; // RangeSet
+
+std::ostream &operator<<(std::ostream &os, const RangeSet &rs);
+
+
+class RangeDFA;
+
+class RangeNFA final
+        /*OC+*/ : private ObjectCounter<RangeNFA> /*+OC*/ {
+
+  public:
+
+    typedef int StateId;
+
+    struct Transition {
+      SymbolRange range;
+      StateId     dest;
+    }; // Transition
+
+  private:
+
+    StateId start = 0;
+    std::vector<bool>                    final;
+    std::vector<std::vector<Transition>> out;    // per state
+    std::vector<std::vector<StateId>>    epsOut; // per state
+
+  public:
+
+    explicit RangeNFA(int nStates = 0);
+    explicit RangeNFA(const NFA &nfa); // consecutive symbols form ranges
+
+    RangeNFA(const RangeNFA  &rNfa) = default;
+    RangeNFA(      RangeNFA &&rNfa) = default;
+
+    ~RangeNFA() = default;
+
+    StateId addState();
+    RangeNFA &setStartState(StateId s);
+    RangeNFA &addFinalState(StateId s);
+    RangeNFA &addTransition(StateId src, WideSymbol lo, WideSymbol hi, StateId dest);
+    RangeNFA &addTransition(StateId src, const RangeSet &rs, StateId dest);
+    RangeNFA &addEpsTransition(StateId src, StateId dest);
+
+    int         nrOfStates() const { return (int)out.size(); }
+    std::size_t nrOfRanges() const;
+
+    StateId startState()       const { return start; }
+    bool    isFinal(StateId s) const { return final[s]; }
+    const std::vector<Transition> &transitionsOf(StateId s) const { return out[s]; }
+    const std::vector<StateId>    &epsDestsOf   (StateId s) const { return epsOut[s]; }
+
+    RangeDFA dfaOf() const;         // subset construction
+
+}; // RangeNFA
+
+
+class RangeDFA final
+        /*OC+*/ : private ObjectCounter<RangeDFA> /*+OC*/ {
+
+  public:
+
+    typedef int StateId;
+    static constexpr StateId undef = -1;
+
+    struct Transition {
+      WideSymbol lo, hi;
+      StateId    dest;
+    }; // Transition
+
+  private:
+
+    StateId start = 0;
+    std::vector<bool>          final;
+    std::vector<std::uint32_t> rowStart;    // CSR index into ts
+    std::vector<Transition>    ts;          // sorted by lo in each row
+
+    std::vector<WideSymbol>    bounds;      // sorted starts of classes
+    std::vector<StateId>       classTable;  // (state, class) -> dest, opt-in
+    int                        byteClass[256]; // class of bytes or -1
+
+    void buildClasses();
+
+    friend class RangeNFA;
+    RangeDFA() = default;
+    RangeDFA(StateId start, std::vector<bool> final,
+             const std::vector<std::vector<Transition>> &rows);
+
+  public:
+
+    RangeDFA(const RangeDFA  &rDfa) = default;
+    RangeDFA(      RangeDFA &&rDfa) = default;
+
+    ~RangeDFA() = default;
+
+    int         nrOfStates()  const { return (int)final.size(); }
+    std::size_t nrOfRanges()  const { return ts.size(); }
+    int         nrOfClasses() const { return (int)bounds.size(); }
+    std::size_t memoryInBytes() const;
+
+    StateId startState()        const { return start; }
+    bool    isFinal(StateId s)  const { return final[s]; }
+
+    StateId next(StateId s, WideSymbol sy) const; // binary search in row
+
+    int classOf(WideSymbol sy) const {        // -1 for symbols without class
+      return sy < 256 ? byteClass[sy] : classOfWide(sy);
+    } // classOf
+    int classOfWide(WideSymbol sy) const;     // binary search in bounds
+
+    StateId nextOfClass(StateId s, int c) const { // see buildClassTable
+      if (c < 0)
+        return undef;
+      return classTable.empty() ? next(s, bounds[c])
+                                : classTable[(size_t)s * bounds.size() + c];
+    } // nextOfClass
+
+    // opt-in: nextOfClass by a dense table instead of binary search, its
+    //   memory is nrOfStates() x nrOfClasses() entries (cf. memoryInBytes)
+    void buildClassTable();
+    bool hasClassTable() const { return !classTable.empty(); }
+
+    bool accepts(const std::vector<WideSymbol> &tape) const;
+    bool accepts(TapeView tape) const;        // bytes as symbols
+
+    RangeDFA minimalOf() const;
+
+    DFA *dfaOf() const; // per symbol DFA, requires symbols < 256 (no eps)
+    CompiledDFA compiledOf() const; // table-driven, requires symbols < 256
+
+}; // RangeDFA
+
+
+#endif
+
+// end of RangeDelta.h
+//======================================================================
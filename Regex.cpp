@@ -0,0 +1,419 @@
+// Regex.cpp:                                                      2024
+// ---------
+// Regex is a parsed regular expression that compiles into a CompiledNFA
+// via the Thompson or the Glushkov construction.
+//======================================================================
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "CompiledNFA.h"
+#include "FragmentArena.h"
+#include "TaggedNFA.h"
+#include "Regex.h"
+
+
+namespace {
+
+  typedef CompiledNFA::SymbolSet SymbolSet;
+  typedef CompiledNFA::StateId   StateId;
+
+  SymbolSet allSymbols() {   // all 256 byte values
+    SymbolSet s;
+    s.set();
+    return s;
+  } // allSymbols
+
+  SymbolSet rangeOf(int lo, int hi) {
+    SymbolSet s;
+    for (int c = lo; c <= hi; c++)
+      s.set(c);
+    return s;
+  } // rangeOf
+
+} // namespace
+
+
+// --- parser, recursive descent ---
+//   alternative = sequence { "|" sequence } .
+//   sequence    = { factor } .
+//   factor      = atom { "*" | "+" | "?" } .
+//   atom        = "(" [ "?:" ] alternative ")" | "[" class "]" | "." | escape
+//               | symbol .
+
+class Regex::Parser final {
+
+    Regex        &re;
+    const string &p;
+    size_t        i = 0;
+
+    [[noreturn]] void error(const string &msg) const {
+      throw invalid_argument("regex \"" + p + "\": " + msg +
+                             " at position " + to_string(i));
+    } // error
+
+    bool atEnd() const { return i >= p.length(); }
+
+    int add(Node::Kind kind, int left = -1, int right = -1,
+            const SymbolSet &syms = SymbolSet()) {
+      re.nodes.push_back({kind, left, right, syms});
+      return (int)re.nodes.size() - 1;
+    } // add
+
+    static SymbolSet symbolOf(char c) {
+      SymbolSet s;
+      s.set((unsigned char)c);
+      return s;
+    } // symbolOf
+
+    static int hexValueOf(char c) {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+      if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+      return -1;
+    } // hexValueOf
+
+    // after the backslash
+    SymbolSet escape() {
+      if (atEnd())
+        error("incomplete escape");
+      const char c = p[i++];
+      SymbolSet s;
+      switch (c) {
+        case 'd': case 'D':
+          s = rangeOf('0', '9');
+          break;
+        case 'w': case 'W':
+          s = rangeOf('a', 'z') | rangeOf('A', 'Z') | rangeOf('0', '9') | symbolOf('_');
+          break;
+        case 's': case 'S':
+          for (char w: {' ', '\t', '\n', '\r', '\f', '\v'})
+            s.set((unsigned char)w);
+          break;
+        case 'n': return symbolOf('\n');
+        case 'r': return symbolOf('\r');
+        case 't': return symbolOf('\t');
+        case 'f': return symbolOf('\f');
+        case 'v': return symbolOf('\v');
+        case 'x': {
+          const int h1 = i     < p.length() ? hexValueOf(p[i])     : -1;
+          const int h2 = i + 1 < p.length() ? hexValueOf(p[i + 1]) : -1;
+          if (h1 < 0 || h2 < 0)
+            error("two hex digits expected");
+          i += 2;
+          return symbolOf((char)(h1 * 16 + h2));
+        } // case
+        default:
+          if (isalnum((unsigned char)c))
+            error(string("unknown escape \\") + c);
+          return symbolOf(c);
+      } // switch
+      return isupper((unsigned char)c) ? allSymbols() & ~s : s;
+    } // escape
+
+    // after the [
+    SymbolSet charClass() {
+      const bool negated = !atEnd() && p[i] == '^';
+      if (negated)
+        i++;
+      SymbolSet s;
+      bool first = true;
+      for (;;) {
+        if (atEnd())
+          error("missing ]");
+        if (p[i] == ']' && !first)
+          break;
+        first = false;
+        SymbolSet lo = (p[i] == '\\') ? (i++, escape()) : symbolOf(p[i++]);
+        if (lo.count() == 1 && i + 1 < p.length() && p[i] == '-' && p[i + 1] != ']') {
+          i++;                 // range lo-hi
+          const SymbolSet hi = (p[i] == '\\') ? (i++, escape()) : symbolOf(p[i++]);
+          int l = 0, h = 0;
+          while (!lo[l]) l++;
+          while (!hi[h]) h++;
+          if (hi.count() != 1 || h < l)
+            error("invalid range");
+          s |= rangeOf(l, h);
+        } else
+          s |= lo;
+      } // for
+      i++;                     // ]
+      return negated ? allSymbols() & ~s : s;
+    } // charClass
+
+    int atom() {
+      SymbolSet s;
+      switch (p[i]) {
+        case '(': {
+          i++;
+          const bool capturing = p.compare(i, 2, "?:") != 0;
+          const int index = capturing ? ++re.nGroups : 0; // in order of (
+          if (!capturing)
+            i += 2;
+          const int n = alternative();
+          if (atEnd() || p[i] != ')')
+            error("missing )");
+          i++;
+          return capturing ? add(Node::group, n, index) : n;
+        } // case
+        case '*': case '+': case '?':
+          error("nothing to repeat");
+        case '[':
+          i++;
+          s = charClass();
+          break;
+        case '.':
+          i++;
+          s = allSymbols();
+          s.reset((unsigned char)'\n');
+          break;
+        case '\\':
+          i++;
+          s = escape();
+          break;
+        default:
+          s = symbolOf(p[i++]);
+      } // switch
+      re.nPositions++;
+      return add(Node::symbols, -1, -1, s);
+    } // atom
+
+    int factor() {
+      int n = atom();
+      while (!atEnd() && (p[i] == '*' || p[i] == '+' || p[i] == '?')) {
+        const Node::Kind k = p[i] == '*' ? Node::star :
+                             p[i] == '+' ? Node::plus : Node::opt;
+        i++;
+        n = add(k, n);
+      } // while
+      return n;
+    } // factor
+
+    int sequence() {
+      int n = -1;
+      while (!atEnd() && p[i] != '|' && p[i] != ')') {
+        const int f = factor();
+        n = n < 0 ? f : add(Node::concat, n, f);
+      } // while
+      return n < 0 ? add(Node::empty) : n;
+    } // sequence
+
+    int alternative() {
+      int n = sequence();
+      while (!atEnd() && p[i] == '|') {
+        i++;
+        const int r = sequence();
+        n = add(Node::alt, n, r);
+      } // while
+      return n;
+    } // alternative
+
+  public:
+
+    Parser(Regex &re): re(re), p(re.pat) {}
+
+    int parse() {
+      const int n = alternative();
+      if (!atEnd())
+        error("unmatched )");
+      return n;
+    } // parse
+
+}; // Regex::Parser
+
+
+Regex::Regex(const string &pattern)
+: pat(pattern) {
+  root = Parser(*this).parse();
+} // Regex::Regex
+
+
+// --- Thompson construction ---
+
+CompiledNFA Regex::thompsonOf() const {
+  typedef FragmentArena::Fragment Fragment;
+  FragmentArena arena;
+  arena.reserve(2 * nodes.size(), 3 * nodes.size());
+
+  auto build = [&](auto &self, int n) -> Fragment {
+    const Node &node = nodes[n];
+    switch (node.kind) {
+      case Node::empty:
+        return arena.empty();
+      case Node::symbols:
+        return arena.symbols(node.syms);
+      case Node::concat: {
+        const Fragment a = self(self, node.left);
+        return arena.concat(a, self(self, node.right));
+      } // case
+      case Node::alt: {
+        const Fragment a = self(self, node.left);
+        return arena.alternate(a, self(self, node.right));
+      } // case
+      case Node::star:
+        return arena.star(self(self, node.left));
+      case Node::plus:
+        return arena.plus(self(self, node.left));
+      case Node::group:
+        return self(self, node.left);
+      default:                 // opt
+        return arena.optional(self(self, node.left));
+    } // switch
+  }; // build
+
+  return arena.compiledOf(build(build, root));
+} // Regex::thompsonOf
+
+
+// --- Glushkov construction ---
+
+CompiledNFA Regex::glushkovOf() const {
+  struct Info {
+    bool nullable;
+    vector<StateId> first, last; // positions
+  }; // Info
+  vector<const SymbolSet *> symsOf(1, nullptr); // position -> symbols
+  vector<vector<StateId>> follow(nPositions + 1);
+
+  auto append = [](vector<StateId> &to, const vector<StateId> &from) {
+    to.insert(to.end(), from.begin(), from.end());
+  }; // append
+  auto addFollow = [&](const vector<StateId> &from, const vector<StateId> &to) {
+    for (StateId p: from)
+      append(follow[p], to);
+  }; // addFollow
+
+  auto info = [&](auto &self, int n) -> Info {
+    const Node &node = nodes[n];
+    switch (node.kind) {
+      case Node::empty:
+        return {true, {}, {}};
+      case Node::symbols: {
+        const StateId p = (StateId)symsOf.size(); // positions left to right
+        symsOf.push_back(&node.syms);
+        return {false, {p}, {p}};
+      } // case
+      case Node::concat: {
+        Info a = self(self, node.left), b = self(self, node.right);
+        addFollow(a.last, b.first);
+        if (a.nullable)
+          append(a.first, b.first);
+        if (b.nullable)
+          append(b.last, a.last);
+        return {a.nullable && b.nullable, std::move(a.first), std::move(b.last)};
+      } // case
+      case Node::alt: {
+        Info a = self(self, node.left), b = self(self, node.right);
+        append(a.first, b.first);
+        append(a.last, b.last);
+        a.nullable = a.nullable || b.nullable;
+        return a;
+      } // case
+      case Node::group:
+        return self(self, node.left);
+      default: {               // star, plus, opt
+        Info a = self(self, node.left);
+        if (node.kind != Node::opt)
+          addFollow(a.last, a.first);
+        a.nullable = a.nullable || node.kind != Node::plus;
+        return a;
+      } // default
+    } // switch
+  }; // info
+
+  const Info r = info(info, root);
+
+  // state 0 is the start, state p (1 .. nPositions) is entered on symsOf[p]
+  vector<CompiledNFA::Transition> ts;
+  auto addTransitions = [&](StateId src, vector<StateId> dests) {
+    sort(dests.begin(), dests.end());
+    dests.erase(unique(dests.begin(), dests.end()), dests.end());
+    for (StateId d: dests)
+      if (symsOf[d]->any())
+        ts.push_back({src, *symsOf[d], d});
+  }; // addTransitions
+  addTransitions(0, r.first);
+  for (StateId p = 1; p <= nPositions; p++)
+    addTransitions(p, std::move(follow[p]));
+  vector<StateId> finals(r.last);
+  if (r.nullable)
+    finals.push_back(0);
+  return CompiledNFA(nPositions + 1, 0, finals, std::move(ts));
+} // Regex::glushkovOf
+
+
+// --- tagged Thompson construction ---
+
+// fragments with one start and one end state, the edges of each state
+//   in the order of their priority: the left alternative first, for
+//   *, + and ? the next iteration before the exit, group g is enclosed
+//   by tag 2 (g - 1) (open) and tag 2 (g - 1) + 1 (close)
+TaggedNFA Regex::taggedOf() const {
+  typedef TaggedNFA::Edge Edge;
+  vector<Edge> edges;
+  StateId nStates = 0;
+  auto epsilon = [&edges](StateId src, StateId dest, int tag = TaggedNFA::noTag) {
+    edges.push_back({src, SymbolSet(), tag, dest});
+  }; // epsilon
+
+  auto build = [&](auto &self, int n) -> pair<StateId, StateId> {
+    const Node &node = nodes[n];
+    if (node.kind == Node::concat) {
+      const auto a = self(self, node.left), b = self(self, node.right);
+      epsilon(a.second, b.first);
+      return {a.first, b.second};
+    } // if
+    const StateId s = nStates++, e = nStates++;
+    switch (node.kind) {
+      case Node::empty:
+        epsilon(s, e);
+        break;
+      case Node::symbols:
+        edges.push_back({s, node.syms, TaggedNFA::noTag, e});
+        break;
+      case Node::alt: {
+        const auto a = self(self, node.left), b = self(self, node.right);
+        epsilon(s, a.first);
+        epsilon(s, b.first);
+        epsilon(a.second, e);
+        epsilon(b.second, e);
+        break;
+      } // case
+      case Node::group: {
+        const auto a = self(self, node.left);
+        epsilon(s, a.first, 2 * (node.right - 1));
+        epsilon(a.second, e, 2 * (node.right - 1) + 1);
+        break;
+      } // case
+      default: {               // star, plus, opt
+        const auto a = self(self, node.left);
+        if (node.kind == Node::plus) {
+          epsilon(s, a.first);
+          epsilon(a.second, a.first);
+        } else {
+          epsilon(s, a.first);
+          epsilon(s, e);
+          if (node.kind == Node::star)
+            epsilon(a.second, a.first);
+        } // if
+        epsilon(a.second, e);
+        break;
+      } // default
+    } // switch
+    return {s, e};
+  }; // build
+
+  const auto r = build(build, root);
+  return TaggedNFA(nStates, 2 * nGroups, r.first, r.second, std::move(edges));
+} // Regex::taggedOf
+
+
+// end of Regex.cpp
+//======================================================================
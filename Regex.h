@@ -0,0 +1,81 @@
+// Regex.h:                                                        2024
+// -------
+// Regex is a parsed regular expression that compiles into a CompiledNFA
+// on integer state ids, without any state names:
+// *  syntax: concatenation, alternative |, postfix *, + and ?, groups
+//    ( ) that capture and (?: ) that do not, character classes [abc],
+//    [a-z], [^...], . (any symbol but newline), escapes \d \w \s \D
+//    \W \S \n \r \t \f \v \xHH and \c for any other non-alphanumeric
+//    c, all 256 byte values are symbols (e.g., \x00 and \x01), so
+//    patterns for binary data are possible,
+// *  thompsonOf: Thompson construction (with FragmentArena), epsilon
+//    NFA with about two states per operator and symbol,
+// *  glushkovOf: Glushkov (position) construction, epsilon-free NFA
+//    with one state per position (symbol occurrence) plus the start,
+// *  taggedOf: Thompson construction with tags for the capture groups
+//    and edges in priority order (leftmost alternative, greedy
+//    repetition), for submatch extraction (cf. TaggedNFA).
+// Invalid patterns cause an invalid_argument exception.
+//======================================================================
+
+#pragma once
+#ifndef Regex_h
+#define Regex_h
+
+#include <string>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "CompiledNFA.h"
+
+class TaggedNFA;
+
+
+class Regex final
+        /*OC+*/ : private ObjectCounter<Regex> /*+OC*/ {
+
+  public:
+
+    typedef CompiledNFA::SymbolSet SymbolSet;
+
+  private:
+
+    struct Node {
+      enum Kind { empty, symbols, concat, alt, star, plus, opt, group } kind;
+      int left, right;                // children, -1 if absent, group: index
+      SymbolSet syms;                 // for symbols only
+    }; // Node
+
+    class Parser;
+
+    std::string       pat;
+    std::vector<Node> nodes;          // syntax tree, children first
+    int               root;
+    int               nPositions = 0;
+    int               nGroups    = 0; // capturing, numbered 1, 2, ...
+
+  public:
+
+    explicit Regex(const std::string &pattern);
+
+    Regex(const Regex  &r) = default;
+    Regex(      Regex &&r) = default;
+
+    ~Regex() = default;
+
+    const std::string &pattern() const { return pat; }
+
+    int nrOfPositions() const { return nPositions; }
+    int nrOfGroups()    const { return nGroups;    }
+
+    CompiledNFA thompsonOf() const;
+    CompiledNFA glushkovOf() const;
+    TaggedNFA   taggedOf()   const;
+
+}; // Regex
+
+
+#endif
+
+// end of Regex.h
+//======================================================================
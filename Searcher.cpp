@@ -0,0 +1,308 @@
+// Searcher.cpp:                                                   2024
+// ------------
+// Unanchored search with a forward DFA with .* prefix for the end of
+// the leftmost match and a reverse DFA for its start.
+//======================================================================
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "Hashing.h"
+#include "TapeStuff.h"
+#include "DFA.h"
+#include "CompiledNFA.h"
+#include "CompiledDFA.h"
+#include "Searcher.h"
+
+
+namespace {
+
+  typedef CompiledNFA::StateId NState;
+  typedef CompiledNFA::SymbolSet SymbolSet;
+
+  constexpr int maxStates = 100000;      // of the forward DFA
+
+  // markers in configurations, see below
+  constexpr NState endOfGroup = -1, prefix = -2, matched = -3;
+
+  struct ConfigHash {
+    size_t operator()(const vector<NState> &v) const {
+      return (size_t)fnv1a64(v.data(), v.size() * sizeof(v[0]));
+    } // operator()
+  }; // ConfigHash
+
+  vector<SymbolSet> symbolsOfClasses(const CompiledNFA &nfa) {
+    vector<SymbolSet> symbols(nfa.nrOfClasses());
+    for (int b = 0; b < 256; b++)
+      symbols[nfa.classOf((TapeSymbol)b)].set(b);
+    return symbols;
+  } // symbolsOfClasses
+
+  // deterministic transitions (dests[s * nClasses + c], undef for none)
+  //   as CompiledNFA, one transition per destination and state
+  CompiledDFA compiledOf(int nStates, const vector<CompiledDFA::StateId> &dests,
+                         const vector<SymbolSet> &symbols,
+                         const vector<NState> &finals) {
+    const int nClasses = (int)symbols.size();
+    vector<CompiledNFA::Transition> transitions;
+    for (int s = 0; s < nStates; s++) {
+      const size_t first = transitions.size();
+      for (int c = 0; c < nClasses; c++) {
+        const NState d = dests[(size_t)s * nClasses + c];
+        if (d == CompiledDFA::undef)
+          continue;
+        size_t i = first;
+        while (i < transitions.size() && transitions[i].dest != d)
+          i++;
+        if (i == transitions.size())
+          transitions.push_back({s, SymbolSet(), d});
+        transitions[i].label |= symbols[c];
+      } // for
+    } // for
+    return CompiledDFA(CompiledNFA(nStates, 0, finals, std::move(transitions)));
+  } // compiledOf
+
+
+  // configurations of the forward DFA: groups of NFA states (sorted),
+  //   each closed by endOfGroup, in the order of the start positions of
+  //   their threads, then prefix while new threads start at each
+  //   position, then matched if the configuration is final
+  class ForwardBuilder final {
+
+      const CompiledNFA   &nfa;
+      Searcher::MatchKind  kind;
+      vector<int>    mark;               // stamp of the current step
+      int            stamp = 0;
+      vector<NState> stack;
+
+      // s and its epsilon closure, unless already in an earlier group
+      void addClosure(NState s, vector<NState> &group) {
+        if (mark[s] == stamp)
+          return;
+        mark[s] = stamp;
+        stack.push_back(s);
+        while (!stack.empty()) {
+          const NState t = stack.back();
+          stack.pop_back();
+          group.push_back(t);
+          const auto eps = nfa.epsDestsOf(t);
+          for (const NState *d = eps.first; d != eps.second; d++)
+            if (mark[*d] != stamp) {
+              mark[*d] = stamp;
+              stack.push_back(*d);
+            } // if
+        } // while
+      } // addClosure
+
+      // groups of the leftmost final group on are dropped (first) or
+      //   the ones right of it (longest), the prefix is dropped too
+      void settle(vector<vector<NState>> &groups, bool &hasPrefix, bool &isFinal) const {
+        isFinal = false;
+        for (size_t g = 0; g < groups.size(); g++)
+          if (any_of(groups[g].begin(), groups[g].end(),
+                     [this](NState s) { return nfa.isFinal(s); })) {
+            groups.resize(kind == Searcher::MatchKind::leftmostFirst ? g : g + 1);
+            hasPrefix = false;
+            isFinal = true;
+            break;
+          } // if
+      } // settle
+
+      static vector<NState> configOf(const vector<vector<NState>> &groups,
+                                     bool hasPrefix, bool isFinal) {
+        vector<NState> config;
+        for (const auto &group: groups) {
+          config.insert(config.end(), group.begin(), group.end());
+          config.push_back(endOfGroup);
+        } // for
+        if (hasPrefix)
+          config.push_back(prefix);
+        if (isFinal)
+          config.push_back(matched);
+        return config;
+      } // configOf
+
+    public:
+
+      ForwardBuilder(const CompiledNFA &nfa, Searcher::MatchKind kind)
+      : nfa(nfa), kind(kind), mark(nfa.nrOfStates(), 0) {
+      } // ForwardBuilder
+
+      vector<NState> initial() {
+        stamp++;
+        vector<vector<NState>> groups(1);
+        addClosure(nfa.startState(), groups[0]);
+        sort(groups[0].begin(), groups[0].end());
+        bool hasPrefix = true, isFinal;
+        settle(groups, hasPrefix, isFinal);
+        return configOf(groups, hasPrefix, isFinal);
+      } // initial
+
+      // empty for the dead configuration
+      vector<NState> step(const vector<NState> &config, int c) {
+        stamp++;
+        vector<vector<NState>> groups;
+        vector<NState> group;
+        bool hasPrefix = false, isFinal;
+        for (NState s: config) {
+          if (s == endOfGroup) {
+            if (!group.empty()) {
+              sort(group.begin(), group.end());
+              groups.push_back(std::move(group));
+              group.clear();
+            } // if
+          } else if (s == prefix)
+            hasPrefix = true;
+          else if (s >= 0) {
+            const auto ds = nfa.destsOf(s, c);
+            for (const NState *d = ds.first; d != ds.second; d++)
+              addClosure(*d, group);
+          } // if
+        } // for
+        if (hasPrefix) {         // threads starting after this symbol
+          addClosure(nfa.startState(), group);
+          if (!group.empty()) {
+            sort(group.begin(), group.end());
+            groups.push_back(std::move(group));
+          } // if
+        } // if
+        settle(groups, hasPrefix, isFinal);
+        if (groups.empty() && !hasPrefix && !isFinal)
+          return vector<NState>();
+        return configOf(groups, hasPrefix, isFinal);
+      } // step
+
+  }; // ForwardBuilder
+
+  CompiledDFA forwardOf(const CompiledNFA &nfa, Searcher::MatchKind kind) {
+    const int nClasses = nfa.nrOfClasses();
+    ForwardBuilder fb(nfa, kind);
+    unordered_map<vector<NState>, CompiledDFA::StateId, ConfigHash> ids;
+    vector<vector<NState>> configs{fb.initial()};
+    ids.emplace(configs[0], 0);
+    vector<CompiledDFA::StateId> dests;
+    vector<NState> finals;
+    for (size_t i = 0; i < configs.size(); i++) {
+      if (configs[i].back() == matched)
+        finals.push_back((NState)i);
+      for (int c = 0; c < nClasses; c++) {
+        vector<NState> next = fb.step(configs[i], c);
+        if (next.empty()) {
+          dests.push_back(CompiledDFA::undef);
+          continue;
+        } // if
+        const auto it = ids.emplace(next, (CompiledDFA::StateId)configs.size());
+        if (it.second) {
+          if ((int)configs.size() == maxStates)
+            throw length_error("Searcher: forward DFA with more than " +
+                               to_string(maxStates) + " states");
+          configs.push_back(std::move(next));
+        } // if
+        dests.push_back(it.first->second);
+      } // for
+    } // for
+    return compiledOf((int)configs.size(), dests, symbolsOfClasses(nfa), finals);
+  } // forwardOf
+
+  // subset construction of the reversed NFA: a new start state with
+  //   epsilon transitions to the former final states
+  CompiledDFA reverseOf(const CompiledNFA &nfa) {
+    const int n = nfa.nrOfStates();
+    const vector<SymbolSet> symbols = symbolsOfClasses(nfa);
+    vector<CompiledNFA::Transition> transitions;
+    for (NState s = 0; s < n; s++) {
+      for (int c = 0; c < nfa.nrOfClasses(); c++) {
+        const auto ds = nfa.destsOf(s, c);
+        for (const NState *d = ds.first; d != ds.second; d++)
+          transitions.push_back({*d, symbols[c], s});
+      } // for
+      const auto eps = nfa.epsDestsOf(s);
+      for (const NState *d = eps.first; d != eps.second; d++)
+        transitions.push_back({*d, SymbolSet(), s});
+      if (nfa.isFinal(s))
+        transitions.push_back({n, SymbolSet(), s});
+    } // for
+    return CompiledDFA(CompiledNFA(n + 1, n, {nfa.startState()}, std::move(transitions)));
+  } // reverseOf
+
+} // namespace
+
+
+Searcher::Searcher(const CompiledNFA &pattern, MatchKind kind)
+: kind(kind), forward(forwardOf(pattern, kind)), reverse(reverseOf(pattern)) {
+  const CompiledDFA::StateId start = forward.startState();
+  nStartEscapes = forward.isFinal(start) ? -1 : forward.escapesOf(start, startEscapes);
+} // Searcher::Searcher
+
+Searcher::Searcher(const DFA &pattern, MatchKind kind)
+: Searcher(CompiledNFA(pattern, false), kind) {
+} // Searcher::Searcher
+
+
+Searcher::Match Searcher::find(TapeView text, size_t from) const {
+  if (from > text.size())
+    return {npos, npos};
+  const unsigned char *first = reinterpret_cast<const unsigned char *>(text.data()),
+                      *end   = first + text.size(), *p = first + from;
+
+  // 1. forward to the end of the leftmost match, i.e., until dead
+  const CompiledDFA::StateId start = forward.startState();
+  CompiledDFA::StateId s = start;
+  size_t matchEnd = forward.isFinal(s) ? from : npos;
+  while (p != end) {
+    if (s == start && nStartEscapes >= 0) {  // skip to the next escape
+      if (nStartEscapes == 0)
+        break;
+      const unsigned char *q = nStartEscapes == 1
+        ? static_cast<const unsigned char *>(memchr(p, startEscapes[0], end - p))
+        : find_if(p, end, [this](unsigned char b) {
+            return b == startEscapes[0] || b == startEscapes[1] ||
+                   b == startEscapes[nStartEscapes - 1];
+          });
+      if (q == nullptr || q == end)
+        break;
+      p = q;
+    } // if
+    s = forward.next(s, (TapeSymbol)*p++);
+    if (s == CompiledDFA::undef)
+      break;
+    if (forward.isFinal(s))
+      matchEnd = p - first;
+  } // while
+  if (matchEnd == npos)
+    return {npos, npos};
+
+  // 2. backward from the end to the leftmost start of a match
+  CompiledDFA::StateId r = reverse.startState();
+  size_t matchStart = reverse.isFinal(r) ? matchEnd : npos;
+  for (const unsigned char *q = first + matchEnd; q != first + from; ) {
+    r = reverse.next(r, (TapeSymbol)*--q);
+    if (r == CompiledDFA::undef)
+      break;
+    if (reverse.isFinal(r))
+      matchStart = q - first;
+  } // for
+  return {matchStart, matchEnd};
+} // Searcher::find
+
+vector<Searcher::Match> Searcher::findAll(TapeView text) const {
+  vector<Match> matches;
+  size_t from = 0;
+  Match m;
+  while ((m = find(text, from)).start != npos) {
+    matches.push_back(m);
+    from = m.end > m.start ? m.end : m.end + 1;
+  } // while
+  return matches;
+} // Searcher::findAll
+
+
+// end of Searcher.cpp
+//======================================================================
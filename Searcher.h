@@ -0,0 +1,92 @@
+// Searcher.h:                                                     2024
+// ----------
+// Searcher finds matches of a pattern (CompiledNFA, e.g., of a Regex,
+// or DFA) anywhere in a text, whereas all automata accept whole tapes
+// only, e.g., for scanning log files:
+// *  the forward DFA is built with an implicit .* prefix (on all 256
+//    bytes): its states are groups of NFA states, one per start
+//    position of the threads still alive, ordered leftmost first, and
+//    a mark for "new threads still start"; as soon as one group
+//    reaches a final state, the groups to its right and the prefix are
+//    dropped, so the forward run stops at the end of the leftmost match,
+// *  the reverse DFA is the subset construction of the reversed NFA,
+//    it runs backwards from that end and its last final state is the
+//    leftmost start (so the forward DFA needs no positions at all),
+// *  MatchKind::leftmostLongest (POSIX) extends the leftmost match to
+//    its longest end, MatchKind::leftmostFirst ends it at its first end
+//    (automata have no priorities of alternatives, so this is the end
+//    a scan reaches first),
+// *  findAll reports non-overlapping matches from left to right, the
+//    forward run skips bytes in its start state with memchr if the
+//    start state is accelerated (and not final).
+//======================================================================
+
+#pragma once
+#ifndef Searcher_h
+#define Searcher_h
+
+#include <cstddef>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "CompiledDFA.h"
+
+class DFA;
+class CompiledNFA;
+
+
+class Searcher final
+        /*OC+*/ : private ObjectCounter<Searcher> /*+OC*/ {
+
+  public:
+
+    enum class MatchKind { leftmostFirst, leftmostLongest };
+
+    static constexpr std::size_t npos = CompiledDFA::npos;
+
+    struct Match {
+      std::size_t start, end;         // [start, end) in the text
+    }; // Match
+
+  private:
+
+    MatchKind     kind;
+    CompiledDFA   forward;            // .* pattern, leftmost semantics
+    CompiledDFA   reverse;            // reversed pattern, anchored
+    int           nStartEscapes;      // of forward's non-final start or -1
+    unsigned char startEscapes[3];
+
+  public:
+
+    // throws length_error if the forward DFA gets too large
+    explicit Searcher(const CompiledNFA &pattern,
+                      MatchKind kind = MatchKind::leftmostLongest);
+    explicit Searcher(const DFA &pattern,
+                      MatchKind kind = MatchKind::leftmostLongest);
+
+    Searcher(const Searcher  &s) = default;
+    Searcher(      Searcher &&s) = default;
+
+    ~Searcher() = default;
+
+    MatchKind          kindOf()     const { return kind; }
+    const CompiledDFA &forwardDfa() const { return forward; }
+    const CompiledDFA &reverseDfa() const { return reverse; }
+
+    // the leftmost match starting at or after from, start == npos if none
+    Match find(TapeView text, std::size_t from = 0) const;
+
+    // non-overlapping, an empty match is followed by a search one
+    //   byte further on
+    std::vector<Match> findAll(TapeView text) const;
+
+    bool isMatch(TapeView text) const { return forward.scan(text) != npos; }
+
+}; // Searcher
+
+
+#endif
+
+// end of Searcher.h
+//======================================================================
@@ -0,0 +1,207 @@
+// ShuffleDFA.cpp:                                                 2024
+// --------------
+// ShuffleDFA runs small DFAs on vectors of states with byte shuffles
+// (SSSE3 or AVX2, selected at run time) or with a scalar fallback.
+//======================================================================
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "CompiledDFA.h"
+#include "ShuffleDFA.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SHUFFLE_X86
+#include <immintrin.h>
+#endif
+
+
+ShuffleDFA::Engine ShuffleDFA::bestEngine() {
+#ifdef SHUFFLE_X86
+  static const Engine best = __builtin_cpu_supports("avx2")  ? Engine::avx2  :
+                             __builtin_cpu_supports("ssse3") ? Engine::ssse3 :
+                                                               Engine::scalar;
+  return best;
+#else
+  return Engine::scalar;
+#endif
+} // ShuffleDFA::bestEngine
+
+const char *ShuffleDFA::nameOf(Engine e) {
+  switch (e) {
+    case Engine::ssse3: return "ssse3";
+    case Engine::avx2:  return "avx2";
+    default:            return "scalar";
+  } // switch
+} // ShuffleDFA::nameOf
+
+
+ShuffleDFA::ShuffleDFA(const CompiledDFA &cDfa, Engine preferred)
+: nStates(cDfa.nrOfStates()), dead(-1), start((StateId)cDfa.startState()),
+  finalBits(0), columns(cDfa.nrOfClasses()) {
+  for (int c = 0; c < 256; c++)
+    cls[c] = (unsigned char)cDfa.classOf((TapeSymbol)c);
+  vector<int> repOf(cDfa.nrOfClasses(), -1);   // representative symbols
+  for (int c = 255; c >= 0; c--)
+    repOf[cls[c]] = c;
+  for (int s = 0; s < cDfa.nrOfStates(); s++)
+    for (int c = 0; c < cDfa.nrOfClasses(); c++)
+      if (repOf[c] < 0 || cDfa.next(s, (TapeSymbol)repOf[c]) == CompiledDFA::undef)
+        dead = nStates;      // one dead state for all undefined transitions
+  if (dead >= 0)
+    nStates++;
+  if (nStates > maxStates)
+    throw length_error("ShuffleDFA: more than " + to_string(maxStates) + " states");
+
+  for (int s = 0; s < cDfa.nrOfStates(); s++)
+    if (cDfa.isFinal(s))
+      finalBits |= (uint32_t)1 << s;
+  for (int c = 0; c < cDfa.nrOfClasses(); c++) {
+    Column &col = columns[c];
+    fill(begin(col.dest), end(col.dest), (StateId)0); // unused states
+    for (int s = 0; s < nStates; s++) {
+      const CompiledDFA::StateId d = (s == dead || repOf[c] < 0) ?
+                                     CompiledDFA::undef : cDfa.next(s, (TapeSymbol)repOf[c]);
+      col.dest[s] = (StateId)(d == CompiledDFA::undef ? dead : d);
+    } // for
+  } // for
+
+  const Engine best = bestEngine();
+  if (nStates <= 16 && preferred != Engine::scalar && best != Engine::scalar)
+    eng = Engine::ssse3;     // one 128 bit shuffle is enough
+  else if (preferred == Engine::avx2 && best == Engine::avx2)
+    eng = Engine::avx2;
+  else
+    eng = Engine::scalar;
+} // ShuffleDFA::ShuffleDFA
+
+
+ShuffleDFA::TransitionMap ShuffleDFA::identityMap() const {
+  TransitionMap m;
+  for (int s = 0; s < maxStates; s++)
+    m.dest[s] = (StateId)(s < nStates ? s : 0);
+  return m;
+} // ShuffleDFA::identityMap
+
+ShuffleDFA::TransitionMap ShuffleDFA::composedOf(const TransitionMap &first,
+                                                 const TransitionMap &second) {
+  TransitionMap m;
+  for (int s = 0; s < maxStates; s++)
+    m.dest[s] = second.dest[first.dest[s] & (maxStates - 1)];
+  return m;
+} // ShuffleDFA::composedOf
+
+
+ShuffleDFA::TransitionMap ShuffleDFA::mapOf(TapeView chunk) const {
+  switch (eng) {
+    case Engine::ssse3: return mapOfSsse3(chunk);
+    case Engine::avx2:  return mapOfAvx2 (chunk);
+    default:            return mapOfScalar(chunk);
+  } // switch
+} // ShuffleDFA::mapOf
+
+ShuffleDFA::TransitionMap ShuffleDFA::mapOfScalar(TapeView chunk) const {
+  TransitionMap m = identityMap();
+  for (int s = 0; s < nStates; s++) {
+    StateId d = (StateId)s;
+    for (unsigned char b: chunk)
+      d = columns[cls[b]].dest[d];
+    m.dest[s] = d;
+  } // for
+  return m;
+} // ShuffleDFA::mapOfScalar
+
+#ifdef SHUFFLE_X86
+
+// v[s] is the state reached from s so far, the column of the next
+//   symbol is the table of the shuffle and v its indices
+__attribute__((target("ssse3")))
+ShuffleDFA::TransitionMap ShuffleDFA::mapOfSsse3(TapeView chunk) const {
+  const TransitionMap id = identityMap();
+  __m128i v = _mm_load_si128((const __m128i *)id.dest);
+  const Column *cols = columns.data();
+  const unsigned char *p   = (const unsigned char *)chunk.data(),
+                      *end = p + chunk.size();
+  for (; p != end; p++)
+    v = _mm_shuffle_epi8(_mm_load_si128((const __m128i *)cols[cls[*p]].dest), v);
+  TransitionMap m = id;
+  _mm_store_si128((__m128i *)m.dest, v);
+  return m;
+} // ShuffleDFA::mapOfSsse3
+
+// 32 states: vpshufb shuffles within 128 bit lanes only, so states
+//   0 .. 15 and 16 .. 31 are looked up in both lanes and bit 4 of the
+//   index (shifted to bit 7) selects the result
+__attribute__((target("avx2")))
+ShuffleDFA::TransitionMap ShuffleDFA::mapOfAvx2(TapeView chunk) const {
+  const TransitionMap id = identityMap();
+  __m256i v = _mm256_load_si256((const __m256i *)id.dest);
+  const Column *cols = columns.data();
+  const unsigned char *p   = (const unsigned char *)chunk.data(),
+                      *end = p + chunk.size();
+  for (; p != end; p++) {
+    const StateId *col = cols[cls[*p]].dest;
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)col));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)(col + 16)));
+    v = _mm256_blendv_epi8(_mm256_shuffle_epi8(lo, v), _mm256_shuffle_epi8(hi, v),
+                           _mm256_slli_epi16(v, 3));
+  } // for
+  TransitionMap m;
+  _mm256_store_si256((__m256i *)m.dest, v);
+  return m;
+} // ShuffleDFA::mapOfAvx2
+
+#else
+
+ShuffleDFA::TransitionMap ShuffleDFA::mapOfSsse3(TapeView chunk) const {
+  return mapOfScalar(chunk);
+} // ShuffleDFA::mapOfSsse3
+
+ShuffleDFA::TransitionMap ShuffleDFA::mapOfAvx2(TapeView chunk) const {
+  return mapOfScalar(chunk);
+} // ShuffleDFA::mapOfAvx2
+
+#endif
+
+
+// blocks of the tape are mapped, so a dead state ends the scan early
+bool ShuffleDFA::accepts(TapeView tape) const {
+  constexpr size_t blockSize = 4096;
+  StateId s = start;
+  for (size_t i = 0; i < tape.size() && s != dead; i += blockSize) {
+    const TapeView block = tape.substr(i, blockSize);
+    if (eng == Engine::scalar)       // one state only
+      for (unsigned char b: block)
+        s = columns[cls[b]].dest[s];
+    else
+      s = mapOf(block).dest[s];
+  } // for
+  return isFinal(s);
+} // ShuffleDFA::accepts
+
+bool ShuffleDFA::acceptsParallel(TapeView tape, int nThreads) const {
+  const size_t chunkSize = (tape.size() + nThreads - 1) / max(nThreads, 1);
+  if (nThreads <= 1 || chunkSize < 4096)
+    return accepts(tape);
+  vector<TransitionMap> maps(nThreads);
+  vector<thread> tv;
+  for (int i = 0; i < nThreads; i++)
+    tv.emplace_back([&, i]() {
+      maps[i] = mapOf(tape.substr(min(i * chunkSize, tape.size()), chunkSize));
+    });
+  for (thread &t: tv)
+    t.join();
+  StateId s = start;
+  for (const TransitionMap &m: maps)
+    s = m.dest[s];
+  return isFinal(s);
+} // ShuffleDFA::acceptsParallel
+
+
+// end of ShuffleDFA.cpp
+//======================================================================
@@ -0,0 +1,98 @@
+// ShuffleDFA.h:                                                   2024
+// ------------
+// ShuffleDFA runs small DFAs (up to 16 states with SSSE3, up to 32
+// states with AVX2, the implicit dead state included) on vectors of
+// states: one byte register holds the current state for each possible
+// start state, and one shuffle (pshufb) with the column of the symbol
+// advances all of them at once:
+// *  mapOf computes the transition map of a chunk, i.e., the state
+//    reached from each state, so the loop-carried dependency is one
+//    shuffle (no dependent table load as in CompiledDFA::accepts),
+// *  maps of consecutive chunks compose, so acceptsParallel scans the
+//    chunks of one tape in several threads and composes the maps,
+// *  the engine is selected at run time (cpuid), without SSSE3 (e.g.,
+//    on other architectures) a scalar engine computes the same maps.
+//======================================================================
+
+#pragma once
+#ifndef ShuffleDFA_h
+#define ShuffleDFA_h
+
+#include <cstdint>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+
+class CompiledDFA;
+
+
+class ShuffleDFA final
+        /*OC+*/ : private ObjectCounter<ShuffleDFA> /*+OC*/ {
+
+  public:
+
+    typedef std::uint8_t StateId;
+    static constexpr int maxStates = 32;
+
+    enum class Engine { scalar, ssse3, avx2 };
+
+    struct TransitionMap {
+      alignas(32) StateId dest[maxStates]; // dest[s] for each state s
+    }; // TransitionMap
+
+  private:
+
+    struct Column {                        // dest. for each state
+      alignas(32) StateId dest[maxStates];
+    }; // Column
+
+    int nStates;                           // incl. dead state, if any
+    int dead;                              // -1 if there is none
+    StateId start;
+    std::uint32_t finalBits;
+    unsigned char cls[256];                // symbol -> column
+    std::vector<Column> columns;
+    Engine eng;
+
+    TransitionMap mapOfScalar(TapeView chunk) const;
+    TransitionMap mapOfSsse3 (TapeView chunk) const;
+    TransitionMap mapOfAvx2  (TapeView chunk) const;
+
+  public:
+
+    // best engine supported by the CPU, i.e., avx2, ssse3 or scalar
+    static Engine bestEngine();
+    static const char *nameOf(Engine e);
+
+    // requires at most maxStates states (plus one dead state for
+    //   undefined transitions), length_error otherwise, the engine is
+    //   the best one for the number of states not above preferred
+    explicit ShuffleDFA(const CompiledDFA &cDfa, Engine preferred = bestEngine());
+
+    ShuffleDFA(const ShuffleDFA  &sDfa) = default;
+    ShuffleDFA(      ShuffleDFA &&sDfa) = default;
+
+    ~ShuffleDFA() = default;
+
+    int    nrOfStates() const { return nStates; }
+    Engine engine()     const { return eng; }
+
+    StateId startState()        const { return start; }
+    bool    isFinal(StateId s)  const { return (finalBits >> s) & 1; }
+
+    TransitionMap identityMap() const;
+    TransitionMap mapOf(TapeView chunk) const;
+    static TransitionMap composedOf(const TransitionMap &first,
+                                    const TransitionMap &second);
+
+    bool accepts(TapeView tape) const;
+    bool acceptsParallel(TapeView tape, int nThreads) const;
+
+}; // ShuffleDFA
+
+
+#endif
+
+// end of ShuffleDFA.h
+//======================================================================
@@ -0,0 +1,258 @@
+// TaggedDFA.cpp:                                                  2024
+// -------------
+// Tagged DFAs (TDFA) with register operations on their transitions for
+// submatch extraction in one pass, and the Submatcher on top of them.
+//======================================================================
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "Hashing.h"
+#include "TapeStuff.h"
+#include "Regex.h"
+#include "TaggedNFA.h"
+#include "TaggedDFA.h"
+
+
+namespace {
+
+  typedef TaggedNFA::StateId   NState;
+  typedef TaggedNFA::SymbolSet SymbolSet;
+  typedef TaggedNFA::Edge      Edge;
+
+  // register values of threads: unset, set in this step or an id
+  constexpr int32_t noReg = -1, newReg = -2;
+
+  struct ItemsHash {
+    size_t operator()(const vector<int32_t> &v) const {
+      return (size_t)fnv1a64(v.data(), v.size() * sizeof(v[0]));
+    } // operator()
+  }; // ItemsHash
+
+  // threads as items (NFA state, nTags register values), added as in
+  //   the Pike VM: states reachable by epsilon transitions in the order
+  //   of their priority, tags on the way get newReg
+  class ThreadAdder final {
+
+      struct Frame {
+        NState  state;       // < 0: restore of regs[tag]
+        int     tag;
+        int32_t value;
+      }; // Frame
+
+      const TaggedNFA &tNfa;
+      vector<bool>    holdsThread;
+      vector<int>     mark;
+      int             stamp = 0;
+      vector<Frame>   stack;
+      vector<int32_t> regs;
+
+    public:
+
+      explicit ThreadAdder(const TaggedNFA &tNfa)
+      : tNfa(tNfa), holdsThread(tNfa.nrOfStates(), false),
+        mark(tNfa.nrOfStates(), 0), regs(tNfa.nrOfTags()) {
+        for (NState s = 0; s < tNfa.nrOfStates(); s++) {
+          const auto es = tNfa.edgesOf(s);
+          holdsThread[s] = any_of(es.first, es.second,
+                                  [](const Edge &e) { return e.label.any(); });
+        } // for
+        holdsThread[tNfa.finalState()] = true;
+      } // ThreadAdder
+
+      void nextStep() { stamp++; }
+
+      void add(NState s, const int32_t *itemRegs, vector<int32_t> &items) {
+        copy_n(itemRegs, regs.size(), regs.begin());
+        stack.push_back({s, TaggedNFA::noTag, 0});
+        while (!stack.empty()) {
+          const Frame f = stack.back();
+          stack.pop_back();
+          if (f.state < 0) {
+            regs[f.tag] = f.value;
+            continue;
+          } // if
+          if (mark[f.state] == stamp)
+            continue;
+          mark[f.state] = stamp;
+          if (f.tag != TaggedNFA::noTag) {
+            stack.push_back({-1, f.tag, regs[f.tag]});
+            regs[f.tag] = newReg;
+          } // if
+          if (holdsThread[f.state]) {
+            items.push_back(f.state);
+            items.insert(items.end(), regs.begin(), regs.end());
+          } // if
+          const auto es = tNfa.edgesOf(f.state);
+          for (const Edge *e = es.second; e != es.first; ) {
+            --e;
+            if (e->label.none())
+              stack.push_back({e->dest, e->tag, 0});
+          } // for
+        } // while
+      } // add
+
+  }; // ThreadAdder
+
+} // namespace
+
+
+TaggedDFA::TaggedDFA(const TaggedNFA &tNfa)
+: nTags(tNfa.nrOfTags()), nClasses(0), nRegs(0) {
+  const int itemSize = 1 + nTags;
+
+  // 1. classes: symbols contained in the same labels
+  vector<SymbolSet> labels;
+  for (NState s = 0; s < tNfa.nrOfStates(); s++) {
+    const auto es = tNfa.edgesOf(s);
+    for (const Edge *e = es.first; e != es.second; e++)
+      if (e->label.any() && find(labels.begin(), labels.end(), e->label) == labels.end())
+        labels.push_back(e->label);
+  } // for
+  unordered_map<string, int> classOf;
+  vector<unsigned char> repr;    // a symbol of each class
+  for (int b = 0; b < 256; b++) {
+    string signature(labels.size(), '0');
+    for (size_t l = 0; l < labels.size(); l++)
+      if (labels[l][b])
+        signature[l] = '1';
+    const auto it = classOf.emplace(signature, nClasses);
+    if (it.second) {
+      nClasses++;
+      repr.push_back((unsigned char)b);
+    } // if
+    cls[b] = (unsigned char)it.first->second;
+  } // for
+
+  // 2. subset construction on items with registers renumbered per state
+  //    by their first use, sources[j] is the tag and the former value
+  //    of register j of the new state
+  unordered_map<vector<int32_t>, StateId, ItemsHash> ids;
+  vector<vector<int32_t>> states;
+  vector<pair<int, int32_t>> sources;
+  vector<int32_t> key;
+  auto stateOf = [&](const vector<int32_t> &items, vector<Op> &opsOut) -> StateId {
+    key = items;
+    sources.clear();
+    for (size_t i = 0; i < key.size(); i += itemSize)
+      for (int t = 0; t < nTags; t++) {
+        int32_t &r = key[i + 1 + t];
+        if (r == noReg)
+          continue;
+        const pair<int, int32_t> src(t, r);
+        const auto it = find(sources.begin(), sources.end(), src);
+        r = (int32_t)(it - sources.begin());
+        if (it == sources.end())
+          sources.push_back(src);
+      } // for
+    const auto it = ids.emplace(key, (StateId)states.size());
+    const StateId d = it.first->second;
+    if (it.second) {
+      if ((int)states.size() == maxStates)
+        throw length_error("TaggedDFA: more than " + to_string(maxStates) + " states");
+      states.push_back(key);
+      nRegs = max(nRegs, (int)sources.size());
+      bool isFinal = false;
+      for (size_t i = 0; i < key.size() && !isFinal; i += itemSize)
+        if (key[i] == tNfa.finalState()) {
+          isFinal = true;
+          for (int t = 0; t < nTags; t++)
+            finalRegs.push_back(key[i + 1 + t] == noReg ? -1 : key[i + 1 + t]);
+        } // if
+      if (!isFinal)
+        finalRegs.insert(finalRegs.end(), nTags, -1);
+      finals.push_back(isFinal);
+    } // if
+    for (size_t j = 0; j < sources.size(); j++) {
+      const int32_t dest = (int32_t)j,
+                    src  = sources[j].second == newReg ? -1 : sources[j].second;
+      if (dest != src)
+        opsOut.push_back({dest, src});
+    } // for
+    return d;
+  }; // stateOf
+
+  ThreadAdder adder(tNfa);
+  vector<int32_t> items;
+  const vector<int32_t> unset(nTags, noReg);
+  adder.nextStep();
+  adder.add(tNfa.startState(), unset.data(), items);
+  stateOf(items, initialOps);
+  opStart.push_back(0);
+  for (size_t s = 0; s < states.size(); s++)
+    for (int c = 0; c < nClasses; c++) {
+      adder.nextStep();
+      items.clear();
+      for (size_t i = 0; i < states[s].size(); i += itemSize) {
+        const auto es = tNfa.edgesOf(states[s][i]);
+        for (const Edge *e = es.first; e != es.second; e++)
+          if (e->label[repr[c]])
+            adder.add(e->dest, states[s].data() + i + 1, items);
+      } // for
+      table.push_back(items.empty() ? dead : stateOf(items, ops));
+      opStart.push_back((uint32_t)ops.size());
+    } // for
+} // TaggedDFA::TaggedDFA
+
+
+// parallel assignment, as a self loop may read registers it writes
+void TaggedDFA::apply(const Op *first, const Op *last, size_t pos,
+                      vector<size_t> &regs, vector<size_t> &tmp) {
+  tmp.clear();
+  for (const Op *op = first; op != last; op++)
+    tmp.push_back(op->src < 0 ? pos : regs[op->src]);
+  for (const Op *op = first; op != last; op++)
+    regs[op->dest] = tmp[op - first];
+} // TaggedDFA::apply
+
+bool TaggedDFA::match(TapeView tape, vector<Submatch> &groups) const {
+  vector<size_t> regs(nRegs), tmp;
+  tmp.reserve(nRegs);
+  apply(initialOps.data(), initialOps.data() + initialOps.size(), 0, regs, tmp);
+  StateId s = 0;
+  for (size_t i = 0; i < tape.size(); i++) {
+    const size_t entry = (size_t)s * nClasses + cls[(unsigned char)tape[i]];
+    if ((s = table[entry]) == dead)
+      return false;
+    apply(ops.data() + opStart[entry], ops.data() + opStart[entry + 1], i + 1, regs, tmp);
+  } // for
+  if (!finals[s])
+    return false;
+  const int nGroups = nTags / 2;
+  groups.assign(nGroups + 1, {TaggedNFA::npos, TaggedNFA::npos});
+  groups[0] = {0, tape.size()};
+  for (int g = 1; g <= nGroups; g++) {
+    const int32_t rs = finalRegs[(size_t)s * nTags + 2 * (g - 1)],
+                  re = finalRegs[(size_t)s * nTags + 2 * (g - 1) + 1];
+    if (rs >= 0 && re >= 0)
+      groups[g] = {regs[rs], regs[re]};
+  } // for
+  return true;
+} // TaggedDFA::match
+
+
+// --- Submatcher ---
+
+Submatcher::Submatcher(const Regex &re)
+: Submatcher(re.taggedOf()) {
+} // Submatcher::Submatcher
+
+Submatcher::Submatcher(const TaggedNFA &tNfa)
+: tNfa(tNfa) {
+  try {
+    tDfa = make_shared<const TaggedDFA>(tNfa);
+  } catch (const length_error &) {
+    // too many states, the Pike VM of tNfa remains
+  } // try
+} // Submatcher::Submatcher
+
+
+// end of TaggedDFA.cpp
+//======================================================================
@@ -0,0 +1,121 @@
+// TaggedDFA.h:                                                    2024
+// -----------
+// TaggedDFA is the deterministic form of a TaggedNFA in the style of
+// Laurikari's tagged DFAs (TDFA): submatches are extracted in a single
+// pass with one transition per symbol and a few register operations:
+// *  a state is the ordered list of the threads of the Pike VM (NFA
+//    state and, per tag, the register holding its value), so the
+//    priorities are those of the Pike VM and so are the submatches,
+// *  in one step all tags set get the same value (the position), so
+//    one new value per tag suffices, registers are numbered per state
+//    in the order of their first use, so lists equal up to a renaming
+//    of registers are the same state,
+// *  only the registers of the current state are live, so all states
+//    share registers 0, 1, ... (as in Laurikari's register allocation,
+//    nrOfRegisters is the maximum of a state), a transition copies the
+//    ones of its source or sets them to the position (parallel
+//    assignment, copies to the same register are left out), final
+//    states know the registers of the thread of highest priority,
+// *  as subset construction, it may need many states: above maxStates
+//    the constructor throws length_error.
+// Submatcher takes the TaggedDFA if there is one and the Pike VM of
+// the TaggedNFA otherwise, both in one pass without backtracking.
+//======================================================================
+
+#pragma once
+#ifndef TaggedDFA_h
+#define TaggedDFA_h
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "TaggedNFA.h"
+
+class Regex;
+
+
+class TaggedDFA final
+        /*OC+*/ : private ObjectCounter<TaggedDFA> /*+OC*/ {
+
+  public:
+
+    typedef std::int32_t StateId;
+    static constexpr StateId dead = -1;
+
+    typedef TaggedNFA::Submatch Submatch;
+
+    struct Op {                             // regs[dest] = regs[src] or
+      std::int32_t dest, src;               //   the position for src < 0
+    }; // Op
+
+  private:
+
+    int nTags, nClasses, nRegs;
+    unsigned char              cls[256];    // symbol -> class
+    std::vector<StateId>       table;       // nStates x nClasses
+    std::vector<std::uint32_t> opStart;     // CSR per entry of table ...
+    std::vector<Op>            ops;         // ... register operations
+    std::vector<Op>            initialOps;  // at position 0
+    std::vector<bool>          finals;
+    std::vector<std::int32_t>  finalRegs;   // nTags per state, -1 unset
+
+    static void apply(const Op *first, const Op *last, std::size_t pos,
+                      std::vector<std::size_t> &regs, std::vector<std::size_t> &tmp);
+
+  public:
+
+    static constexpr int maxStates = 10000;
+
+    explicit TaggedDFA(const TaggedNFA &tNfa);
+
+    TaggedDFA(const TaggedDFA  &tDfa) = default;
+    TaggedDFA(      TaggedDFA &&tDfa) = default;
+
+    ~TaggedDFA() = default;
+
+    int         nrOfStates()    const { return (int)finals.size(); }
+    int         nrOfClasses()   const { return nClasses; }
+    int         nrOfRegisters() const { return nRegs; }
+    std::size_t nrOfOps()       const { return ops.size(); }
+
+    // as TaggedNFA::match, with the same submatches
+    bool match(TapeView tape, std::vector<Submatch> &groups) const;
+
+}; // TaggedDFA
+
+
+class Submatcher final
+        /*OC+*/ : private ObjectCounter<Submatcher> /*+OC*/ {
+
+    TaggedNFA tNfa;
+    std::shared_ptr<const TaggedDFA> tDfa;  // nullptr: Pike VM
+
+  public:
+
+    explicit Submatcher(const Regex &re);
+    explicit Submatcher(const TaggedNFA &tNfa);
+
+    Submatcher(const Submatcher  &sm) = default;
+    Submatcher(      Submatcher &&sm) = default;
+
+    ~Submatcher() = default;
+
+    bool             hasDfa()     const { return tDfa != nullptr; }
+    const TaggedNFA &taggedNfa()  const { return tNfa; }
+    int              nrOfGroups() const { return tNfa.nrOfGroups(); }
+
+    bool match(TapeView tape, std::vector<TaggedNFA::Submatch> &groups) const {
+      return tDfa != nullptr ? tDfa->match(tape, groups) : tNfa.match(tape, groups);
+    } // match
+
+}; // Submatcher
+
+
+#endif
+
+// end of TaggedDFA.h
+//======================================================================
@@ -0,0 +1,136 @@
+// TaggedNFA.cpp:                                                  2024
+// -------------
+// NFA with tagged epsilon transitions in priority order and its Pike VM
+// for the extraction of submatches in one pass.
+//======================================================================
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "TaggedNFA.h"
+
+
+TaggedNFA::TaggedNFA(int nStates, int nTags, StateId start, StateId final,
+                     vector<Edge> edges)
+: nStates(nStates), nTags(nTags), start(start), final(final),
+  edgeStart(nStates + 1, 0), edges(std::move(edges)) {
+  if (start < 0 || start >= nStates || final < 0 || final >= nStates)
+    throw invalid_argument("TaggedNFA: start or final state out of range");
+  stable_sort(this->edges.begin(), this->edges.end(),   // keeps priorities
+              [](const Edge &e1, const Edge &e2) { return e1.src < e2.src; });
+  for (const Edge &e: this->edges) {
+    if (e.src < 0 || e.src >= nStates || e.dest < 0 || e.dest >= nStates ||
+        e.tag < noTag || e.tag >= nTags || (e.tag != noTag && e.label.any()))
+      throw invalid_argument("TaggedNFA: invalid edge");
+    edgeStart[e.src + 1]++;
+  } // for
+  for (int s = 0; s < nStates; s++)
+    edgeStart[s + 1] += edgeStart[s];
+} // TaggedNFA::TaggedNFA
+
+
+namespace {
+
+  typedef TaggedNFA::StateId StateId;
+
+  // threads in the order of their priority, nTags captures each
+  struct Threads {
+    vector<StateId>     states;
+    vector<std::size_t> caps;
+  }; // Threads
+
+  // state to enter with tag, or (state < 0) restore of caps[tag]
+  struct Frame {
+    StateId     state;
+    int         tag;
+    std::size_t value;
+  }; // Frame
+
+} // namespace
+
+
+bool TaggedNFA::match(TapeView tape, vector<Submatch> &groups) const {
+
+  // states in thread lists: with symbol transitions or final
+  vector<bool> holdsThread(nStates, false);
+  for (const Edge &e: edges)
+    if (e.label.any())
+      holdsThread[e.src] = true;
+  holdsThread[final] = true;
+
+  vector<size_t> mark(nStates, npos);   // position of the last visit
+  vector<size_t> caps(nTags, npos);
+  vector<Frame>  stack;
+
+  // s and all states reachable by epsilon transitions in the order of
+  //   their priority, tags record pos in caps while they are explored
+  auto addThread = [&](Threads &list, StateId s, size_t pos) {
+    stack.push_back({s, noTag, 0});
+    while (!stack.empty()) {
+      const Frame f = stack.back();
+      stack.pop_back();
+      if (f.state < 0) {
+        caps[f.tag] = f.value;
+        continue;
+      } // if
+      if (mark[f.state] == pos)          // by a thread of higher priority
+        continue;
+      mark[f.state] = pos;
+      if (f.tag != noTag) {
+        stack.push_back({-1, f.tag, caps[f.tag]});
+        caps[f.tag] = pos;
+      } // if
+      if (holdsThread[f.state]) {
+        list.states.push_back(f.state);
+        list.caps.insert(list.caps.end(), caps.begin(), caps.end());
+      } // if
+      const auto es = edgesOf(f.state);
+      for (const Edge *e = es.second; e != es.first; ) {
+        --e;                             // first edge on top
+        if (e->label.none())
+          stack.push_back({e->dest, e->tag, 0});
+      } // for
+    } // while
+  }; // addThread
+
+  Threads current, next;
+  addThread(current, start, 0);
+  for (size_t i = 0; i < tape.size() && !current.states.empty(); i++) {
+    const unsigned char b = (unsigned char)tape[i];
+    next.states.clear();
+    next.caps.clear();
+    for (size_t t = 0; t < current.states.size(); t++) {
+      const auto es = edgesOf(current.states[t]);
+      for (const Edge *e = es.first; e != es.second; e++)
+        if (e->label[b]) {
+          copy_n(current.caps.begin() + t * nTags, nTags, caps.begin());
+          addThread(next, e->dest, i + 1);
+        } // if
+    } // for
+    swap(current, next);
+  } // for
+
+  // the thread of highest priority in the final state
+  for (size_t t = 0; t < current.states.size(); t++)
+    if (current.states[t] == final) {
+      groups.assign(nrOfGroups() + 1, {npos, npos});
+      groups[0] = {0, tape.size()};
+      for (int g = 1; g <= nrOfGroups(); g++) {
+        const size_t s = current.caps[t * nTags + 2 * (g - 1)],
+                     e = current.caps[t * nTags + 2 * (g - 1) + 1];
+        if (s != npos && e != npos)
+          groups[g] = {s, e};
+      } // for
+      return true;
+    } // if
+  return false;
+} // TaggedNFA::match
+
+
+// end of TaggedNFA.cpp
+//======================================================================
@@ -0,0 +1,97 @@
+// TaggedNFA.h:                                                    2024
+// -----------
+// TaggedNFA is an NFA on integer state ids whose epsilon transitions
+// may carry tags, which record the current position when taken, so
+// the offsets of capture groups of a Regex (cf. Regex::taggedOf) can be
+// extracted from a match:
+// *  the edges of each state are kept in the order of their priority,
+//    so of all paths for a tape the first in this order wins (leftmost
+//    alternative, greedy repetition, as in Perl),
+// *  tag 2 (g - 1) opens and tag 2 (g - 1) + 1 closes group g, the
+//    submatch of a group repeated is the one of its last iteration,
+// *  match is a Pike VM: all threads advance in one pass over the
+//    tape, ordered by priority, with one capture vector each; a thread
+//    reaching a state already reached by a thread of higher priority
+//    dies, so the cost is O(|tape| * |edges| * nrOfTags()) and there is
+//    no backtracking at all.
+// A match is a match of the whole tape, for matches in longer texts
+// the Searcher provides [start, end) first.
+//======================================================================
+
+#pragma once
+#ifndef TaggedNFA_h
+#define TaggedNFA_h
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ObjectCounter.h"
+#include "TapeStuff.h"
+#include "CompiledNFA.h"
+
+
+class TaggedNFA final
+        /*OC+*/ : private ObjectCounter<TaggedNFA> /*+OC*/ {
+
+  public:
+
+    typedef CompiledNFA::StateId   StateId;
+    typedef CompiledNFA::SymbolSet SymbolSet;
+
+    static constexpr int noTag = -1;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // transition on each symbol of label, epsilon transition (with tag
+    //   or noTag) for an empty label
+    struct Edge {
+      StateId   src;
+      SymbolSet label;
+      int       tag;
+      StateId   dest;
+    }; // Edge
+
+    struct Submatch {
+      std::size_t start, end;         // [start, end), npos if not matched
+    }; // Submatch
+
+  private:
+
+    int     nStates, nTags;
+    StateId start, final;
+    std::vector<std::uint32_t> edgeStart; // CSR of the edges by src, ...
+    std::vector<Edge>          edges;     // ... in the order given
+
+  public:
+
+    // edges of each state in the order of their priority
+    TaggedNFA(int nStates, int nTags, StateId start, StateId final,
+              std::vector<Edge> edges);
+
+    TaggedNFA(const TaggedNFA  &tNfa) = default;
+    TaggedNFA(      TaggedNFA &&tNfa) = default;
+
+    ~TaggedNFA() = default;
+
+    int nrOfStates() const { return nStates; }
+    int nrOfTags()   const { return nTags;   }
+    int nrOfGroups() const { return nTags / 2; }
+
+    StateId startState() const { return start; }
+    StateId finalState() const { return final; }
+
+    std::pair<const Edge *, const Edge *> edgesOf(StateId s) const {
+      return {edges.data() + edgeStart[s], edges.data() + edgeStart[s + 1]};
+    } // edgesOf
+
+    // groups[0] is the whole tape, groups[g] the submatch of group g
+    bool match(TapeView tape, std::vector<Submatch> &groups) const;
+
+}; // TaggedNFA
+
+
+#endif
+
+// end of TaggedNFA.h
+//======================================================================
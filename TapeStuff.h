@@ -1,8 +1,20 @@
 // TapeStuff.h:                                           HDO, 2006-2019
 // ------------
 // Tape       is an alias for std::string, a sequences of TapeSymbols.
+// TapeView   is an alias for std::string_view, a length-delimited tape
+//            (pointer + size), so all 256 byte values may occur on it.
 // TapeSymbol is an alias for char, a symbol on the tape of an automaton.
 // TapeSymbolSet represents a set of TapeSymbols.
+// The map-based automata (FA, DFA, NFA and FABuilder) are the text path:
+// they use eot and eps in-band, so their symbols exclude '\0' and '\01'
+// and their accepts stops at the first eot; convert them to CompiledDFA
+// or CompiledNFA for TapeViews.
+// The integer-based ones (CompiledDFA, CompiledNFA, LazyDFA, RangeDFA,
+// Regex and FragmentArena) accept TapeViews on all 256 byte values and
+// keep epsilon out of the symbol space. Their class ids are bytes and
+// class 0 is for the symbols without any transition, so an automaton
+// may have at most 255 classes of symbols with transitions: CompiledNFA
+// throws length_error if all 256 byte values behave differently.
 //======================================================================
 
 #pragma once
@@ -13,12 +25,14 @@
 #include <iosfwd>
 #include <set>
 #include <string>
+#include <string_view>
 
 #include "ObjectCounter.h"
 
 
-typedef std::string Tape;
-typedef char        TapeSymbol;   // but printable chars only
+typedef std::string      Tape;
+typedef std::string_view TapeView; // length-delimited, any byte values
+typedef char             TapeSymbol; // printable chars only for map-based FAs
 
 constexpr TapeSymbol eot = '\0';  // end of tape symbol (used as sentinel on tape)
 constexpr TapeSymbol eps = '\01'; // used for epsilon as greek e not in font
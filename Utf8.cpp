@@ -0,0 +1,177 @@
+// Utf8.cpp:                                                       2024
+// --------
+// UTF-8 support for automata on Unicode code points: byte range
+// sequences, translation of RangeNFAs to bytes, encoding and decoding.
+//======================================================================
+
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "TapeStuff.h"
+#include "RangeDelta.h"
+#include "Utf8.h"
+
+
+namespace {
+
+  constexpr WideSymbol maxOfLength[] = {0x7F, 0x7FF, 0xFFFF}; // 1, 2, 3 bytes
+  constexpr WideSymbol surrogateLo = 0xD800, surrogateHi = 0xDFFF;
+
+  int encode(WideSymbol cp, unsigned char b[4]) {
+    if (cp <= 0x7F) {
+      b[0] = (unsigned char)cp;
+      return 1;
+    } else if (cp <= 0x7FF) {
+      b[0] = (unsigned char)(0xC0 | (cp >> 6));
+      b[1] = (unsigned char)(0x80 | (cp & 0x3F));
+      return 2;
+    } else if (cp <= 0xFFFF) {
+      b[0] = (unsigned char)(0xE0 | (cp >> 12));
+      b[1] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+      b[2] = (unsigned char)(0x80 | (cp & 0x3F));
+      return 3;
+    } // if
+    b[0] = (unsigned char)(0xF0 | (cp >> 18));
+    b[1] = (unsigned char)(0x80 | ((cp >> 12) & 0x3F));
+    b[2] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+    b[3] = (unsigned char)(0x80 | (cp & 0x3F));
+    return 4;
+  } // encode
+
+} // namespace
+
+
+// splits [lo, hi] until lo and hi have the same length and differ in
+//   whole trailing continuation bytes only (all 0x80 .. 0xBF), then the
+//   bytes of lo and hi bound the byte ranges
+vector<Utf8Sequence> utf8SequencesOf(WideSymbol lo, WideSymbol hi) {
+  vector<Utf8Sequence> seqs;
+  if (hi > maxCodePoint)
+    hi = maxCodePoint;
+  vector<pair<WideSymbol, WideSymbol>> stack; // top is the lowest range
+  if (lo <= hi)
+    stack.emplace_back(lo, hi);
+  while (!stack.empty()) {
+    tie(lo, hi) = stack.back();
+    stack.pop_back();
+    auto split = [&stack](WideSymbol l, WideSymbol m, WideSymbol h) {
+      stack.emplace_back(m + 1, h);  // [l, m] first
+      stack.emplace_back(l, m);
+    }; // split
+    if (lo <= surrogateHi && hi >= surrogateLo) { // drop surrogates
+      if (hi > surrogateHi)
+        stack.emplace_back(surrogateHi + 1, hi);
+      if (lo < surrogateLo)
+        stack.emplace_back(lo, surrogateLo - 1);
+      continue;
+    } // if
+    bool isSplit = false;
+    for (WideSymbol max: maxOfLength)
+      if (lo <= max && max < hi) {
+        split(lo, max, hi);
+        isSplit = true;
+        break;
+      } // if
+    for (int i = 1; i <= 3 && !isSplit; i++) {
+      const WideSymbol m = (1u << (6 * i)) - 1;  // i continuation bytes
+      if ((lo & ~m) != (hi & ~m)) {
+        if ((lo & m) != 0) {
+          split(lo, lo | m, hi);
+          isSplit = true;
+        } else if ((hi & m) != m) {
+          split(lo, (hi & ~m) - 1, hi);
+          isSplit = true;
+        } // if
+      } // if
+    } // for
+    if (isSplit)
+      continue;
+    unsigned char bl[4], bh[4];
+    Utf8Sequence seq;
+    seq.length = encode(lo, bl);
+    encode(hi, bh);
+    for (int k = 0; k < seq.length; k++)
+      seq.bytes[k] = {bl[k], bh[k]};
+    seqs.push_back(seq);
+  } // while
+  return seqs;
+} // utf8SequencesOf
+
+
+// chains are built from their ends: (state, byte range) -> predecessor
+//   in the cache, so all chains into one state share their suffixes
+RangeNFA utf8Of(const RangeNFA &cpNfa) {
+  RangeNFA bNfa(cpNfa.nrOfStates());
+  bNfa.setStartState(cpNfa.startState());
+  map<tuple<RangeNFA::StateId, WideSymbol, WideSymbol>, RangeNFA::StateId> suffixes;
+  for (RangeNFA::StateId s = 0; s < cpNfa.nrOfStates(); s++) {
+    if (cpNfa.isFinal(s))
+      bNfa.addFinalState(s);
+    for (RangeNFA::StateId d: cpNfa.epsDestsOf(s))
+      bNfa.addEpsTransition(s, d);
+    for (const RangeNFA::Transition &t: cpNfa.transitionsOf(s))
+      for (const Utf8Sequence &seq: utf8SequencesOf(t.range.lo, t.range.hi)) {
+        RangeNFA::StateId d = t.dest;
+        for (int k = seq.length - 1; k > 0; k--) {
+          auto ir = suffixes.emplace(make_tuple(d, seq.bytes[k].lo, seq.bytes[k].hi), -1);
+          if (ir.second) {
+            ir.first->second = bNfa.addState();
+            bNfa.addTransition(ir.first->second, seq.bytes[k].lo, seq.bytes[k].hi, d);
+          } // if
+          d = ir.first->second;
+        } // for
+        bNfa.addTransition(s, seq.bytes[0].lo, seq.bytes[0].hi, d);
+      } // for
+  } // for
+  return bNfa;
+} // utf8Of
+
+
+void appendUtf8(Tape &tape, WideSymbol cp) {
+  if (cp > maxCodePoint || (cp >= surrogateLo && cp <= surrogateHi))
+    throw invalid_argument("no Unicode scalar value");
+  unsigned char b[4];
+  tape.append((const char *)b, encode(cp, b));
+} // appendUtf8
+
+
+bool codePointsOf(TapeView tape, vector<WideSymbol> &cps) {
+  cps.clear();
+  const unsigned char *p   = (const unsigned char *)tape.data(),
+                      *end = p + tape.size();
+  while (p != end) {
+    const unsigned char b = *p++;
+    if (b < 0x80) {
+      cps.push_back(b);
+      continue;
+    } // if
+    int n;                   // nr. of continuation bytes
+    WideSymbol cp;
+    if      (b >= 0xC2 && b <= 0xDF) { n = 1; cp = b & 0x1F; }
+    else if (b >= 0xE0 && b <= 0xEF) { n = 2; cp = b & 0x0F; }
+    else if (b >= 0xF0 && b <= 0xF4) { n = 3; cp = b & 0x07; }
+    else
+      return false;          // continuation byte or C0, C1, F5 .. FF
+    if (end - p < n)
+      return false;
+    for (int k = 0; k < n; k++, p++) {
+      if ((*p & 0xC0) != 0x80)
+        return false;
+      cp = (cp << 6) | (*p & 0x3F);
+    } // for
+    if (cp <= maxOfLength[n - 1] || cp > maxCodePoint ||   // overlong
+        (cp >= surrogateLo && cp <= surrogateHi))
+      return false;
+    cps.push_back(cp);
+  } // while
+  return true;
+} // codePointsOf
+
+
+// end of Utf8.cpp
+//======================================================================
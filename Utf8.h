@@ -0,0 +1,46 @@
+// Utf8.h:                                                         2024
+// ------
+// UTF-8 support for automata on Unicode code points:
+// *  utf8SequencesOf splits a range of code points into sequences of
+//    byte ranges (1 to 4 bytes each), so that the UTF-8 encodings of
+//    the range are exactly the tapes of these sequences (as in RE2 and
+//    Rust's regex), surrogates and code points > 0x10FFFF are dropped,
+// *  utf8Of translates a RangeNFA on code points into a RangeNFA on
+//    bytes, each transition becomes chains of byte range transitions
+//    and chains to the same destination share their suffixes, so the
+//    (minimal) DFA of the result consumes one byte at a time,
+// *  appendUtf8 and codePointsOf encode and decode (strictly) UTF-8.
+//======================================================================
+
+#pragma once
+#ifndef Utf8_h
+#define Utf8_h
+
+#include <vector>
+
+#include "TapeStuff.h"
+#include "RangeDelta.h"
+
+
+constexpr WideSymbol maxCodePoint = 0x10FFFF;
+
+struct Utf8Sequence {
+  int         length;             // 1 .. 4
+  SymbolRange bytes[4];           // ranges of the bytes 0 .. length - 1
+}; // Utf8Sequence
+
+// sequences in ascending order of code points
+std::vector<Utf8Sequence> utf8SequencesOf(WideSymbol lo, WideSymbol hi);
+
+RangeNFA utf8Of(const RangeNFA &codePointNfa);
+
+void appendUtf8(Tape &tape, WideSymbol cp); // requires a valid code point
+
+// false for invalid UTF-8 (overlong forms, surrogates, truncation, ...)
+bool codePointsOf(TapeView tape, std::vector<WideSymbol> &cps);
+
+
+#endif
+
+// end of Utf8.h
+//======================================================================